@@ -0,0 +1,711 @@
+/**
+ * @file itkScanConvertBenchmark.cxx
+ * @brief Throughput of the (R, Theta) transforms and of the scan conversion
+ * filter on synthetic inputs.
+ *
+ * Every input is generated in memory, so the benchmark runs without the
+ * VisualSonics test data.  Each case is repeated until --min-time seconds
+ * have elapsed, and the mean time per repetition is reported as Mpixels/s and
+ * cycles/pixel.  cycles/pixel is the number of time stamp counter cycles of
+ * wall time per output pixel multiplied by the number of threads, i.e. the
+ * processor time spent on each pixel; it stays constant when the filter
+ * scales perfectly.
+ *
+ * Usage:
+ *   itkScanConvertBenchmark [--format=console|csv|json] [--out=<file>]
+ *     [--filter=<substring>] [--min-time=<seconds>] [--threads=<n>[,<n>...]]
+ *     [--cpu-frequency=<GHz>]
+ *
+ * --filter keeps the cases whose name contains the substring, e.g.
+ * --filter=Filter/short/3D.  --cpu-frequency converts time to cycles on
+ * processors without a time stamp counter.
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined( _MSC_VER ) && ( defined( _M_IX86 ) || defined( _M_X64 ) )
+#include <intrin.h>
+#define SCAN_CONVERT_BENCHMARK_HAVE_TSC
+#elif defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+#include <x86intrin.h>
+#define SCAN_CONVERT_BENCHMARK_HAVE_TSC
+#endif
+
+#include "itkArray.h"
+#include "itkImage.h"
+#include "itkMetaDataObject.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include "itkRealTimeClock.h"
+
+#include "itkCartesianToRThetaTransform.h"
+#include "itkRThetaToCartesianTransform.h"
+#include "itkResampleRThetaToCartesianImageFilter.h"
+
+namespace
+{
+
+/** Command line options. */
+struct BenchmarkOptions
+{
+  std::string        Format;
+  std::string        OutputFileName;
+  std::string        Filter;
+  double             MinimumTime;
+  double             CPUFrequency;
+  std::vector< int > Threads;
+};
+
+/** One row of the report. */
+struct BenchmarkResult
+{
+  std::string   Name;
+  std::string   Operation;
+  std::string   PixelType;
+  unsigned int  Dimension;
+  unsigned int  Threads;
+  std::string   InputSize;
+  unsigned long PixelsPerIteration;
+  unsigned long Iterations;
+  double        Seconds;
+  double        Cycles;
+  bool          HaveCycles;
+};
+
+/** Geometry of a synthetic acquisition.  The sizes are given in the R,
+ * Theta, elevation order. */
+struct AcquisitionGeometry
+{
+  unsigned long Size[3];
+};
+
+const double SyntheticRmin         = 0.004;
+const double SyntheticRSpacing     = 1.5e-5;
+const double SyntheticSectorWidth  = 0.5;
+const double SyntheticElevationSpacing = 3.0e-4;
+
+/** Results of the transforms are accumulated here so that the work cannot be
+ * optimized away. */
+volatile double BenchmarkSink = 0.0;
+
+inline unsigned long long ReadCycleCounter()
+{
+#ifdef SCAN_CONVERT_BENCHMARK_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+/** Theta array of a sector that is uniformly sampled with lines lines. */
+itk::Array< double > SyntheticThetaArray( unsigned long lines )
+{
+  itk::Array< double > theta( lines );
+  for( unsigned long i = 0; i < lines; i++ )
+    {
+    theta[i] = SyntheticSectorWidth * ( static_cast< double >( i ) / ( lines - 1 ) - 0.5 );
+    }
+  return theta;
+}
+
+/** Fill an (R, Theta) image with a deterministic speckle-like pattern and the
+ * MetaDataDictionary entries the filter reads. */
+template < class TImage >
+typename TImage::Pointer
+SyntheticRThetaImage( const AcquisitionGeometry & geometry )
+{
+  typedef typename TImage::PixelType PixelType;
+  const unsigned int Dimension = TImage::ImageDimension;
+
+  typename TImage::Pointer image = TImage::New();
+  typename TImage::SizeType size;
+  typename TImage::SpacingType spacing;
+  for( unsigned int d = 0; d < Dimension; d++ )
+    {
+    size[d] = geometry.Size[d];
+    spacing[d] = SyntheticElevationSpacing;
+    }
+  spacing[0] = SyntheticRSpacing;
+  spacing[1] = SyntheticSectorWidth / ( geometry.Size[1] - 1 );
+  image->SetRegions( size );
+  image->SetSpacing( spacing );
+  image->Allocate();
+
+  const double maximum = static_cast< double >( itk::NumericTraits< PixelType >::max() );
+  const double range = vnl_math_min( maximum, 4095.0 );
+  PixelType * buffer = image->GetBufferPointer();
+  const unsigned long pixels = image->GetBufferedRegion().GetNumberOfPixels();
+  unsigned long state = 12345;
+  for( unsigned long i = 0; i < pixels; i++ )
+    {
+    state = state * 1103515245UL + 12345UL;
+    buffer[i] = static_cast< PixelType >( range * ( ( state >> 16 ) & 0x7fff ) / 32767.0 );
+    }
+
+  itk::MetaDataDictionary & dict = image->GetMetaDataDictionary();
+  itk::EncapsulateMetaData< double >( dict, "Radius", SyntheticRmin );
+  itk::EncapsulateMetaData< itk::Array< double > >( dict, "Theta",
+    SyntheticThetaArray( geometry.Size[1] ) );
+
+  return image;
+}
+
+/** Repeat benchmarkCase.Run() until the minimum time has elapsed. */
+template < class TCase >
+void
+Measure( TCase & benchmarkCase, const BenchmarkOptions & options, BenchmarkResult & result )
+{
+  itk::RealTimeClock::Pointer clock = itk::RealTimeClock::New();
+
+  // Warm up the caches, the lookup table, and the thread pool.
+  benchmarkCase.Run();
+
+  result.Iterations = 0;
+  const double start = clock->GetTimeStamp();
+  const unsigned long long startCycles = ReadCycleCounter();
+  double elapsed = 0.0;
+  do
+    {
+    benchmarkCase.Run();
+    ++result.Iterations;
+    elapsed = clock->GetTimeStamp() - start;
+    }
+  while( elapsed < options.MinimumTime || result.Iterations < 3 );
+  const unsigned long long stopCycles = ReadCycleCounter();
+
+  result.Seconds = elapsed;
+#ifdef SCAN_CONVERT_BENCHMARK_HAVE_TSC
+  result.Cycles = static_cast< double >( stopCycles - startCycles );
+  result.HaveCycles = true;
+#else
+  (void)startCycles;
+  (void)stopCycles;
+  result.Cycles = elapsed * options.CPUFrequency * 1.0e9;
+  result.HaveCycles = options.CPUFrequency > 0.0;
+#endif
+}
+
+template < class TPixel > struct PixelTypeName;
+template <> struct PixelTypeName< unsigned char > { static const char * Get() { return "uchar"; } };
+template <> struct PixelTypeName< short > { static const char * Get() { return "short"; } };
+template <> struct PixelTypeName< float > { static const char * Get() { return "float"; } };
+template <> struct PixelTypeName< double > { static const char * Get() { return "double"; } };
+
+std::string SizeString( const AcquisitionGeometry & geometry, unsigned int dimension )
+{
+  std::ostringstream oss;
+  for( unsigned int d = 0; d < dimension; d++ )
+    {
+    oss << ( d ? "x" : "" ) << geometry.Size[d];
+    }
+  return oss.str();
+}
+
+/** Transform a grid of Cartesian points that covers the sector with
+ * CartesianToRThetaTransform, one TransformPoint() or one TransformPoints()
+ * call per row. */
+template < class TCoordRep, unsigned int VDimension >
+class CartesianToRThetaTransformCase
+{
+public:
+  typedef itk::CartesianToRThetaTransform< TCoordRep, VDimension > TransformType;
+  typedef typename TransformType::InputPointType                   InputPointType;
+  typedef typename TransformType::OutputPointType                  OutputPointType;
+
+  CartesianToRThetaTransformCase( const AcquisitionGeometry & geometry, bool batch ):
+    m_Batch( batch )
+  {
+    const double rMax = SyntheticRmin + geometry.Size[0] * SyntheticRSpacing;
+    m_Transform = TransformType::New();
+    m_Transform->SetRmin( SyntheticRmin );
+    m_Transform->SetRDirection( 0 );
+    m_Transform->SetThetaDirection( 1 );
+    m_Transform->SetRmax( rMax );
+    m_Transform->SetSpacingTheta( SyntheticSectorWidth / ( geometry.Size[1] - 1 ) );
+    m_Transform->SetThetaArray( SyntheticThetaArray( geometry.Size[1] ) );
+
+    // A grid over the sector's bounding box with about as many points as
+    // there are input samples.
+    const double xMin = m_Transform->GetRmincosMaxAbsTheta();
+    const double yMax = vcl_abs( static_cast< double >( m_Transform->GetRmaxsinThetamin() ) );
+    const double spacing = vcl_sqrt( ( rMax - xMin ) * 2.0 * yMax / ( geometry.Size[0] * geometry.Size[1] ) );
+    m_RowLength = static_cast< unsigned long >( vcl_ceil( ( rMax - xMin ) / spacing ) );
+    const unsigned long rows = static_cast< unsigned long >( vcl_ceil( 2.0 * yMax / spacing ) );
+    m_Points.resize( m_RowLength * rows );
+    for( unsigned long row = 0; row < rows; row++ )
+      {
+      for( unsigned long i = 0; i < m_RowLength; i++ )
+        {
+        InputPointType & point = m_Points[row * m_RowLength + i];
+        point.Fill( 0.0 );
+        point[0] = xMin + i * spacing;
+        point[1] = -yMax + row * spacing;
+        }
+      }
+    m_TransformedPoints.resize( m_RowLength );
+  }
+
+  unsigned long GetNumberOfPoints() const
+    {
+    return m_Points.size();
+    }
+
+  void Run()
+    {
+    const TransformType * transform = m_Transform.GetPointer();
+    double sink = 0.0;
+    for( unsigned long row = 0; row < m_Points.size(); row += m_RowLength )
+      {
+      if( m_Batch )
+        {
+        transform->TransformPoints( &m_Points[row], &m_TransformedPoints[0], m_RowLength );
+        }
+      else
+        {
+        for( unsigned long i = 0; i < m_RowLength; i++ )
+          {
+          m_TransformedPoints[i] = transform->TransformPoint( m_Points[row + i] );
+          }
+        }
+      sink += m_TransformedPoints[m_RowLength / 2][1];
+      }
+    BenchmarkSink += sink;
+    }
+
+private:
+  typename TransformType::Pointer m_Transform;
+  std::vector< InputPointType >   m_Points;
+  std::vector< OutputPointType >  m_TransformedPoints;
+  unsigned long                   m_RowLength;
+  bool                            m_Batch;
+};
+
+/** Transform every (R, Theta) sample of an acquisition with
+ * RThetaToCartesianTransform. */
+template < class TCoordRep, unsigned int VDimension >
+class RThetaToCartesianTransformCase
+{
+public:
+  typedef itk::RThetaToCartesianTransform< TCoordRep, VDimension > TransformType;
+  typedef typename TransformType::InputPointType                   InputPointType;
+
+  RThetaToCartesianTransformCase( const AcquisitionGeometry & geometry )
+  {
+    const double spacingTheta = SyntheticSectorWidth / ( geometry.Size[1] - 1 );
+    m_Transform = TransformType::New();
+    m_Transform->SetRmin( SyntheticRmin );
+    m_Transform->SetRDirection( 0 );
+    m_Transform->SetThetaDirection( 1 );
+    m_Transform->SetRmax( SyntheticRmin + geometry.Size[0] * SyntheticRSpacing );
+    m_Transform->SetSpacingTheta( spacingTheta );
+    m_Transform->SetThetaArray( SyntheticThetaArray( geometry.Size[1] ) );
+
+    m_Points.resize( geometry.Size[0] * geometry.Size[1] );
+    for( unsigned long line = 0; line < geometry.Size[1]; line++ )
+      {
+      for( unsigned long i = 0; i < geometry.Size[0]; i++ )
+        {
+        InputPointType & point = m_Points[line * geometry.Size[0] + i];
+        point.Fill( 0.0 );
+        point[0] = i * SyntheticRSpacing;
+        point[1] = line * spacingTheta;
+        }
+      }
+  }
+
+  unsigned long GetNumberOfPoints() const
+    {
+    return m_Points.size();
+    }
+
+  void Run()
+    {
+    const TransformType * transform = m_Transform.GetPointer();
+    double sink = 0.0;
+    for( unsigned long i = 0; i < m_Points.size(); i++ )
+      {
+      sink += transform->TransformPoint( m_Points[i] )[0];
+      }
+    BenchmarkSink += sink;
+    }
+
+private:
+  typename TransformType::Pointer m_Transform;
+  std::vector< InputPointType >   m_Points;
+};
+
+/** Convert a synthetic acquisition end-to-end with
+ * ResampleRThetaToCartesianImageFilter. */
+template < class TPixel, unsigned int VDimension >
+class ResampleFilterCase
+{
+public:
+  typedef itk::Image< TPixel, VDimension >                             ImageType;
+  typedef itk::ResampleRThetaToCartesianImageFilter< ImageType, ImageType, float > FilterType;
+
+  ResampleFilterCase( const AcquisitionGeometry & geometry, int threads, bool useLookupTable )
+  {
+    m_Input = SyntheticRThetaImage< ImageType >( geometry );
+    m_Filter = FilterType::New();
+    m_Filter->SetInput( m_Input );
+    m_Filter->SetNumberOfThreads( threads );
+    m_Filter->SetUseLookupTable( useLookupTable );
+    m_Filter->SetDefaultPixelValue( 0 );
+    // Square output pixels at the radial sample spacing.
+    m_Filter->SetOutputSpacingTheta( SyntheticRSpacing );
+    m_Filter->UpdateOutputInformation();
+  }
+
+  unsigned long GetNumberOfPixels()
+    {
+    return m_Filter->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels();
+    }
+
+  void Run()
+    {
+    m_Filter->Modified();
+    m_Filter->Update();
+    }
+
+private:
+  typename ImageType::Pointer  m_Input;
+  typename FilterType::Pointer m_Filter;
+};
+
+bool Selected( const BenchmarkOptions & options, const std::string & name )
+{
+  return options.Filter.empty() || name.find( options.Filter ) != std::string::npos;
+}
+
+template < class TCoordRep, unsigned int VDimension >
+void
+BenchmarkTransforms( const BenchmarkOptions & options,
+  const AcquisitionGeometry & geometry,
+  std::vector< BenchmarkResult > & results )
+{
+  BenchmarkResult result;
+  result.PixelType = PixelTypeName< TCoordRep >::Get();
+  result.Dimension = VDimension;
+  result.Threads = 1;
+  result.InputSize = SizeString( geometry, 2 );
+
+  std::ostringstream suffix;
+  suffix << "/" << result.PixelType << "/" << VDimension << "D/input:" << result.InputSize;
+
+  const char * operations[2] = { "TransformPoint", "TransformPoints" };
+  for( unsigned int batch = 0; batch < 2; batch++ )
+    {
+    result.Operation = std::string( "CartesianToRThetaTransform::" ) + operations[batch];
+    result.Name = std::string( "CartesianToRThetaTransform/" ) + operations[batch] + suffix.str();
+    if( Selected( options, result.Name ) )
+      {
+      CartesianToRThetaTransformCase< TCoordRep, VDimension > benchmarkCase( geometry, batch != 0 );
+      result.PixelsPerIteration = benchmarkCase.GetNumberOfPoints();
+      Measure( benchmarkCase, options, result );
+      results.push_back( result );
+      }
+    }
+
+  result.Operation = "RThetaToCartesianTransform::TransformPoint";
+  result.Name = "RThetaToCartesianTransform/TransformPoint" + suffix.str();
+  if( Selected( options, result.Name ) )
+    {
+    RThetaToCartesianTransformCase< TCoordRep, VDimension > benchmarkCase( geometry );
+    result.PixelsPerIteration = benchmarkCase.GetNumberOfPoints();
+    Measure( benchmarkCase, options, result );
+    results.push_back( result );
+    }
+}
+
+template < class TPixel, unsigned int VDimension >
+void
+BenchmarkFilter( const BenchmarkOptions & options,
+  const AcquisitionGeometry & geometry,
+  std::vector< BenchmarkResult > & results )
+{
+  BenchmarkResult result;
+  result.PixelType = PixelTypeName< TPixel >::Get();
+  result.Dimension = VDimension;
+  result.InputSize = SizeString( geometry, VDimension );
+
+  for( unsigned int useLookupTable = 0; useLookupTable < 2; useLookupTable++ )
+    {
+    for( unsigned int t = 0; t < options.Threads.size(); t++ )
+      {
+      result.Threads = options.Threads[t];
+      result.Operation = useLookupTable ? "ResampleRThetaToCartesianImageFilter+LookupTable" :
+        "ResampleRThetaToCartesianImageFilter";
+      std::ostringstream name;
+      name << "Filter/" << result.PixelType << "/" << VDimension << "D/"
+        << ( useLookupTable ? "lookup-table" : "native" )
+        << "/threads:" << result.Threads << "/input:" << result.InputSize;
+      result.Name = name.str();
+      if( !Selected( options, result.Name ) )
+        {
+        continue;
+        }
+      ResampleFilterCase< TPixel, VDimension > benchmarkCase( geometry, result.Threads, useLookupTable != 0 );
+      result.PixelsPerIteration = benchmarkCase.GetNumberOfPixels();
+      Measure( benchmarkCase, options, result );
+      results.push_back( result );
+      }
+    }
+}
+
+double MegapixelsPerSecond( const BenchmarkResult & result )
+{
+  return result.PixelsPerIteration * static_cast< double >( result.Iterations ) / result.Seconds * 1.0e-6;
+}
+
+double CyclesPerPixel( const BenchmarkResult & result )
+{
+  return result.Cycles * result.Threads /
+    ( result.PixelsPerIteration * static_cast< double >( result.Iterations ) );
+}
+
+void WriteConsole( std::ostream & os, const std::vector< BenchmarkResult > & results )
+{
+  os << std::left << std::setw( 64 ) << "Benchmark" << std::right
+    << std::setw( 12 ) << "Iterations"
+    << std::setw( 14 ) << "ms/iteration"
+    << std::setw( 12 ) << "Mpixels/s"
+    << std::setw( 14 ) << "cycles/pixel" << std::endl;
+  os << std::string( 116, '-' ) << std::endl;
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    const BenchmarkResult & result = results[i];
+    os << std::left << std::setw( 64 ) << result.Name << std::right
+      << std::setw( 12 ) << result.Iterations
+      << std::setw( 14 ) << std::fixed << std::setprecision( 3 )
+      << 1.0e3 * result.Seconds / result.Iterations
+      << std::setw( 12 ) << std::setprecision( 2 ) << MegapixelsPerSecond( result );
+    if( result.HaveCycles )
+      {
+      os << std::setw( 14 ) << std::setprecision( 2 ) << CyclesPerPixel( result );
+      }
+    else
+      {
+      os << std::setw( 14 ) << "n/a";
+      }
+    os << std::endl;
+    }
+}
+
+void WriteCSV( std::ostream & os, const std::vector< BenchmarkResult > & results )
+{
+  os << "name,operation,pixel_type,dimension,threads,input_size,pixels,iterations,"
+    "seconds,mpixels_per_second,cycles_per_pixel" << std::endl;
+  os << std::setprecision( 8 );
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    const BenchmarkResult & result = results[i];
+    os << result.Name << ',' << result.Operation << ',' << result.PixelType << ','
+      << result.Dimension << ',' << result.Threads << ',' << result.InputSize << ','
+      << result.PixelsPerIteration << ',' << result.Iterations << ','
+      << result.Seconds << ',' << MegapixelsPerSecond( result ) << ',';
+    if( result.HaveCycles )
+      {
+      os << CyclesPerPixel( result );
+      }
+    os << std::endl;
+    }
+}
+
+void WriteJSON( std::ostream & os, const std::vector< BenchmarkResult > & results )
+{
+  os << std::setprecision( 8 );
+  os << "{" << std::endl;
+  os << "  \"context\": {" << std::endl;
+  os << "    \"default_threads\": " << itk::MultiThreader::GetGlobalDefaultNumberOfThreads() << "," << std::endl;
+#ifdef SCAN_CONVERT_BENCHMARK_HAVE_TSC
+  os << "    \"cycle_counter\": \"tsc\"" << std::endl;
+#else
+  os << "    \"cycle_counter\": \"cpu-frequency\"" << std::endl;
+#endif
+  os << "  }," << std::endl;
+  os << "  \"benchmarks\": [" << std::endl;
+  for( unsigned int i = 0; i < results.size(); i++ )
+    {
+    const BenchmarkResult & result = results[i];
+    os << "    {"
+      << "\"name\": \"" << result.Name << "\", "
+      << "\"operation\": \"" << result.Operation << "\", "
+      << "\"pixel_type\": \"" << result.PixelType << "\", "
+      << "\"dimension\": " << result.Dimension << ", "
+      << "\"threads\": " << result.Threads << ", "
+      << "\"input_size\": \"" << result.InputSize << "\", "
+      << "\"pixels\": " << result.PixelsPerIteration << ", "
+      << "\"iterations\": " << result.Iterations << ", "
+      << "\"seconds\": " << result.Seconds << ", "
+      << "\"mpixels_per_second\": " << MegapixelsPerSecond( result ) << ", "
+      << "\"cycles_per_pixel\": ";
+    if( result.HaveCycles )
+      {
+      os << CyclesPerPixel( result );
+      }
+    else
+      {
+      os << "null";
+      }
+    os << "}" << ( i + 1 < results.size() ? "," : "" ) << std::endl;
+    }
+  os << "  ]" << std::endl;
+  os << "}" << std::endl;
+}
+
+bool ParseOptions( int argc, char * argv[], BenchmarkOptions & options )
+{
+  options.Format = "console";
+  options.MinimumTime = 0.5;
+  options.CPUFrequency = 0.0;
+  std::string threads;
+  for( int i = 1; i < argc; i++ )
+    {
+    const std::string argument( argv[i] );
+    const std::string::size_type equals = argument.find( '=' );
+    const std::string key = argument.substr( 0, equals );
+    const std::string value = equals == std::string::npos ? std::string() : argument.substr( equals + 1 );
+    if( key == "--format" && ( value == "console" || value == "csv" || value == "json" ) )
+      {
+      options.Format = value;
+      }
+    else if( key == "--out" )
+      {
+      options.OutputFileName = value;
+      }
+    else if( key == "--filter" )
+      {
+      options.Filter = value;
+      }
+    else if( key == "--min-time" )
+      {
+      options.MinimumTime = atof( value.c_str() );
+      }
+    else if( key == "--cpu-frequency" )
+      {
+      options.CPUFrequency = atof( value.c_str() );
+      }
+    else if( key == "--threads" )
+      {
+      threads = value;
+      }
+    else
+      {
+      std::cerr << "Unknown option: " << argument << std::endl;
+      return false;
+      }
+    }
+
+  if( threads.empty() )
+    {
+    // Powers of two up to the default, and the default itself.
+    const int maximumThreads = itk::MultiThreader::GetGlobalDefaultNumberOfThreads();
+    for( int t = 1; t < maximumThreads; t *= 2 )
+      {
+      options.Threads.push_back( t );
+      }
+    options.Threads.push_back( maximumThreads );
+    }
+  else
+    {
+    std::replace( threads.begin(), threads.end(), ',', ' ' );
+    std::istringstream iss( threads );
+    int t;
+    while( iss >> t )
+      {
+      if( t > 0 )
+        {
+        options.Threads.push_back( t );
+        }
+      }
+    }
+  return !options.Threads.empty();
+}
+
+} // end anonymous namespace
+
+int main( int argc, char * argv[] )
+{
+  BenchmarkOptions options;
+  if( !ParseOptions( argc, argv, options ) )
+    {
+    std::cerr << "Usage: " << argv[0] << " [--format=console|csv|json] [--out=<file>]"
+      " [--filter=<substring>] [--min-time=<seconds>] [--threads=<n>[,<n>...]]"
+      " [--cpu-frequency=<GHz>]" << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  // Small, typical, and large acquisitions.  The elevational size is only
+  // used by the 3D cases.
+  const AcquisitionGeometry geometries[] = {
+    { { 256,  64,  8 } },
+    { { 1024, 256, 8 } },
+    { { 2048, 512, 4 } }
+  };
+  const unsigned int numberOfGeometries = sizeof( geometries ) / sizeof( geometries[0] );
+
+  std::vector< BenchmarkResult > results;
+  try
+    {
+    for( unsigned int g = 0; g < numberOfGeometries; g++ )
+      {
+      BenchmarkTransforms< float, 2 >( options, geometries[g], results );
+      BenchmarkTransforms< double, 2 >( options, geometries[g], results );
+      BenchmarkTransforms< float, 3 >( options, geometries[g], results );
+      BenchmarkTransforms< double, 3 >( options, geometries[g], results );
+      }
+    for( unsigned int g = 0; g < numberOfGeometries; g++ )
+      {
+      BenchmarkFilter< unsigned char, 2 >( options, geometries[g], results );
+      BenchmarkFilter< short, 2 >( options, geometries[g], results );
+      BenchmarkFilter< float, 2 >( options, geometries[g], results );
+      BenchmarkFilter< unsigned char, 3 >( options, geometries[g], results );
+      BenchmarkFilter< short, 3 >( options, geometries[g], results );
+      BenchmarkFilter< float, 3 >( options, geometries[g], results );
+      }
+    }
+  catch ( itk::ExceptionObject& e )
+    {
+    std::cerr << "Error: " << e << std::endl;
+    return EXIT_FAILURE;
+    }
+
+  std::ofstream file;
+  if( !options.OutputFileName.empty() )
+    {
+    file.open( options.OutputFileName.c_str() );
+    if( !file )
+      {
+      std::cerr << "Could not open " << options.OutputFileName << std::endl;
+      return EXIT_FAILURE;
+      }
+    }
+  std::ostream & os = options.OutputFileName.empty() ? std::cout : file;
+
+  if( options.Format == "json" )
+    {
+    WriteJSON( os, results );
+    }
+  else if( options.Format == "csv" )
+    {
+    WriteCSV( os, results );
+    }
+  else
+    {
+    WriteConsole( os, results );
+    }
+  // Keep the human readable table on the terminal when a file is written.
+  if( !options.OutputFileName.empty() && options.Format != "console" )
+    {
+    WriteConsole( std::cout, results );
+    }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,171 @@
+#ifndef __itkCartesianToRThetaFunctor_h
+#define __itkCartesianToRThetaFunctor_h
+
+#include "itkCartesianToRThetaTransform.h"
+#include "itkCartesianToRThetaKernel.h"
+
+namespace itk
+{
+namespace Functor
+{
+
+/** @brief Non-virtual evaluation of a CartesianToRThetaTransform.
+ *
+ * The scalar type and the R and Theta directions are template parameters,
+ * and SetTransform() copies the constants the transform derives from its
+ * parameters, Rmin, Thetamin, SpacingThetaOverDeltaTheta and its inverse,
+ * into plain members.  Every call is resolved at compile time, so loops that
+ * use the functor can be inlined and vectorized by the compiler.
+ *
+ * operator()( point ) computes what the transform's TransformPoint() does.
+ * The overload for two scalars and TransformLine() take the coordinates in
+ * the RDirection and the ThetaDirection directly, so they can be used for
+ * any pair of directions.  TransformLine() honors the transform's
+ * ThetaTolerance like TransformRThetaCoordinates().
+ *
+ * The functor refers to the transform when the ThetaArray is non-uniform, so
+ * SetTransform() must be called again after the transform is modified.
+ */
+template < class TScalar,
+  unsigned int VDimension,
+  unsigned int VRDirection = 0,
+  unsigned int VThetaDirection = 1 >
+class CartesianToRTheta
+{
+public:
+  typedef TScalar                                         ScalarType;
+  typedef CartesianToRThetaTransform< TScalar, VDimension > TransformType;
+  typedef typename TransformType::InputPointType           InputPointType;
+  typedef typename TransformType::OutputPointType          OutputPointType;
+
+  itkStaticConstMacro( RDirection, unsigned int, VRDirection );
+  itkStaticConstMacro( ThetaDirection, unsigned int, VThetaDirection );
+
+  CartesianToRTheta():
+    m_Rmin( 0.0 ),
+    m_Thetamin( 0.0 ),
+    m_SpacingThetaOverDeltaTheta( 0.0 ),
+    m_DeltaThetaOverSpacingTheta( 0.0 ),
+    m_SpacingTheta( 0.0 ),
+    m_ArcTangentOrder( 0 ),
+    m_ThetaIndexTransform( NULL )
+  {}
+
+  /** Cache the constants of transform. */
+  void SetTransform( const TransformType * transform )
+    {
+    this->SetTransform( transform, transform->GetThetaTolerance() );
+    }
+
+  /** Cache the constants of transform, with thetaTolerance in place of its
+   * ThetaTolerance. */
+  void SetTransform( const TransformType * transform, double thetaTolerance )
+    {
+    const typename TransformType::ParametersType & parameters = transform->GetParameters();
+    m_Rmin = parameters[0];
+    m_Thetamin = parameters[3];
+    m_SpacingThetaOverDeltaTheta = parameters[4];
+    m_DeltaThetaOverSpacingTheta = parameters[4] == 0.0 ? 0.0 : 1.0 / parameters[4];
+    m_SpacingTheta = transform->GetSpacingTheta();
+    m_ArcTangentOrder = transform->GetArcTangentOrder( thetaTolerance );
+    m_ThetaIndexTransform = transform->GetUseThetaIndexTable() ? transform : NULL;
+    }
+
+  double GetRmin() const
+    {
+    return m_Rmin;
+    }
+
+  double GetThetamin() const
+    {
+    return m_Thetamin;
+    }
+
+  /** Radial and ThetaDirection input coordinates of the point ( x, y ) in the
+   * plane of the RDirection and the ThetaDirection. */
+  inline void operator()( ScalarType x, ScalarType y,
+    ScalarType & rCoordinate, ScalarType & thetaCoordinate ) const
+    {
+    const ScalarType theta = vcl_atan( y / x );
+    const ScalarType r = vcl_sqrt( x * x + y * y );
+    rCoordinate = r - m_Rmin;
+    if( m_ThetaIndexTransform == NULL )
+      {
+      thetaCoordinate = ( theta - m_Thetamin ) * m_SpacingThetaOverDeltaTheta;
+      }
+    else
+      {
+      thetaCoordinate = m_ThetaIndexTransform->ThetaToContinuousIndex( theta ) * m_SpacingTheta;
+      }
+    }
+
+  inline OutputPointType operator()( const InputPointType & point ) const
+    {
+    OutputPointType result = point;
+    ( *this )( point[VRDirection], point[VThetaDirection],
+      result[VRDirection], result[VThetaDirection] );
+    return result;
+    }
+
+  /** Angle of a ThetaDirection coordinate.  Inverse of the linear mapping
+   * used for uniform Theta arrays. */
+  inline double ThetaCoordinateToTheta( double thetaCoordinate ) const
+    {
+    return m_Thetamin + thetaCoordinate * m_DeltaThetaOverSpacingTheta;
+    }
+
+  /** Transform n points whose coordinates in the RDirection and the
+   * ThetaDirection are stored in separate arrays. */
+  void TransformLine( const ScalarType * x, const ScalarType * y,
+    ScalarType * rCoordinates, ScalarType * thetaCoordinates,
+    unsigned long n ) const
+    {
+    if( m_ThetaIndexTransform == NULL )
+      {
+      CartesianToRThetaKernel< ScalarType >::Evaluate( x, y, rCoordinates, thetaCoordinates,
+        n, m_ArcTangentOrder,
+        static_cast< ScalarType >( m_Rmin ),
+        static_cast< ScalarType >( m_Thetamin ),
+        static_cast< ScalarType >( m_SpacingThetaOverDeltaTheta ) );
+      return;
+      }
+
+    CartesianToRThetaKernel< ScalarType >::Evaluate( x, y, rCoordinates, thetaCoordinates,
+      n, m_ArcTangentOrder, static_cast< ScalarType >( m_Rmin ),
+      static_cast< ScalarType >( 0.0 ), static_cast< ScalarType >( 1.0 ) );
+    for( unsigned long i = 0; i < n; i++ )
+      {
+      thetaCoordinates[i] = static_cast< ScalarType >(
+        m_ThetaIndexTransform->ThetaToContinuousIndex( thetaCoordinates[i] ) * m_SpacingTheta );
+      }
+    }
+
+  bool operator==( const CartesianToRTheta & other ) const
+    {
+    return m_Rmin == other.m_Rmin &&
+      m_Thetamin == other.m_Thetamin &&
+      m_SpacingThetaOverDeltaTheta == other.m_SpacingThetaOverDeltaTheta &&
+      m_SpacingTheta == other.m_SpacingTheta &&
+      m_ArcTangentOrder == other.m_ArcTangentOrder &&
+      m_ThetaIndexTransform == other.m_ThetaIndexTransform;
+    }
+
+  bool operator!=( const CartesianToRTheta & other ) const
+    {
+    return !( *this == other );
+    }
+
+private:
+  double               m_Rmin;
+  double               m_Thetamin;
+  double               m_SpacingThetaOverDeltaTheta;
+  double               m_DeltaThetaOverSpacingTheta;
+  double               m_SpacingTheta;
+  unsigned int         m_ArcTangentOrder;
+  const TransformType* m_ThetaIndexTransform;
+};
+
+} // end namespace Functor
+} // end namespace itk
+
+#endif // __itkCartesianToRThetaFunctor_h
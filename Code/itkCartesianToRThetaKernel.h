@@ -0,0 +1,344 @@
+#ifndef __itkCartesianToRThetaKernel_h
+#define __itkCartesianToRThetaKernel_h
+
+#include "itkMacro.h"
+#include "vnl/vnl_math.h"
+
+#if defined( __SSE2__ )
+#include <emmintrin.h>
+#endif
+#if defined( __AVX__ )
+#include <immintrin.h>
+#endif
+
+namespace itk
+{
+
+/** @brief Batch evaluation of the Cartesian to (R, Theta) mapping used by
+ * CartesianToRThetaTransform.
+ *
+ * For arrays of coordinates x in the RDirection and y in the
+ * ThetaDirection, computes
+ *
+ *   r     = sqrt( x^2 + y^2 ) - rOffset
+ *   theta = ( atan( y / x ) - thetaOffset ) * thetaScale
+ *
+ * four (SSE2) or eight (AVX) values at a time with a scalar loop for the
+ * remainder and for other scalar types.
+ *
+ * The square root uses the hardware instruction, which is exact to the last
+ * bit.  The arc tangent is evaluated exactly with vcl_atan when the order is
+ * 0.  Otherwise, it is approximated with a minimax polynomial
+ * atan(t) ~= t P(t^2) on [0, 1] of the given order, and the range is reduced
+ * with atan(t) = pi/2 - atan(1/t).  The maximum absolute errors in radians
+ * are:
+ *
+ *   order 3: 6.1e-4    order 6: 1.7e-6
+ *   order 4: 8.2e-5    order 7: 2.5e-7
+ *   order 5: 1.2e-5    order 8: 3.8e-8
+ *
+ * Single precision evaluation adds about 2e-7 radians of rounding error.
+ * SelectArcTangentOrder() picks the cheapest order that meets a bound.
+ */
+template < class TScalarType >
+class CartesianToRThetaKernel
+{
+public:
+  typedef TScalarType ScalarType;
+
+  itkStaticConstMacro( MaximumArcTangentOrder, unsigned int, 8 );
+
+  /** Maximum absolute error in radians of the polynomial of the given order,
+   * including rounding in ScalarType.  0 for the exact order 0. */
+  static double GetArcTangentMaximumError( unsigned int order )
+    {
+    static const double errors[] =
+      { 0.0, 0.0, 0.0, 6.1e-4, 8.2e-5, 1.2e-5, 1.7e-6, 2.5e-7, 3.8e-8 };
+    if( order == 0 || order > MaximumArcTangentOrder )
+      {
+      return 0.0;
+      }
+    return errors[order] + 2.0 * GetRoundingError();
+    }
+
+  /** The lowest polynomial order whose error is below maximumError, or 0 if
+   * the exact arc tangent is required. */
+  static unsigned int SelectArcTangentOrder( double maximumError )
+    {
+    if( maximumError <= 0.0 )
+      {
+      return 0;
+      }
+    for( unsigned int order = 3; order <= MaximumArcTangentOrder; order++ )
+      {
+      if( GetArcTangentMaximumError( order ) <= maximumError )
+        {
+        return order;
+        }
+      }
+    return 0;
+    }
+
+  /** Coefficients c_k of atan(t) ~= t sum_k c_k t^(2k). */
+  static const double * GetArcTangentCoefficients( unsigned int order )
+    {
+    static const double coefficients[][MaximumArcTangentOrder] = {
+      { 9.9535758565e-01, -2.8868812944e-01, 7.9336838591e-02 },
+      { 9.9921373581e-01, -3.2117415621e-01, 1.4626243501e-01, -3.8985123047e-02 },
+      { 9.9986631677e-01, -3.3030457185e-01, 1.8015836434e-01, -8.5154894114e-02,
+        2.0844370059e-02 },
+      { 9.9997721719e-01, -3.3262278159e-01, 1.9354006939e-01, -1.1642567193e-01,
+        5.2646431829e-02, -1.1718761291e-02 },
+      { 9.9999611114e-01, -3.3317366756e-01, 1.9807803980e-01, -1.3233298227e-01,
+        7.9622871569e-02, -3.3603523871e-02, 6.8115615889e-03 },
+      { 9.9999933522e-01, -3.3329859427e-01, 1.9946550765e-01, -1.3908557468e-01,
+        9.6420180656e-02, -5.5909938736e-02, 2.1861337719e-02, -4.0541275527e-03 } };
+    return coefficients[order - 3];
+    }
+
+  /** atan( y / x ) with the polynomial of the given order, or vcl_atan for
+   * order 0. */
+  static ScalarType ArcTangent( ScalarType y, ScalarType x, unsigned int order )
+    {
+    if( order == 0 )
+      {
+      return vcl_atan( y / x );
+      }
+    const double * c = GetArcTangentCoefficients( order );
+    const ScalarType ax = x < 0 ? -x : x;
+    const ScalarType ay = y < 0 ? -y : y;
+    const bool swap = ay > ax;
+    const ScalarType t = swap ? ax / ay : ay / ax;
+    const ScalarType t2 = t * t;
+    ScalarType p = static_cast< ScalarType >( c[order - 1] );
+    for( int k = order - 2; k >= 0; k-- )
+      {
+      p = p * t2 + static_cast< ScalarType >( c[k] );
+      }
+    p *= t;
+    if( swap )
+      {
+      p = static_cast< ScalarType >( vnl_math::pi_over_2 ) - p;
+      }
+    return ( ( x < 0 ) != ( y < 0 ) ) ? -p : p;
+    }
+
+  /** Evaluate n values.  The arrays may not overlap. */
+  static void Evaluate( const ScalarType * x, const ScalarType * y,
+    ScalarType * r, ScalarType * theta,
+    unsigned long n, unsigned int order,
+    ScalarType rOffset, ScalarType thetaOffset, ScalarType thetaScale )
+    {
+    EvaluateScalar( x, y, r, theta, 0, n, order, rOffset, thetaOffset, thetaScale );
+    }
+
+protected:
+  static double GetRoundingError()
+    {
+    return sizeof( ScalarType ) < sizeof( double ) ? 1.0e-7 : 0.0;
+    }
+
+  static void EvaluateScalar( const ScalarType * x, const ScalarType * y,
+    ScalarType * r, ScalarType * theta,
+    unsigned long begin, unsigned long end, unsigned int order,
+    ScalarType rOffset, ScalarType thetaOffset, ScalarType thetaScale )
+    {
+    for( unsigned long i = begin; i < end; i++ )
+      {
+      r[i] = vcl_sqrt( x[i] * x[i] + y[i] * y[i] ) - rOffset;
+      theta[i] = ( ArcTangent( y[i], x[i], order ) - thetaOffset ) * thetaScale;
+      }
+    }
+};
+
+
+#if defined( __SSE2__ )
+
+template <>
+inline void
+CartesianToRThetaKernel< float >
+::Evaluate( const float * x, const float * y,
+  float * r, float * theta,
+  unsigned long n, unsigned int order,
+  float rOffset, float thetaOffset, float thetaScale )
+{
+  if( order == 0 )
+    {
+    EvaluateScalar( x, y, r, theta, 0, n, order, rOffset, thetaOffset, thetaScale );
+    return;
+    }
+  const double * c = GetArcTangentCoefficients( order );
+  unsigned long i = 0;
+
+#if defined( __AVX__ )
+  {
+  __m256 coefficients[MaximumArcTangentOrder];
+  for( unsigned int k = 0; k < order; k++ )
+    {
+    coefficients[k] = _mm256_set1_ps( static_cast< float >( c[k] ) );
+    }
+  const __m256 signMask = _mm256_set1_ps( -0.0f );
+  const __m256 halfPi = _mm256_set1_ps( static_cast< float >( vnl_math::pi_over_2 ) );
+  const __m256 rOffsetV = _mm256_set1_ps( rOffset );
+  const __m256 thetaOffsetV = _mm256_set1_ps( thetaOffset );
+  const __m256 thetaScaleV = _mm256_set1_ps( thetaScale );
+  for( ; i + 8 <= n; i += 8 )
+    {
+    const __m256 vx = _mm256_loadu_ps( x + i );
+    const __m256 vy = _mm256_loadu_ps( y + i );
+    const __m256 radius = _mm256_sqrt_ps( _mm256_add_ps( _mm256_mul_ps( vx, vx ), _mm256_mul_ps( vy, vy ) ) );
+    _mm256_storeu_ps( r + i, _mm256_sub_ps( radius, rOffsetV ) );
+
+    const __m256 ax = _mm256_andnot_ps( signMask, vx );
+    const __m256 ay = _mm256_andnot_ps( signMask, vy );
+    const __m256 sign = _mm256_and_ps( _mm256_xor_ps( vx, vy ), signMask );
+    const __m256 swap = _mm256_cmp_ps( ay, ax, _CMP_GT_OQ );
+    const __m256 t = _mm256_div_ps( _mm256_min_ps( ax, ay ), _mm256_max_ps( ax, ay ) );
+    const __m256 t2 = _mm256_mul_ps( t, t );
+    __m256 p = coefficients[order - 1];
+    for( int k = order - 2; k >= 0; k-- )
+      {
+      p = _mm256_add_ps( _mm256_mul_ps( p, t2 ), coefficients[k] );
+      }
+    p = _mm256_mul_ps( p, t );
+    p = _mm256_blendv_ps( p, _mm256_sub_ps( halfPi, p ), swap );
+    p = _mm256_xor_ps( p, sign );
+    _mm256_storeu_ps( theta + i, _mm256_mul_ps( _mm256_sub_ps( p, thetaOffsetV ), thetaScaleV ) );
+    }
+  }
+#endif
+
+  __m128 coefficients[MaximumArcTangentOrder];
+  for( unsigned int k = 0; k < order; k++ )
+    {
+    coefficients[k] = _mm_set1_ps( static_cast< float >( c[k] ) );
+    }
+  const __m128 signMask = _mm_set1_ps( -0.0f );
+  const __m128 halfPi = _mm_set1_ps( static_cast< float >( vnl_math::pi_over_2 ) );
+  const __m128 rOffsetV = _mm_set1_ps( rOffset );
+  const __m128 thetaOffsetV = _mm_set1_ps( thetaOffset );
+  const __m128 thetaScaleV = _mm_set1_ps( thetaScale );
+  for( ; i + 4 <= n; i += 4 )
+    {
+    const __m128 vx = _mm_loadu_ps( x + i );
+    const __m128 vy = _mm_loadu_ps( y + i );
+    const __m128 radius = _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( vx, vx ), _mm_mul_ps( vy, vy ) ) );
+    _mm_storeu_ps( r + i, _mm_sub_ps( radius, rOffsetV ) );
+
+    const __m128 ax = _mm_andnot_ps( signMask, vx );
+    const __m128 ay = _mm_andnot_ps( signMask, vy );
+    const __m128 sign = _mm_and_ps( _mm_xor_ps( vx, vy ), signMask );
+    const __m128 swap = _mm_cmpgt_ps( ay, ax );
+    const __m128 t = _mm_div_ps( _mm_min_ps( ax, ay ), _mm_max_ps( ax, ay ) );
+    const __m128 t2 = _mm_mul_ps( t, t );
+    __m128 p = coefficients[order - 1];
+    for( int k = order - 2; k >= 0; k-- )
+      {
+      p = _mm_add_ps( _mm_mul_ps( p, t2 ), coefficients[k] );
+      }
+    p = _mm_mul_ps( p, t );
+    p = _mm_or_ps( _mm_and_ps( swap, _mm_sub_ps( halfPi, p ) ), _mm_andnot_ps( swap, p ) );
+    p = _mm_xor_ps( p, sign );
+    _mm_storeu_ps( theta + i, _mm_mul_ps( _mm_sub_ps( p, thetaOffsetV ), thetaScaleV ) );
+    }
+
+  EvaluateScalar( x, y, r, theta, i, n, order, rOffset, thetaOffset, thetaScale );
+}
+
+
+template <>
+inline void
+CartesianToRThetaKernel< double >
+::Evaluate( const double * x, const double * y,
+  double * r, double * theta,
+  unsigned long n, unsigned int order,
+  double rOffset, double thetaOffset, double thetaScale )
+{
+  if( order == 0 )
+    {
+    EvaluateScalar( x, y, r, theta, 0, n, order, rOffset, thetaOffset, thetaScale );
+    return;
+    }
+  const double * c = GetArcTangentCoefficients( order );
+  unsigned long i = 0;
+
+#if defined( __AVX__ )
+  {
+  __m256d coefficients[MaximumArcTangentOrder];
+  for( unsigned int k = 0; k < order; k++ )
+    {
+    coefficients[k] = _mm256_set1_pd( c[k] );
+    }
+  const __m256d signMask = _mm256_set1_pd( -0.0 );
+  const __m256d halfPi = _mm256_set1_pd( vnl_math::pi_over_2 );
+  const __m256d rOffsetV = _mm256_set1_pd( rOffset );
+  const __m256d thetaOffsetV = _mm256_set1_pd( thetaOffset );
+  const __m256d thetaScaleV = _mm256_set1_pd( thetaScale );
+  for( ; i + 4 <= n; i += 4 )
+    {
+    const __m256d vx = _mm256_loadu_pd( x + i );
+    const __m256d vy = _mm256_loadu_pd( y + i );
+    const __m256d radius = _mm256_sqrt_pd( _mm256_add_pd( _mm256_mul_pd( vx, vx ), _mm256_mul_pd( vy, vy ) ) );
+    _mm256_storeu_pd( r + i, _mm256_sub_pd( radius, rOffsetV ) );
+
+    const __m256d ax = _mm256_andnot_pd( signMask, vx );
+    const __m256d ay = _mm256_andnot_pd( signMask, vy );
+    const __m256d sign = _mm256_and_pd( _mm256_xor_pd( vx, vy ), signMask );
+    const __m256d swap = _mm256_cmp_pd( ay, ax, _CMP_GT_OQ );
+    const __m256d t = _mm256_div_pd( _mm256_min_pd( ax, ay ), _mm256_max_pd( ax, ay ) );
+    const __m256d t2 = _mm256_mul_pd( t, t );
+    __m256d p = coefficients[order - 1];
+    for( int k = order - 2; k >= 0; k-- )
+      {
+      p = _mm256_add_pd( _mm256_mul_pd( p, t2 ), coefficients[k] );
+      }
+    p = _mm256_mul_pd( p, t );
+    p = _mm256_blendv_pd( p, _mm256_sub_pd( halfPi, p ), swap );
+    p = _mm256_xor_pd( p, sign );
+    _mm256_storeu_pd( theta + i, _mm256_mul_pd( _mm256_sub_pd( p, thetaOffsetV ), thetaScaleV ) );
+    }
+  }
+#endif
+
+  __m128d coefficients[MaximumArcTangentOrder];
+  for( unsigned int k = 0; k < order; k++ )
+    {
+    coefficients[k] = _mm_set1_pd( c[k] );
+    }
+  const __m128d signMask = _mm_set1_pd( -0.0 );
+  const __m128d halfPi = _mm_set1_pd( vnl_math::pi_over_2 );
+  const __m128d rOffsetV = _mm_set1_pd( rOffset );
+  const __m128d thetaOffsetV = _mm_set1_pd( thetaOffset );
+  const __m128d thetaScaleV = _mm_set1_pd( thetaScale );
+  for( ; i + 2 <= n; i += 2 )
+    {
+    const __m128d vx = _mm_loadu_pd( x + i );
+    const __m128d vy = _mm_loadu_pd( y + i );
+    const __m128d radius = _mm_sqrt_pd( _mm_add_pd( _mm_mul_pd( vx, vx ), _mm_mul_pd( vy, vy ) ) );
+    _mm_storeu_pd( r + i, _mm_sub_pd( radius, rOffsetV ) );
+
+    const __m128d ax = _mm_andnot_pd( signMask, vx );
+    const __m128d ay = _mm_andnot_pd( signMask, vy );
+    const __m128d sign = _mm_and_pd( _mm_xor_pd( vx, vy ), signMask );
+    const __m128d swap = _mm_cmpgt_pd( ay, ax );
+    const __m128d t = _mm_div_pd( _mm_min_pd( ax, ay ), _mm_max_pd( ax, ay ) );
+    const __m128d t2 = _mm_mul_pd( t, t );
+    __m128d p = coefficients[order - 1];
+    for( int k = order - 2; k >= 0; k-- )
+      {
+      p = _mm_add_pd( _mm_mul_pd( p, t2 ), coefficients[k] );
+      }
+    p = _mm_mul_pd( p, t );
+    p = _mm_or_pd( _mm_and_pd( swap, _mm_sub_pd( halfPi, p ) ), _mm_andnot_pd( swap, p ) );
+    p = _mm_xor_pd( p, sign );
+    _mm_storeu_pd( theta + i, _mm_mul_pd( _mm_sub_pd( p, thetaOffsetV ), thetaScaleV ) );
+    }
+
+  EvaluateScalar( x, y, r, theta, i, n, order, rOffset, thetaOffset, thetaScale );
+}
+
+#endif // __SSE2__
+
+} // end namespace itk
+
+#endif // __itkCartesianToRThetaKernel_h
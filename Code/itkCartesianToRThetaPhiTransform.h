@@ -0,0 +1,335 @@
+#ifndef __itkCartesianToRThetaPhiTransform_h
+#define __itkCartesianToRThetaPhiTransform_h
+
+#include "itkMatrix.h"
+#include "itkTransform.h"
+
+#include "itkCartesianToRThetaTransform.h"
+
+namespace itk
+{
+
+/** @brief Transform Cartesian space (x-y-z) to R-Theta-Phi space (radius and
+ * two angles).  E.g., scan convert a volume from a mechanically swept
+ * curvilinear array or a matrix array.
+ *
+ * A sample at radius r along line theta of the frame at elevation angle phi
+ * is at
+ *
+ *   x = ( r cos( theta ) + PhiRadius ) cos( phi ) - PhiRadius
+ *   y = r sin( theta )
+ *   z = ( r cos( theta ) + PhiRadius ) sin( phi )
+ *
+ * i.e. each frame is a curvilinear (R, Theta) image that is rotated by phi
+ * about an axis parallel to y, PhiRadius behind the center of the theta
+ * rotation.  A PhiRadius of 0, the default, is the double-angle geometry of
+ * a matrix array; a mechanically swept probe has its motor axis PhiRadius
+ * behind the apex of the array.  Valid values of theta and phi range from
+ * -pi/2 to pi/2.
+ *
+ * The transform is the composition of two CartesianToRThetaTransform's:
+ * GetPhiTransform() maps ( x + PhiRadius, z ) to the distance from the phi
+ * axis and the PhiDirection coordinate, and GetRThetaTransform() maps that
+ * distance minus PhiRadius, and y, to the RDirection and ThetaDirection
+ * coordinates.  Both use the ThetaTolerance, as a fraction of their own
+ * step in angle, in TransformPoints().
+ *
+ *  Properties:
+ *  RDirection, ThetaDirection, PhiDirection
+ *    The directions in the input image assumed to correspond to the radial
+ *    and the two angular components.
+ *
+ * Parameters include:
+ *
+ *  Rmin, Rmax, MaxAbsTheta, Thetamin, SpacingThetaOverDeltaTheta
+ *    As for CartesianToRThetaTransform.
+ *
+ *  PhiRadius
+ *    Distance from the center of the theta rotation to the phi axis.
+ *
+ *  MaxAbsPhi, Phimin, SpacingPhiOverDeltaPhi
+ *    As MaxAbsTheta, Thetamin and SpacingThetaOverDeltaTheta for the
+ *    PhiArray.
+ */
+template < class TScalarType, unsigned int NDimensions=3 >
+class ITK_EXPORT CartesianToRThetaPhiTransform :
+  public Transform< TScalarType, NDimensions, NDimensions >
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef CartesianToRThetaPhiTransform Self;
+
+  /** Standard super class typedef support. */
+  typedef Transform< TScalarType, NDimensions, NDimensions > Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( CartesianToRThetaPhiTransform, Transform );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the domain space. */
+  itkStaticConstMacro(SpaceDimension, unsigned int, NDimensions);
+
+  /** Type of the input parameters. */
+  typedef  TScalarType     ScalarType;
+
+  /** Standard parameters container. */
+  typedef typename Superclass::ParametersType ParametersType;
+
+  /** Jacobian type. */
+  typedef typename Superclass::JacobianType   JacobianType;
+
+  /** Standard coordinate point type for this class */
+  typedef Point<TScalarType,
+                itkGetStaticConstMacro(SpaceDimension)> InputPointType;
+  typedef Point<TScalarType,
+                itkGetStaticConstMacro(SpaceDimension)> OutputPointType;
+
+  /** Standard vector type for this class. */
+  typedef Vector<TScalarType,
+                 itkGetStaticConstMacro(SpaceDimension)> InputVectorType;
+  typedef Vector<TScalarType,
+                 itkGetStaticConstMacro(SpaceDimension)> OutputVectorType;
+
+  /** Standard covariant vector type for this class. */
+  typedef CovariantVector<TScalarType,
+             itkGetStaticConstMacro(SpaceDimension)> InputCovariantVectorType;
+  typedef CovariantVector<TScalarType,
+            itkGetStaticConstMacro(SpaceDimension)> OutputCovariantVectorType;
+
+  /** Standard vnl_vector type for this class. */
+  typedef vnl_vector_fixed<TScalarType,
+                   itkGetStaticConstMacro(SpaceDimension)> InputVnlVectorType;
+  typedef vnl_vector_fixed<TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension)> OutputVnlVectorType;
+
+  /** Derivative of the output point with respect to the input point,
+   * jacobian[i][j] = d T_i / d x_j. */
+  typedef Matrix< TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension),
+                  itkGetStaticConstMacro(SpaceDimension) > SpatialJacobianType;
+
+  /** Type of the two components. */
+  typedef CartesianToRThetaTransform< TScalarType, NDimensions > ComponentTransformType;
+
+  /**  Method to transform a point. */
+  virtual OutputPointType TransformPoint(const InputPointType  &point ) const;
+
+  /** Transform numberOfPoints points at once.  Uses the vectorized kernel and
+   * the ThetaTolerance. */
+  virtual void TransformPoints( const InputPointType * inputPoints,
+    OutputPointType * outputPoints,
+    unsigned long numberOfPoints ) const;
+
+  /** Transform points whose coordinates in the RDirection, ThetaDirection
+   * and PhiDirection are stored in separate arrays, see
+   * CartesianToRThetaTransform::TransformRThetaCoordinates(). */
+  virtual void TransformRThetaPhiCoordinates( const ScalarType * rCoordinates,
+    const ScalarType * thetaCoordinates,
+    const ScalarType * phiCoordinates,
+    ScalarType * rOutput,
+    ScalarType * thetaOutput,
+    ScalarType * phiOutput,
+    unsigned long numberOfPoints ) const;
+
+  /** Method to transform a vector -
+   *  not applicable for this type of transform, since the result depends on
+   *  where the vector is.  Use TransformVector( vector, point ). */
+  virtual OutputVectorType TransformVector(const InputVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point )." );
+    return OutputVectorType();
+    }
+
+  /** Method to transform a vnl_vector -
+   *  not applicable for this type of transform */
+  virtual OutputVnlVectorType TransformVector(const InputVnlVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point ).");
+    return OutputVnlVectorType();
+    }
+
+  /** Method to transform a CovariantVector -
+   *  not applicable for this type of transform.  Use
+   *  TransformCovariantVector( vector, point ). */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transfrom.  Use TransformCovariantVector( vector, point ).");
+    return OutputCovariantVectorType();
+    }
+
+  /** Transform a vector, e.g. a displacement, located at point:
+   * ComputeJacobianWithRespectToPosition( point ) * vector. */
+  virtual OutputVectorType TransformVector( const InputVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform a covariant vector, e.g. a gradient, located at point: the
+   * inverse transpose of ComputeJacobianWithRespectToPosition( point ) times
+   * vector. */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform numberOfVectors vectors, each located at the corresponding
+   * point. */
+  virtual void TransformVectors( const InputPointType * points,
+    const InputVectorType * vectors,
+    OutputVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Transform numberOfVectors covariant vectors, each located at the
+   * corresponding point. */
+  virtual void TransformCovariantVectors( const InputPointType * points,
+    const InputCovariantVectorType * vectors,
+    OutputCovariantVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Derivative of the output point with respect to the Parameters at
+   * point, by the chain rule through the two components.  MaxAbsTheta and
+   * MaxAbsPhi do not enter the transform; their columns are zero. */
+  virtual const JacobianType & GetJacobian( const InputPointType & point ) const;
+
+  /** Derivative of the output point with respect to the input point.  The
+   * directions other than RDirection, ThetaDirection and PhiDirection are
+   * passed through. */
+  virtual void ComputeJacobianWithRespectToPosition( const InputPointType & point,
+    SpatialJacobianType & jacobian ) const;
+
+  /** Indicates that this transform is linear. That is, given two
+   * points P and Q, and scalar coefficients a and b, then
+   *
+   *           T( a*P + b*Q ) = a * T(P) + b * T(Q)
+   */
+  virtual bool IsLinear() const { return false; }
+
+   /** Base inverse transform type. This type should not be changed to the
+    * concrete inverse transform type or inheritance would be lost.*/
+  typedef typename Superclass::InverseTransformBaseType InverseTransformBaseType;
+  typedef typename InverseTransformBaseType::Pointer    InverseTransformBasePointer;
+
+  /** Return an inverse of this transform, an RThetaPhiToCartesianTransform. */
+  virtual InverseTransformBasePointer GetInverseTransform() const;
+
+  /** The direction in the input image that corresponds to the radial
+   * component. */
+  virtual void SetRDirection( unsigned int direction );
+  itkGetConstMacro( RDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the angular (theta)
+   * component. */
+  virtual void SetThetaDirection( unsigned int direction );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the elevation
+   * (phi) component. */
+  virtual void SetPhiDirection( unsigned int direction );
+  itkGetConstMacro( PhiDirection, unsigned int );
+
+  virtual const ParametersType & GetParameters( void ) const
+    {
+    return this->m_Parameters;
+    }
+  virtual void SetParameters( const ParametersType & parameters );
+
+  /** We must provide an implementation because it is abstract. */
+  virtual void SetFixedParameters( const ParametersType & )
+    {
+    }
+
+  /** Rmin and Rmax, see CartesianToRThetaTransform. */
+  virtual void SetRmin( const double& Rmin );
+  virtual void SetRmax( const double& Rmax );
+
+  /** PhiRadius
+   *	Distance from the center of the theta rotation to the phi axis.  Must
+   *	be set before the PhiArray. */
+  virtual void SetPhiRadius( const double& phiRadius );
+  double GetPhiRadius() const
+    {
+    return this->m_Parameters[5];
+    }
+
+  /** SpacingTheta and ThetaArray, see CartesianToRThetaTransform. */
+  virtual void SetSpacingTheta( double spacing );
+  itkGetConstMacro( SpacingTheta, double );
+  virtual void SetThetaArray( const itk::Array< double >& theta );
+  const itk::Array< double > & GetThetaArray() const
+    {
+    return m_RThetaTransform->GetThetaArray();
+    }
+
+  /** SpacingPhi
+   *	The assumed spacing in the PhiDirection.  This must be set before
+   *	PhiArray. */
+  virtual void SetSpacingPhi( double spacing );
+  itkGetConstMacro( SpacingPhi, double );
+
+  /** PhiArray
+   *	The angle in radians of every frame in the PhiDirection.  Like the
+   *	ThetaArray, it may be non-uniform if it is strictly monotonic.
+   *	SetRmax(), SetPhiRadius() and SetSpacingPhi() must be called before
+   *	this. */
+  virtual void SetPhiArray( const itk::Array< double >& phi );
+  const itk::Array< double > & GetPhiArray() const
+    {
+    return m_PhiTransform->GetThetaArray();
+    }
+
+  /** ThetaTolerance
+   *	Maximum error of the angles computed by TransformPoints() and
+   *	TransformRThetaPhiCoordinates(), as a fraction of the step between
+   *	lines or frames.  0, the default, uses the exact vcl_atan. */
+  virtual void SetThetaTolerance( double tolerance );
+  itkGetConstMacro( ThetaTolerance, double );
+
+  /** The component that maps ( x + PhiRadius, z ) to the distance from the
+   * phi axis, along the RDirection, and the PhiDirection coordinate, along
+   * the ThetaDirection of its points. */
+  const ComponentTransformType * GetPhiTransform() const
+    {
+    return m_PhiTransform.GetPointer();
+    }
+
+  /** The component that maps ( u, y ), u the distance from the phi axis minus
+   * PhiRadius, to the RDirection and ThetaDirection coordinates. */
+  const ComponentTransformType * GetRThetaTransform() const
+    {
+    return m_RThetaTransform.GetPointer();
+    }
+
+protected:
+  CartesianToRThetaPhiTransform();
+  ~CartesianToRThetaPhiTransform() {}
+
+  /** Set the Parameters of the components from this->m_Parameters. */
+  void UpdateComponentParameters();
+
+  unsigned int m_RDirection;
+  unsigned int m_ThetaDirection;
+  unsigned int m_PhiDirection;
+  double       m_SpacingTheta;
+  double       m_SpacingPhi;
+  double       m_ThetaTolerance;
+
+  typename ComponentTransformType::Pointer m_RThetaTransform;
+  typename ComponentTransformType::Pointer m_PhiTransform;
+
+private:
+  CartesianToRThetaPhiTransform( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkCartesianToRThetaPhiTransform.txx"
+#endif
+
+#endif // __itkCartesianToRThetaPhiTransform_h
@@ -0,0 +1,480 @@
+#ifndef __itkCartesianToRThetaPhiTransform_txx
+#define __itkCartesianToRThetaPhiTransform_txx
+
+#include "itkCartesianToRThetaPhiTransform.h"
+
+#include "itkRThetaPhiToCartesianTransform.h"
+
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+
+template < class TScalarType, unsigned int NDimensions >
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::CartesianToRThetaPhiTransform():
+  Superclass( SpaceDimension, 9 ),
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_PhiDirection( 2 ),
+  m_SpacingTheta( 0.0 ),
+  m_SpacingPhi( 0.0 ),
+  m_ThetaTolerance( 0.0 )
+{
+  this->m_Parameters.Fill( 0.0 );
+  // Rmin invalid value to make sure it gets set
+  this->m_Parameters[0] = -1.0;
+  // Rmax invalid value to make sure it gets set
+  this->m_Parameters[1] = -1.0;
+
+  m_RThetaTransform = ComponentTransformType::New();
+  m_RThetaTransform->SetRDirection( m_RDirection );
+  m_RThetaTransform->SetThetaDirection( m_ThetaDirection );
+
+  // The distance from the phi axis starts at the axis.
+  m_PhiTransform = ComponentTransformType::New();
+  m_PhiTransform->SetRDirection( m_RDirection );
+  m_PhiTransform->SetThetaDirection( m_PhiDirection );
+  m_PhiTransform->SetRmin( 0.0 );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetRDirection( unsigned int direction )
+{
+  m_RDirection = direction;
+  m_RThetaTransform->SetRDirection( direction );
+  m_PhiTransform->SetRDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetThetaDirection( unsigned int direction )
+{
+  m_ThetaDirection = direction;
+  m_RThetaTransform->SetThetaDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetPhiDirection( unsigned int direction )
+{
+  m_PhiDirection = direction;
+  m_PhiTransform->SetThetaDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetParameters( const ParametersType & parameters )
+{
+  this->m_Parameters = parameters;
+  this->UpdateComponentParameters();
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::UpdateComponentParameters()
+{
+  ParametersType rThetaParameters( 5 );
+  ParametersType phiParameters( 5 );
+  for( unsigned int i = 0; i < 5; i++ )
+    {
+    rThetaParameters[i] = this->m_Parameters[i];
+    }
+  phiParameters[0] = 0.0;
+  phiParameters[1] = this->m_Parameters[1] + vnl_math_abs( this->m_Parameters[5] );
+  phiParameters[2] = this->m_Parameters[6];
+  phiParameters[3] = this->m_Parameters[7];
+  phiParameters[4] = this->m_Parameters[8];
+  m_RThetaTransform->SetParameters( rThetaParameters );
+  m_PhiTransform->SetParameters( phiParameters );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetRmin( const double& Rmin )
+{
+  this->m_Parameters[0] = Rmin;
+  m_RThetaTransform->SetRmin( Rmin );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetRmax( const double& Rmax )
+{
+  this->m_Parameters[1] = Rmax;
+  m_RThetaTransform->SetRmax( Rmax );
+  m_PhiTransform->SetRmax( Rmax + vnl_math_abs( this->m_Parameters[5] ) );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetPhiRadius( const double& phiRadius )
+{
+  this->m_Parameters[5] = phiRadius;
+  if( this->m_Parameters[1] >= 0.0 )
+    {
+    m_PhiTransform->SetRmax( this->m_Parameters[1] + vnl_math_abs( phiRadius ) );
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetSpacingTheta( double spacing )
+{
+  m_SpacingTheta = spacing;
+  m_RThetaTransform->SetSpacingTheta( spacing );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetThetaArray( const itk::Array< double >& thetaArray )
+{
+  m_RThetaTransform->SetThetaArray( thetaArray );
+  for( unsigned int i = 2; i < 5; i++ )
+    {
+    this->m_Parameters[i] = m_RThetaTransform->GetParameters()[i];
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetSpacingPhi( double spacing )
+{
+  m_SpacingPhi = spacing;
+  m_PhiTransform->SetSpacingTheta( spacing );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetPhiArray( const itk::Array< double >& phiArray )
+{
+  if( this->m_Parameters[1] < 0.0 )
+    {
+    itkExceptionMacro( "SetRmax() must be called before SetPhiArray()." );
+    }
+  if( m_SpacingPhi == 0.0 )
+    {
+    itkExceptionMacro( "SetSpacingPhi() must be called before SetPhiArray()." );
+    }
+  m_PhiTransform->SetThetaArray( phiArray );
+  for( unsigned int i = 2; i < 5; i++ )
+    {
+    this->m_Parameters[i + 4] = m_PhiTransform->GetParameters()[i];
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::SetThetaTolerance( double tolerance )
+{
+  m_ThetaTolerance = tolerance;
+  m_RThetaTransform->SetThetaTolerance( tolerance );
+  m_PhiTransform->SetThetaTolerance( tolerance );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaPhiTransform< TScalarType, NDimensions>::OutputPointType
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformPoint( const InputPointType& inpoint ) const
+{
+  // Distance from the phi axis and phi, then r and theta in the frame.
+  const ScalarType phiRadius = this->m_Parameters[5];
+  InputPointType point = inpoint;
+  point[m_RDirection] += phiRadius;
+  point = m_PhiTransform->TransformPoint( point );
+  point[m_RDirection] -= phiRadius;
+  return m_RThetaTransform->TransformPoint( point );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformRThetaPhiCoordinates( const ScalarType * rCoordinates,
+  const ScalarType * thetaCoordinates,
+  const ScalarType * phiCoordinates,
+  ScalarType * rOutput,
+  ScalarType * thetaOutput,
+  ScalarType * phiOutput,
+  unsigned long numberOfPoints ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  const unsigned long blockSize = 256;
+  ScalarType shifted[blockSize];
+  ScalarType distance[blockSize];
+  for( unsigned long start = 0; start < numberOfPoints; start += blockSize )
+    {
+    const unsigned long count = vnl_math_min( blockSize, numberOfPoints - start );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      shifted[i] = rCoordinates[start + i] + phiRadius;
+      }
+    m_PhiTransform->TransformRThetaCoordinates( shifted, phiCoordinates + start,
+      distance, phiOutput + start, count );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      distance[i] -= phiRadius;
+      }
+    m_RThetaTransform->TransformRThetaCoordinates( distance, thetaCoordinates + start,
+      rOutput + start, thetaOutput + start, count );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformPoints( const InputPointType * inputPoints,
+  OutputPointType * outputPoints,
+  unsigned long numberOfPoints ) const
+{
+  // Transform in blocks so the coordinates stay in cache.
+  const unsigned long blockSize = 256;
+  ScalarType rCoordinates[blockSize];
+  ScalarType thetaCoordinates[blockSize];
+  ScalarType phiCoordinates[blockSize];
+  ScalarType rOutput[blockSize];
+  ScalarType thetaOutput[blockSize];
+  ScalarType phiOutput[blockSize];
+  for( unsigned long start = 0; start < numberOfPoints; start += blockSize )
+    {
+    const unsigned long count = vnl_math_min( blockSize, numberOfPoints - start );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      rCoordinates[i] = inputPoints[start + i][m_RDirection];
+      thetaCoordinates[i] = inputPoints[start + i][m_ThetaDirection];
+      phiCoordinates[i] = inputPoints[start + i][m_PhiDirection];
+      }
+    this->TransformRThetaPhiCoordinates( rCoordinates, thetaCoordinates, phiCoordinates,
+      rOutput, thetaOutput, phiOutput, count );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      outputPoints[start + i] = inputPoints[start + i];
+      outputPoints[start + i][m_RDirection] = rOutput[i];
+      outputPoints[start + i][m_ThetaDirection] = thetaOutput[i];
+      outputPoints[start + i][m_PhiDirection] = phiOutput[i];
+      }
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::ComputeJacobianWithRespectToPosition( const InputPointType & point,
+  SpatialJacobianType & jacobian ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  InputPointType shifted = point;
+  shifted[m_RDirection] += phiRadius;
+  InputPointType frame = m_PhiTransform->TransformPoint( shifted );
+  frame[m_RDirection] -= phiRadius;
+
+  SpatialJacobianType phiJacobian;
+  SpatialJacobianType rThetaJacobian;
+  m_PhiTransform->ComputeJacobianWithRespectToPosition( shifted, phiJacobian );
+  m_RThetaTransform->ComputeJacobianWithRespectToPosition( frame, rThetaJacobian );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      double sum = 0.0;
+      for( unsigned int k = 0; k < SpaceDimension; k++ )
+        {
+        sum += rThetaJacobian[i][k] * phiJacobian[k][j];
+        }
+      jacobian[i][j] = sum;
+      }
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+const typename CartesianToRThetaPhiTransform< TScalarType, NDimensions>::JacobianType &
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::GetJacobian( const InputPointType & point ) const
+{
+  this->m_Jacobian.Fill( 0.0 );
+
+  const ScalarType phiRadius = this->m_Parameters[5];
+  InputPointType shifted = point;
+  shifted[m_RDirection] += phiRadius;
+  InputPointType frame = m_PhiTransform->TransformPoint( shifted );
+  frame[m_RDirection] -= phiRadius;
+
+  SpatialJacobianType phiJacobian;
+  SpatialJacobianType rThetaJacobian;
+  m_PhiTransform->ComputeJacobianWithRespectToPosition( shifted, phiJacobian );
+  m_RThetaTransform->ComputeJacobianWithRespectToPosition( frame, rThetaJacobian );
+
+  // Rmin, ..., SpacingThetaOverDeltaTheta only enter the second component.
+  const JacobianType & rThetaParameterJacobian = m_RThetaTransform->GetJacobian( frame );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    for( unsigned int j = 0; j < 5; j++ )
+      {
+      this->m_Jacobian( i, j ) = rThetaParameterJacobian( i, j );
+      }
+    }
+
+  // PhiRadius shifts the input of the first component and its output back.
+  // Phimin and SpacingPhiOverDeltaPhi, columns 3 and 4 of the first
+  // component, are carried through the second.
+  const JacobianType & phiParameterJacobian = m_PhiTransform->GetJacobian( shifted );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    double dPhiRadius = 0.0;
+    double dPhimin = 0.0;
+    double dSpacingPhiOverDeltaPhi = 0.0;
+    for( unsigned int k = 0; k < SpaceDimension; k++ )
+      {
+      const double shift = phiJacobian[k][m_RDirection] - ( k == m_RDirection ? 1.0 : 0.0 );
+      dPhiRadius += rThetaJacobian[i][k] * shift;
+      dPhimin += rThetaJacobian[i][k] * phiParameterJacobian( k, 3 );
+      dSpacingPhiOverDeltaPhi += rThetaJacobian[i][k] * phiParameterJacobian( k, 4 );
+      }
+    this->m_Jacobian( i, 5 ) = dPhiRadius;
+    this->m_Jacobian( i, 7 ) = dPhimin;
+    this->m_Jacobian( i, 8 ) = dSpacingPhiOverDeltaPhi;
+    }
+
+  return this->m_Jacobian;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaPhiTransform< TScalarType, NDimensions>::OutputVectorType
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformVector( const InputVectorType & vector, const InputPointType & point ) const
+{
+  OutputVectorType output;
+  this->TransformVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaPhiTransform< TScalarType, NDimensions>::OutputCovariantVectorType
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformCovariantVector( const InputCovariantVectorType & vector, const InputPointType & point ) const
+{
+  OutputCovariantVectorType output;
+  this->TransformCovariantVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformVectors( const InputPointType * points,
+  const InputVectorType * vectors,
+  OutputVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    InputPointType shifted = points[i];
+    shifted[m_RDirection] += phiRadius;
+    InputPointType frame = m_PhiTransform->TransformPoint( shifted );
+    frame[m_RDirection] -= phiRadius;
+    outputVectors[i] = m_RThetaTransform->TransformVector(
+      m_PhiTransform->TransformVector( vectors[i], shifted ), frame );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::TransformCovariantVectors( const InputPointType * points,
+  const InputCovariantVectorType * vectors,
+  OutputCovariantVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  // The inverse transpose of a product is the product of the inverse
+  // transposes in the same order.
+  const ScalarType phiRadius = this->m_Parameters[5];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    InputPointType shifted = points[i];
+    shifted[m_RDirection] += phiRadius;
+    InputPointType frame = m_PhiTransform->TransformPoint( shifted );
+    frame[m_RDirection] -= phiRadius;
+    outputVectors[i] = m_RThetaTransform->TransformCovariantVector(
+      m_PhiTransform->TransformCovariantVector( vectors[i], shifted ), frame );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaPhiTransform< TScalarType, NDimensions>::InverseTransformBasePointer
+CartesianToRThetaPhiTransform< TScalarType, NDimensions >
+::GetInverseTransform() const
+{
+  typedef itk::RThetaPhiToCartesianTransform< TScalarType, NDimensions > InverseType;
+  typename InverseType::Pointer inverse = InverseType::New();
+
+  inverse->SetRDirection( m_RDirection );
+  inverse->SetThetaDirection( m_ThetaDirection );
+  inverse->SetPhiDirection( m_PhiDirection );
+  inverse->SetSpacingTheta( m_SpacingTheta );
+  inverse->SetSpacingPhi( m_SpacingPhi );
+  inverse->SetParameters( this->GetParameters() );
+  if( this->GetThetaArray().Size() > 1 )
+    {
+    inverse->SetThetaArray( this->GetThetaArray() );
+    }
+  if( this->GetPhiArray().Size() > 1 )
+    {
+    inverse->SetPhiArray( this->GetPhiArray() );
+    }
+
+  return inverse.GetPointer();
+}
+
+
+}
+
+#endif // __itkCartesianToRThetaPhiTransform_txx
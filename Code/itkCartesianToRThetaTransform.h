@@ -1,8 +1,13 @@
 #ifndef __itkCartesianToRThetaTransform_h
 #define __itkCartesianToRThetaTransform_h
 
+#include "itkMatrix.h"
 #include "itkTransform.h"
 
+#include "itkCartesianToRThetaKernel.h"
+
+#include <vector>
+
 namespace itk
 {
 
@@ -102,11 +107,35 @@ public:
   /**  Method to transform a point. */
   virtual OutputPointType TransformPoint(const InputPointType  &point ) const;
 
+  /** Transform numberOfPoints points at once.  Uses the vectorized kernel and
+   * the ThetaTolerance. */
+  virtual void TransformPoints( const InputPointType * inputPoints,
+    OutputPointType * outputPoints,
+    unsigned long numberOfPoints ) const;
+
+  /** Transform a scanline of points whose coordinates in the RDirection and
+   * the ThetaDirection are stored in separate arrays.  The outputs are the
+   * RDirection and ThetaDirection components that TransformPoint() would
+   * compute.  This is the fastest way to transform many points; it uses
+   * SSE2 / AVX when the compiler enables them. */
+  virtual void TransformRThetaCoordinates( const ScalarType * rCoordinates,
+    const ScalarType * thetaCoordinates,
+    ScalarType * rOutput,
+    ScalarType * thetaOutput,
+    unsigned long numberOfPoints ) const;
+
+  /** Derivative of the output point with respect to the input point,
+   * jacobian[i][j] = d T_i / d x_j. */
+  typedef Matrix< TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension),
+                  itkGetStaticConstMacro(SpaceDimension) > SpatialJacobianType;
+
   /** Method to transform a vector - 
-   *  not applicable for this type of transform. */
+   *  not applicable for this type of transform, since the result depends on
+   *  where the vector is.  Use TransformVector( vector, point ). */
   virtual OutputVectorType TransformVector(const InputVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transform." );
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point )." );
     return OutputVectorType(); 
     }
 
@@ -114,24 +143,57 @@ public:
    *  not applicable for this type of transform */
   virtual OutputVnlVectorType TransformVector(const InputVnlVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transform. ");
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point ).");
     return OutputVnlVectorType(); 
     }
 
   /** Method to transform a CovariantVector - 
-   *  not applicable for this type of transform */
+   *  not applicable for this type of transform.  Use
+   *  TransformCovariantVector( vector, point ). */
   virtual OutputCovariantVectorType TransformCovariantVector(
     const InputCovariantVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transfrom. ");
+    itkExceptionMacro(<< "Method not applicable for deformable transfrom.  Use TransformCovariantVector( vector, point ).");
     return OutputCovariantVectorType(); 
     } 
 
-  virtual const JacobianType & GetJacobian( const InputPointType & point ) const
-    {
-    itkExceptionMacro(<< "GetJacobian has not been implemented yet.");
-    return this->m_Jacobian;
-    }
+  /** Transform a vector, e.g. a displacement, located at point:
+   * ComputeJacobianWithRespectToPosition( point ) * vector. */
+  virtual OutputVectorType TransformVector( const InputVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform a covariant vector, e.g. a gradient, located at point: the
+   * inverse transpose of ComputeJacobianWithRespectToPosition( point ) times
+   * vector. */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform numberOfVectors vectors, each located at the corresponding
+   * point.  Equivalent to TransformVector( vectors[i], points[i] ). */
+  virtual void TransformVectors( const InputPointType * points,
+    const InputVectorType * vectors,
+    OutputVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Transform numberOfVectors covariant vectors, each located at the
+   * corresponding point. */
+  virtual void TransformCovariantVectors( const InputPointType * points,
+    const InputCovariantVectorType * vectors,
+    OutputCovariantVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Derivative of the output point with respect to the Parameters at
+   * point.  Only Rmin, and for a linearly mapped ThetaArray Thetamin and
+   * SpacingThetaOverDeltaTheta, enter the transform; the other columns are
+   * zero. */
+  virtual const JacobianType & GetJacobian( const InputPointType & point ) const;
+
+  /** Derivative of the output point with respect to the input point.  The
+   * directions other than RDirection and ThetaDirection are passed
+   * through. */
+  virtual void ComputeJacobianWithRespectToPosition( const InputPointType & point,
+    SpatialJacobianType & jacobian ) const;
 
   /** Indicates that this transform is linear. That is, given two
    * points P and Q, and scalar coefficients a and b, then
@@ -206,6 +268,67 @@ public:
    *	calling this method.  SetSpacingTheta() and SetRmin() SetRmax() must be called before this. */
   virtual void SetThetaArray( const itk::Array< double >& theta );
 
+  itkGetConstReferenceMacro( ThetaArray, itk::Array< double > );
+
+  /** ThetaArrayIsUniform
+   *	Whether every angle of the ThetaArray is within a thousandth of a step
+   *	of Thetamin + i * DeltaTheta, i.e. whether the linear mapping of theta
+   *	to the ThetaDirection is exact.  Set by SetThetaArray().  Callers may
+   *	exploit the structure of uniform arrays, e.g. with a separable
+   *	evaluation of the transform on a regular grid.
+   *
+   *	A non-uniform, strictly monotonic array is inverted exactly: an angle
+   *	maps to its fractional line index, interpolated linearly between the
+   *	two neighboring lines, times SpacingTheta.  A precomputed table gives
+   *	the first line of every angle bucket.  The buckets are as wide as the
+   *	narrowest line step, but no narrower than a sixteenth of the mean
+   *	step, so that the table has at most 16 entries per line.  The lookup
+   *	is constant time when the narrowest step is at least a sixteenth of
+   *	the mean step; for more irregular arrays it walks the lines of one
+   *	bucket.
+   *	*/
+  itkGetConstMacro( ThetaArrayIsUniform, bool );
+
+  /** ThetaTolerance
+   *	Maximum error of the angle computed by TransformPoints() and
+   *	TransformRThetaCoordinates(), as a fraction of the step between lines,
+   *	DeltaTheta.  The transformed ThetaDirection coordinate is then off by
+   *	at most ThetaTolerance * SpacingTheta, i.e. ThetaTolerance of an input
+   *	pixel.  With a 0.5 degree line step, a tolerance of 0.01 allows 8.7e-5
+   *	radians and selects a 4th order polynomial arc tangent.  0, the
+   *	default, uses the exact vcl_atan.  TransformPoint() is always exact.
+   *	*/
+  itkSetMacro( ThetaTolerance, double );
+  itkGetConstMacro( ThetaTolerance, double );
+
+  /** Polynomial order of the arc tangent that meets the ThetaTolerance, 0
+   * for the exact arc tangent.  See CartesianToRThetaKernel. */
+  unsigned int GetArcTangentOrder() const
+    {
+    return this->GetArcTangentOrder( m_ThetaTolerance );
+    }
+
+  /** Polynomial order of the arc tangent that meets thetaTolerance instead
+   * of the ThetaTolerance, for callers that share the transform. */
+  unsigned int GetArcTangentOrder( double thetaTolerance ) const;
+
+  /** Whether the ThetaDirection coordinate is computed with
+   * ThetaToContinuousIndex() instead of the linear mapping, i.e. whether the
+   * ThetaArray is non-uniform and strictly monotonic. */
+  bool GetUseThetaIndexTable() const
+    {
+    return !m_ThetaIndexTable.empty();
+    }
+
+  /** Fractional index of theta in a non-uniform ThetaArray.  Only valid
+   * when GetUseThetaIndexTable() is true. */
+  double ThetaToContinuousIndex( double theta ) const;
+
+  /** Derivative of the ThetaDirection coordinate with respect to theta:
+   * SpacingThetaOverDeltaTheta for the linear mapping, or SpacingTheta over
+   * the step of the ThetaArray segment that contains theta. */
+  double GetThetaCoordinateDerivative( double theta ) const;
+
   /** = Rmax * sin( max | theta | ).  Corresponds to the Location of the origin
    * in the ThetaDirection.  */ 
   itkGetConstMacro( RmaxsinThetamin, ScalarType );
@@ -218,11 +341,25 @@ protected:
   CartesianToRThetaTransform();
   ~CartesianToRThetaTransform() {}
 
+  /** Segment of the non-uniform ThetaArray, from line to line + 1, that
+   * contains t = ThetaSign * theta, or the first or last segment. */
+  unsigned int FindThetaSegment( double t ) const;
+
   unsigned int m_RDirection;
   unsigned int m_ThetaDirection;
   double m_SpacingTheta;
+  double m_ThetaTolerance;
 
   itk::Array< double > m_ThetaArray;
+  bool                 m_ThetaArrayIsUniform;
+
+  /** For every bucket of ThetaSign * theta, the first line whose angle is in
+   * or below it.  Empty when the linear mapping is used. */
+  std::vector< unsigned int > m_ThetaIndexTable;
+  double                      m_ThetaIndexTableOrigin;
+  double                      m_ThetaIndexTableScale;
+  double                      m_ThetaSign;
+  double                      m_MinimumDeltaTheta;
 
   // we have these ase member variable so they only have to be calculated once
   ScalarType m_RmaxsinThetamin;
@@ -16,7 +16,13 @@ CartesianToRThetaTransform< TScalarType, NDimensions >
   Superclass( SpaceDimension, 5 ),
   m_RDirection( 0 ),
   m_ThetaDirection( 1 ),
-  m_SpacingTheta( 0.0 )
+  m_SpacingTheta( 0.0 ),
+  m_ThetaTolerance( 0.0 ),
+  m_ThetaArrayIsUniform( true ),
+  m_ThetaIndexTableOrigin( 0.0 ),
+  m_ThetaIndexTableScale( 0.0 ),
+  m_ThetaSign( 1.0 ),
+  m_MinimumDeltaTheta( 0.0 )
 {
   // Rmin invalid value to make sure it gets set
   this->m_Parameters[0] = -1.0;
@@ -54,7 +60,123 @@ CartesianToRThetaTransform< TScalarType, NDimensions >
     }
 
   // SpacingThetaOverDeltaTheta
-  this->m_Parameters[4] = m_SpacingTheta / ( thetaArray[1] - thetaArray[0] ) ;
+  const double deltaTheta = thetaArray[1] - thetaArray[0];
+  this->m_Parameters[4] = m_SpacingTheta / deltaTheta;
+
+  m_ThetaArray = thetaArray;
+  m_ThetaArrayIsUniform = true;
+  const double uniformTolerance = 1.0e-3 * vnl_math_abs( deltaTheta );
+  for( unsigned int i = 2; i < thetaArray.Size(); i++ )
+    {
+    if( vnl_math_abs( thetaArray[i] - ( thetaArray[0] + i * deltaTheta ) ) > uniformTolerance )
+      {
+      m_ThetaArrayIsUniform = false;
+      break;
+      }
+    }
+
+  // Inverse table for non-uniform arrays.  Working with ThetaSign * theta
+  // makes a decreasing array increasing without reordering the lines.
+  m_ThetaIndexTable.clear();
+  m_MinimumDeltaTheta = vnl_math_abs( deltaTheta );
+  if( !m_ThetaArrayIsUniform )
+    {
+    const unsigned int lines = thetaArray.Size();
+    m_ThetaSign = deltaTheta < 0.0 ? -1.0 : 1.0;
+    bool monotonic = true;
+    double minimumDeltaTheta = m_MinimumDeltaTheta;
+    for( unsigned int i = 0; i + 1 < lines; i++ )
+      {
+      const double step = m_ThetaSign * ( thetaArray[i + 1] - thetaArray[i] );
+      if( step <= 0.0 )
+        {
+        monotonic = false;
+        break;
+        }
+      minimumDeltaTheta = vnl_math_min( minimumDeltaTheta, step );
+      }
+    if( !monotonic )
+      {
+      itkWarningMacro( "The Theta array is not strictly monotonic; its angles are mapped linearly." );
+      }
+    else
+      {
+      m_MinimumDeltaTheta = minimumDeltaTheta;
+      const double first = m_ThetaSign * thetaArray[0];
+      const double range = m_ThetaSign * thetaArray[lines - 1] - first;
+      // Buckets no wider than the narrowest step hold at most one line, but
+      // their number is limited to 16 per line.
+      const double bucketWidth = vnl_math_max( m_MinimumDeltaTheta, range / ( 16.0 * lines ) );
+      const unsigned int buckets = static_cast< unsigned int >( vcl_ceil( range / bucketWidth ) ) + 1;
+      m_ThetaIndexTable.resize( buckets );
+      m_ThetaIndexTableOrigin = first;
+      m_ThetaIndexTableScale = 1.0 / bucketWidth;
+      unsigned int line = 0;
+      for( unsigned int bucket = 0; bucket < buckets; bucket++ )
+        {
+        const double bucketStart = first + bucket * bucketWidth;
+        while( line + 2 < lines && m_ThetaSign * thetaArray[line + 1] <= bucketStart )
+          {
+          ++line;
+          }
+        m_ThetaIndexTable[bucket] = line;
+        }
+      }
+    }
+
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned int
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::FindThetaSegment( double t ) const
+{
+  const unsigned int lastSegment = m_ThetaArray.Size() - 2;
+  // Outside of the array the first and last steps are extrapolated.
+  unsigned int line = 0;
+  const double position = ( t - m_ThetaIndexTableOrigin ) * m_ThetaIndexTableScale;
+  if( position >= m_ThetaIndexTable.size() )
+    {
+    line = lastSegment;
+    }
+  else if( position > 0.0 )
+    {
+    line = m_ThetaIndexTable[ static_cast< unsigned int >( position ) ];
+    while( line < lastSegment && t >= m_ThetaSign * m_ThetaArray[line + 1] )
+      {
+      ++line;
+      }
+    }
+  return line;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+double
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::ThetaToContinuousIndex( double theta ) const
+{
+  const double t = m_ThetaSign * theta;
+  const unsigned int line = this->FindThetaSegment( t );
+  const double lower = m_ThetaSign * m_ThetaArray[line];
+  const double upper = m_ThetaSign * m_ThetaArray[line + 1];
+  return line + ( t - lower ) / ( upper - lower );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+double
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::GetThetaCoordinateDerivative( double theta ) const
+{
+  if( m_ThetaIndexTable.empty() )
+    {
+    return this->m_Parameters[4];
+    }
+  const unsigned int line = this->FindThetaSegment( m_ThetaSign * theta );
+  return m_SpacingTheta / ( m_ThetaArray[line + 1] - m_ThetaArray[line] );
 }
 
 
@@ -76,12 +198,232 @@ CartesianToRThetaTransform< TScalarType, NDimensions >
   );
 
   outpoint[m_RDirection] = r - this->m_Parameters[0];
-  outpoint[m_ThetaDirection] = ( theta - this->m_Parameters[3] ) * this->m_Parameters[4] ;
+  if( m_ThetaIndexTable.empty() )
+    {
+    outpoint[m_ThetaDirection] = ( theta - this->m_Parameters[3] ) * this->m_Parameters[4] ;
+    }
+  else
+    {
+    outpoint[m_ThetaDirection] = this->ThetaToContinuousIndex( theta ) * m_SpacingTheta;
+    }
 
   return outpoint;
 }
 
 
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::ComputeJacobianWithRespectToPosition( const InputPointType & point,
+  SpatialJacobianType & jacobian ) const
+{
+  // r = sqrt( x^2 + y^2 ) and theta = atan( y / x ), so
+  // dr = ( x dx + y dy ) / r and dtheta = ( x dy - y dx ) / r^2.
+  const double x = point[m_RDirection];
+  const double y = point[m_ThetaDirection];
+  const double rSquared = x * x + y * y;
+  const double r = vcl_sqrt( rSquared );
+  const double thetaScale = this->GetThetaCoordinateDerivative( vcl_atan( y / x ) ) / rSquared;
+
+  jacobian.SetIdentity();
+  jacobian[m_RDirection][m_RDirection] = x / r;
+  jacobian[m_RDirection][m_ThetaDirection] = y / r;
+  jacobian[m_ThetaDirection][m_RDirection] = -y * thetaScale;
+  jacobian[m_ThetaDirection][m_ThetaDirection] = x * thetaScale;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+const typename CartesianToRThetaTransform< TScalarType, NDimensions>::JacobianType &
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::GetJacobian( const InputPointType & point ) const
+{
+  this->m_Jacobian.Fill( 0.0 );
+
+  // The radius coordinate is r - Rmin.
+  this->m_Jacobian( m_RDirection, 0 ) = -1.0;
+
+  // The linear mapping is ( theta - Thetamin ) * SpacingThetaOverDeltaTheta.
+  // The table of a non-uniform array does not use the Parameters.
+  if( m_ThetaIndexTable.empty() )
+    {
+    const double theta = vcl_atan( point[m_ThetaDirection] / point[m_RDirection] );
+    this->m_Jacobian( m_ThetaDirection, 3 ) = -this->m_Parameters[4];
+    this->m_Jacobian( m_ThetaDirection, 4 ) = theta - this->m_Parameters[3];
+    }
+
+  return this->m_Jacobian;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaTransform< TScalarType, NDimensions>::OutputVectorType
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformVector( const InputVectorType & vector, const InputPointType & point ) const
+{
+  OutputVectorType output;
+  this->TransformVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename CartesianToRThetaTransform< TScalarType, NDimensions>::OutputCovariantVectorType
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformCovariantVector( const InputCovariantVectorType & vector, const InputPointType & point ) const
+{
+  OutputCovariantVectorType output;
+  this->TransformCovariantVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformVectors( const InputPointType * points,
+  const InputVectorType * vectors,
+  OutputVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const bool linear = m_ThetaIndexTable.empty();
+  const double spacingThetaOverDeltaTheta = this->m_Parameters[4];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    const double x = points[i][rDirection];
+    const double y = points[i][thetaDirection];
+    const double vx = vectors[i][rDirection];
+    const double vy = vectors[i][thetaDirection];
+    const double rSquared = x * x + y * y;
+    const double thetaScale = linear ? spacingThetaOverDeltaTheta :
+      this->GetThetaCoordinateDerivative( vcl_atan( y / x ) );
+    OutputVectorType & output = outputVectors[i];
+    for( unsigned int d = 0; d < SpaceDimension; d++ )
+      {
+      output[d] = vectors[i][d];
+      }
+    output[rDirection] = ( x * vx + y * vy ) / vcl_sqrt( rSquared );
+    output[thetaDirection] = ( x * vy - y * vx ) * thetaScale / rSquared;
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformCovariantVectors( const InputPointType * points,
+  const InputCovariantVectorType * vectors,
+  OutputCovariantVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  // The inverse transpose of the Jacobian, see
+  // ComputeJacobianWithRespectToPosition(), is
+  //   [  x / r          y / r          ]
+  //   [ -y / thetaScale  x / thetaScale ].
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const bool linear = m_ThetaIndexTable.empty();
+  const double spacingThetaOverDeltaTheta = this->m_Parameters[4];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    const double x = points[i][rDirection];
+    const double y = points[i][thetaDirection];
+    const double gx = vectors[i][rDirection];
+    const double gy = vectors[i][thetaDirection];
+    const double thetaScale = linear ? spacingThetaOverDeltaTheta :
+      this->GetThetaCoordinateDerivative( vcl_atan( y / x ) );
+    OutputCovariantVectorType & output = outputVectors[i];
+    for( unsigned int d = 0; d < SpaceDimension; d++ )
+      {
+      output[d] = vectors[i][d];
+      }
+    output[rDirection] = ( x * gx + y * gy ) / vcl_sqrt( x * x + y * y );
+    output[thetaDirection] = ( x * gy - y * gx ) / thetaScale;
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned int
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::GetArcTangentOrder( double thetaTolerance ) const
+{
+  if( thetaTolerance <= 0.0 || this->m_Parameters[4] == 0.0 )
+    {
+    return 0;
+    }
+  // The narrowest step between lines, i.e. SpacingTheta /
+  // SpacingThetaOverDeltaTheta for a uniform array.
+  return CartesianToRThetaKernel< TScalarType >::SelectArcTangentOrder( thetaTolerance * m_MinimumDeltaTheta );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformRThetaCoordinates( const ScalarType * rCoordinates,
+  const ScalarType * thetaCoordinates,
+  ScalarType * rOutput,
+  ScalarType * thetaOutput,
+  unsigned long numberOfPoints ) const
+{
+  if( m_ThetaIndexTable.empty() )
+    {
+    CartesianToRThetaKernel< TScalarType >::Evaluate( rCoordinates, thetaCoordinates,
+      rOutput, thetaOutput, numberOfPoints, this->GetArcTangentOrder(),
+      static_cast< ScalarType >( this->m_Parameters[0] ),
+      static_cast< ScalarType >( this->m_Parameters[3] ),
+      static_cast< ScalarType >( this->m_Parameters[4] ) );
+    return;
+    }
+
+  // Compute the angles, then map them through the non-uniform array.
+  CartesianToRThetaKernel< TScalarType >::Evaluate( rCoordinates, thetaCoordinates,
+    rOutput, thetaOutput, numberOfPoints, this->GetArcTangentOrder(),
+    static_cast< ScalarType >( this->m_Parameters[0] ),
+    static_cast< ScalarType >( 0.0 ),
+    static_cast< ScalarType >( 1.0 ) );
+  for( unsigned long i = 0; i < numberOfPoints; i++ )
+    {
+    thetaOutput[i] = static_cast< ScalarType >( this->ThetaToContinuousIndex( thetaOutput[i] ) * m_SpacingTheta );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+CartesianToRThetaTransform< TScalarType, NDimensions >
+::TransformPoints( const InputPointType * inputPoints,
+  OutputPointType * outputPoints,
+  unsigned long numberOfPoints ) const
+{
+  // Transform in blocks so the coordinates stay in cache.
+  const unsigned long blockSize = 256;
+  ScalarType rCoordinates[blockSize];
+  ScalarType thetaCoordinates[blockSize];
+  ScalarType rOutput[blockSize];
+  ScalarType thetaOutput[blockSize];
+  for( unsigned long start = 0; start < numberOfPoints; start += blockSize )
+    {
+    const unsigned long count = vnl_math_min( blockSize, numberOfPoints - start );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      rCoordinates[i] = inputPoints[start + i][m_RDirection];
+      thetaCoordinates[i] = inputPoints[start + i][m_ThetaDirection];
+      }
+    this->TransformRThetaCoordinates( rCoordinates, thetaCoordinates, rOutput, thetaOutput, count );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      outputPoints[start + i] = inputPoints[start + i];
+      outputPoints[start + i][m_RDirection] = rOutput[i];
+      outputPoints[start + i][m_ThetaDirection] = thetaOutput[i];
+      }
+    }
+}
+
+
 template < class TScalarType, unsigned int NDimensions >
 typename CartesianToRThetaTransform< TScalarType, NDimensions>::InverseTransformBasePointer
 CartesianToRThetaTransform< TScalarType, NDimensions >
@@ -94,6 +436,10 @@ CartesianToRThetaTransform< TScalarType, NDimensions >
   inverse->SetThetaDirection( m_ThetaDirection );
   inverse->SetSpacingTheta( m_SpacingTheta );
   inverse->SetParameters( this->GetParameters() );
+  if( m_ThetaArray.Size() > 1 )
+    {
+    inverse->SetThetaArray( m_ThetaArray );
+    }
 
   return inverse.GetPointer();
 }
@@ -0,0 +1,132 @@
+#ifndef __itkLogCompressionFunctor_h
+#define __itkLogCompressionFunctor_h
+
+#include "itkNumericTraits.h"
+
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+namespace Functor
+{
+
+/** @brief B-mode log compression of an envelope sample.
+ *
+ * The magnitude of the input, e.g. the envelope of an RF line or the
+ * magnitude of IQ data, is expressed in decibels relative to the
+ * ReferenceLevel, and the DynamicRange below it is mapped linearly onto
+ * [OutputMinimum, OutputMaximum].  Magnitudes below the range give the
+ * OutputMinimum and above the ReferenceLevel the OutputMaximum.  Negative
+ * inputs are rectified.
+ *
+ * The defaults are a DynamicRange of 60 dB, a ReferenceLevel of the largest
+ * value of an integer input type or 1 otherwise, and an output range of
+ * [0, 255].
+ */
+template < class TInput, class TOutput = double >
+class LogCompression
+{
+public:
+  LogCompression():
+    m_DynamicRange( 60.0 ),
+    m_ReferenceLevel( NumericTraits< TInput >::is_integer ?
+      static_cast< double >( NumericTraits< TInput >::max() ) : 1.0 ),
+    m_OutputMinimum( 0.0 ),
+    m_OutputMaximum( 255.0 )
+  {
+    this->ComputeConstants();
+  }
+
+  /** Range of decibels below the ReferenceLevel that is displayed. */
+  void SetDynamicRange( double dynamicRange )
+    {
+    m_DynamicRange = dynamicRange;
+    this->ComputeConstants();
+    }
+  double GetDynamicRange() const
+    {
+    return m_DynamicRange;
+    }
+
+  /** Magnitude that is mapped to the OutputMaximum. */
+  void SetReferenceLevel( double referenceLevel )
+    {
+    m_ReferenceLevel = referenceLevel;
+    this->ComputeConstants();
+    }
+  double GetReferenceLevel() const
+    {
+    return m_ReferenceLevel;
+    }
+
+  /** Output of a magnitude at the bottom and at the top of the
+   * DynamicRange. */
+  void SetOutputMinimum( double outputMinimum )
+    {
+    m_OutputMinimum = outputMinimum;
+    this->ComputeConstants();
+    }
+  double GetOutputMinimum() const
+    {
+    return m_OutputMinimum;
+    }
+  void SetOutputMaximum( double outputMaximum )
+    {
+    m_OutputMaximum = outputMaximum;
+    this->ComputeConstants();
+    }
+  double GetOutputMaximum() const
+    {
+    return m_OutputMaximum;
+    }
+
+  bool operator!=( const LogCompression & other ) const
+    {
+    return m_DynamicRange != other.m_DynamicRange ||
+      m_ReferenceLevel != other.m_ReferenceLevel ||
+      m_OutputMinimum != other.m_OutputMinimum ||
+      m_OutputMaximum != other.m_OutputMaximum;
+    }
+  bool operator==( const LogCompression & other ) const
+    {
+    return !( *this != other );
+    }
+
+  inline TOutput operator()( const TInput & value ) const
+    {
+    const double magnitude = vnl_math_abs( static_cast< double >( value ) );
+    if( magnitude <= m_FloorLevel )
+      {
+      return static_cast< TOutput >( m_OutputMinimum );
+      }
+    if( magnitude >= m_ReferenceLevel )
+      {
+      return static_cast< TOutput >( m_OutputMaximum );
+      }
+    return static_cast< TOutput >( m_Scale * vcl_log( magnitude ) + m_Offset );
+    }
+
+private:
+  /** The output is m_Scale * ln( magnitude ) + m_Offset above the magnitude
+   * m_FloorLevel at the bottom of the DynamicRange. */
+  void ComputeConstants()
+    {
+    m_FloorLevel = m_ReferenceLevel * vcl_pow( 10.0, -m_DynamicRange / 20.0 );
+    m_Scale = ( m_OutputMaximum - m_OutputMinimum ) * 20.0 / ( m_DynamicRange * vnl_math::ln10 );
+    m_Offset = m_OutputMaximum - m_Scale * vcl_log( m_ReferenceLevel );
+    }
+
+  double m_DynamicRange;
+  double m_ReferenceLevel;
+  double m_OutputMinimum;
+  double m_OutputMaximum;
+
+  double m_FloorLevel;
+  double m_Scale;
+  double m_Offset;
+};
+
+} // end namespace Functor
+} // end namespace itk
+
+#endif // __itkLogCompressionFunctor_h
@@ -0,0 +1,184 @@
+#ifndef __itkRThetaImportImageFilter_h
+#define __itkRThetaImportImageFilter_h
+
+#include "itkImageSource.h"
+#include "itkArray.h"
+
+namespace itk
+{
+
+/** @brief Wrap an (R, Theta) frame buffer owned by the caller, e.g. a
+ * scanner's DMA buffer, in an image without copying it.
+ *
+ *  Properties:
+ *  ImportPointer
+ *    The first sample of the frame.  The output image reads it in place, so
+ *    it must stay valid and unchanged while any image refers to it.  The
+ *    optional release callback is called once the importer and every image
+ *    have dropped the buffer, i.e. after a new ImportPointer was set and the
+ *    output was updated or destroyed.
+ *
+ *  Size, Strides
+ *    The number of samples and the distance in samples between neighbors
+ *    along R (axis 0), Theta (axis 1), and the pass through axes (2 and up,
+ *    e.g. slices), in that order.  Strides of 0, the default, store R
+ *    fastest, then Theta, then the pass through axes.  The output image
+ *    stores the axes in the order of increasing stride, so GetRDirection()
+ *    and GetThetaDirection() give the directions that
+ *    ResampleRThetaToCartesianImageFilter and the live converter must be
+ *    set to.  The strides must describe a dense buffer: an image has no
+ *    line pitch, so lines that are padded cannot be imported.
+ *
+ *  Spacing, Origin
+ *    Also in the order R, Theta, and the pass through axes.  The R spacing
+ *    is the distance between samples along a line.
+ *
+ *  Radius, Theta
+ *    The radius of the first sample and the angle of every line.  They are
+ *    stored in the output's MetaDataDictionary as "Radius" and "Theta".
+ *
+ * Together with ResampleRThetaToCartesianImageFilter::SetOutputBuffer(),
+ * a frame is converted from the caller's input buffer into the caller's
+ * output buffer with no allocation or copy.
+ */
+template < class TOutputImage >
+class ITK_EXPORT RThetaImportImageFilter :
+  public ImageSource< TOutputImage >
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef RThetaImportImageFilter Self;
+
+  /** Standard super class typedef support. */
+  typedef ImageSource< TOutputImage > Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( RThetaImportImageFilter, ImageSource );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the image. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TOutputImage::ImageDimension );
+
+  typedef TOutputImage                              OutputImageType;
+  typedef typename OutputImageType::PixelType       PixelType;
+  typedef typename OutputImageType::SizeType        SizeType;
+  typedef typename OutputImageType::OffsetType      StridesType;
+  typedef typename OutputImageType::SpacingType     SpacingType;
+  typedef typename OutputImageType::PointType       OriginType;
+  typedef typename OutputImageType::PixelContainer  PixelContainerType;
+
+  /** Called with the imported buffer and the client data once nothing
+   * refers to the buffer anymore. */
+  typedef void ( *ReleaseCallbackType )( const PixelType * buffer, void * clientData );
+
+  /** Import buffer, to be released through callback, if any.  The
+   * previous buffer is released when the output no longer refers to it. */
+  void SetImportPointer( const PixelType * buffer,
+    ReleaseCallbackType callback = NULL,
+    void * clientData = NULL );
+  const PixelType * GetImportPointer() const;
+
+  itkSetMacro( Size, SizeType );
+  itkGetConstReferenceMacro( Size, SizeType );
+
+  itkSetMacro( Strides, StridesType );
+  itkGetConstReferenceMacro( Strides, StridesType );
+
+  itkSetMacro( Spacing, SpacingType );
+  itkGetConstReferenceMacro( Spacing, SpacingType );
+
+  itkSetMacro( Origin, OriginType );
+  itkGetConstReferenceMacro( Origin, OriginType );
+
+  itkSetMacro( Radius, double );
+  itkGetConstMacro( Radius, double );
+
+  void SetTheta( const Array< double > & theta )
+    {
+    m_Theta = theta;
+    this->Modified();
+    }
+  itkGetConstReferenceMacro( Theta, Array< double > );
+
+  /** The directions of R and Theta in the output image, given the
+   * strides. */
+  unsigned int GetRDirection() const;
+  unsigned int GetThetaDirection() const;
+
+protected:
+  RThetaImportImageFilter();
+  ~RThetaImportImageFilter() {}
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Standard process object methods.  The output is always the whole
+   * buffer. */
+  virtual void GenerateOutputInformation();
+  virtual void EnlargeOutputRequestedRegion( DataObject * output );
+  virtual void GenerateData();
+
+  /** Image axis of every buffer axis: the rank of its stride.  Throws if
+   * the strides do not describe a dense buffer of Size. */
+  void ComputeAxisOrder( unsigned int axes[] ) const;
+
+  /** Pixel container that calls the release callback when it is
+   * destroyed, i.e. when neither the importer nor an image refers to it. */
+  class ImportedPixelContainer : public PixelContainerType
+    {
+  public:
+    typedef ImportedPixelContainer Self;
+    typedef SmartPointer< Self >   Pointer;
+
+    itkNewMacro( Self );
+
+    void SetReleaseCallback( ReleaseCallbackType callback, void * clientData )
+      {
+      m_ReleaseCallback = callback;
+      m_ClientData = clientData;
+      }
+
+  protected:
+    ImportedPixelContainer():
+      m_ReleaseCallback( NULL ),
+      m_ClientData( NULL )
+      {}
+    ~ImportedPixelContainer()
+      {
+      if( m_ReleaseCallback != NULL )
+        {
+        ( *m_ReleaseCallback )( this->GetImportPointer(), m_ClientData );
+        }
+      }
+
+  private:
+    ReleaseCallbackType m_ReleaseCallback;
+    void *              m_ClientData;
+    };
+
+private:
+  RThetaImportImageFilter( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+  typename ImportedPixelContainer::Pointer m_ImportContainer;
+
+  SizeType        m_Size;
+  StridesType     m_Strides;
+  SpacingType     m_Spacing;
+  OriginType      m_Origin;
+  double          m_Radius;
+  Array< double > m_Theta;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRThetaImportImageFilter.txx"
+#endif
+
+#endif // __itkRThetaImportImageFilter_h
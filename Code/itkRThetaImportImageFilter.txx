@@ -0,0 +1,202 @@
+#ifndef __itkRThetaImportImageFilter_txx
+#define __itkRThetaImportImageFilter_txx
+
+#include "itkRThetaImportImageFilter.h"
+
+#include "itkMetaDataObject.h"
+
+namespace itk
+{
+
+template < class TOutputImage >
+RThetaImportImageFilter< TOutputImage >
+::RThetaImportImageFilter():
+  m_Radius( 0.0 )
+{
+  m_Size.Fill( 0 );
+  m_Strides.Fill( 0 );
+  m_Spacing.Fill( 1.0 );
+  m_Origin.Fill( 0.0 );
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::SetImportPointer( const PixelType * buffer,
+  ReleaseCallbackType callback,
+  void * clientData )
+{
+  // Every buffer gets its own container, so that the previous one is
+  // released only when the output drops it.
+  m_ImportContainer = ImportedPixelContainer::New();
+  m_ImportContainer->SetImportPointer( const_cast< PixelType * >( buffer ), 0, false );
+  m_ImportContainer->SetReleaseCallback( callback, clientData );
+  this->Modified();
+}
+
+
+template < class TOutputImage >
+const typename RThetaImportImageFilter< TOutputImage >::PixelType *
+RThetaImportImageFilter< TOutputImage >
+::GetImportPointer() const
+{
+  return m_ImportContainer.IsNull() ? NULL : m_ImportContainer->GetImportPointer();
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::ComputeAxisOrder( unsigned int axes[] ) const
+{
+  bool defaultStrides = true;
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    defaultStrides = defaultStrides && m_Strides[i] == 0;
+    }
+  if( defaultStrides )
+    {
+    for( unsigned int i = 0; i < ImageDimension; i++ )
+      {
+      axes[i] = i;
+      }
+    return;
+    }
+
+  // Rank the strides; equal strides, of axes of size 1, keep their order.
+  unsigned int order[ImageDimension];
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    axes[i] = 0;
+    for( unsigned int j = 0; j < ImageDimension; j++ )
+      {
+      if( m_Strides[j] < m_Strides[i] || ( m_Strides[j] == m_Strides[i] && j < i ) )
+        {
+        axes[i]++;
+        }
+      }
+    order[axes[i]] = i;
+    }
+
+  long stride = 1;
+  for( unsigned int rank = 0; rank < ImageDimension; rank++ )
+    {
+    const unsigned int axis = order[rank];
+    if( m_Strides[axis] != stride )
+      {
+      itkExceptionMacro( "The strides " << m_Strides << " do not describe a dense buffer of size "
+        << m_Size << "; padded lines cannot be imported." );
+      }
+    stride *= m_Size[axis];
+    }
+}
+
+
+template < class TOutputImage >
+unsigned int
+RThetaImportImageFilter< TOutputImage >
+::GetRDirection() const
+{
+  unsigned int axes[ImageDimension];
+  this->ComputeAxisOrder( axes );
+  return axes[0];
+}
+
+
+template < class TOutputImage >
+unsigned int
+RThetaImportImageFilter< TOutputImage >
+::GetThetaDirection() const
+{
+  unsigned int axes[ImageDimension];
+  this->ComputeAxisOrder( axes );
+  return axes[1];
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::GenerateOutputInformation()
+{
+  OutputImageType * outputPtr = this->GetOutput();
+  if( !outputPtr )
+    {
+    return;
+    }
+  if( m_Theta.Size() != m_Size[1] )
+    {
+    itkExceptionMacro( "The Theta array has " << m_Theta.Size() << " angles for "
+      << m_Size[1] << " lines." );
+    }
+
+  unsigned int axes[ImageDimension];
+  this->ComputeAxisOrder( axes );
+  typename OutputImageType::RegionType region;
+  SizeType size;
+  SpacingType spacing;
+  OriginType origin;
+  for( unsigned int i = 0; i < ImageDimension; i++ )
+    {
+    size[axes[i]] = m_Size[i];
+    spacing[axes[i]] = m_Spacing[i];
+    origin[axes[i]] = m_Origin[i];
+    }
+  region.SetSize( size );
+  outputPtr->SetLargestPossibleRegion( region );
+  outputPtr->SetSpacing( spacing );
+  outputPtr->SetOrigin( origin );
+
+  MetaDataDictionary & dict = outputPtr->GetMetaDataDictionary();
+  EncapsulateMetaData< double >( dict, "Radius", m_Radius );
+  EncapsulateMetaData< Array< double > >( dict, "Theta", m_Theta );
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::EnlargeOutputRequestedRegion( DataObject * output )
+{
+  output->SetRequestedRegionToLargestPossibleRegion();
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::GenerateData()
+{
+  if( m_ImportContainer.IsNull() )
+    {
+    itkExceptionMacro( "An ImportPointer is required." );
+    }
+
+  OutputImageType * outputPtr = this->GetOutput();
+  outputPtr->SetBufferedRegion( outputPtr->GetLargestPossibleRegion() );
+  m_ImportContainer->SetImportPointer( m_ImportContainer->GetImportPointer(),
+    outputPtr->GetLargestPossibleRegion().GetNumberOfPixels(), false );
+  outputPtr->SetPixelContainer( m_ImportContainer );
+}
+
+
+template < class TOutputImage >
+void
+RThetaImportImageFilter< TOutputImage >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "ImportPointer: " << this->GetImportPointer() << std::endl;
+  os << indent << "Size: " << m_Size << std::endl;
+  os << indent << "Strides: " << m_Strides << std::endl;
+  os << indent << "Spacing: " << m_Spacing << std::endl;
+  os << indent << "Origin: " << m_Origin << std::endl;
+  os << indent << "Radius: " << m_Radius << std::endl;
+  os << indent << "Theta: " << m_Theta << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkRThetaImportImageFilter_txx
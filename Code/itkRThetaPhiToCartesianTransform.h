@@ -0,0 +1,266 @@
+#ifndef __itkRThetaPhiToCartesianTransform_h
+#define __itkRThetaPhiToCartesianTransform_h
+
+#include "itkMatrix.h"
+#include "itkTransform.h"
+
+#include "itkRThetaToCartesianTransform.h"
+
+namespace itk
+{
+
+/** @brief Transform R-Theta-Phi space (radius and two angles) into Cartesian
+ * space.  The inverse of CartesianToRThetaPhiTransform, see there for the
+ * geometry and the Parameters.
+ *
+ * The transform is the composition of two RThetaToCartesianTransform's:
+ * GetRThetaTransform() maps the RDirection and ThetaDirection coordinates to
+ * ( u, y ), and GetPhiTransform() maps ( u + PhiRadius, the PhiDirection
+ * coordinate ) to ( x + PhiRadius, z ).
+ */
+template < class TScalarType, unsigned int NDimensions=3 >
+class ITK_EXPORT RThetaPhiToCartesianTransform :
+  public Transform< TScalarType, NDimensions, NDimensions >
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef RThetaPhiToCartesianTransform Self;
+
+  /** Standard super class typedef support. */
+  typedef Transform< TScalarType, NDimensions, NDimensions > Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( RThetaPhiToCartesianTransform, Transform );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the domain space. */
+  itkStaticConstMacro(SpaceDimension, unsigned int, NDimensions);
+
+  /** Type of the input parameters. */
+  typedef  TScalarType     ScalarType;
+
+  /** Standard parameters container. */
+  typedef typename Superclass::ParametersType ParametersType;
+
+  /** Jacobian type. */
+  typedef typename Superclass::JacobianType   JacobianType;
+
+  /** Standard coordinate point type for this class */
+  typedef Point<TScalarType,
+                itkGetStaticConstMacro(SpaceDimension)> InputPointType;
+  typedef Point<TScalarType,
+                itkGetStaticConstMacro(SpaceDimension)> OutputPointType;
+
+  /** Standard vector type for this class. */
+  typedef Vector<TScalarType,
+                 itkGetStaticConstMacro(SpaceDimension)> InputVectorType;
+  typedef Vector<TScalarType,
+                 itkGetStaticConstMacro(SpaceDimension)> OutputVectorType;
+
+  /** Standard covariant vector type for this class. */
+  typedef CovariantVector<TScalarType,
+             itkGetStaticConstMacro(SpaceDimension)> InputCovariantVectorType;
+  typedef CovariantVector<TScalarType,
+            itkGetStaticConstMacro(SpaceDimension)> OutputCovariantVectorType;
+
+  /** Standard vnl_vector type for this class. */
+  typedef vnl_vector_fixed<TScalarType,
+                   itkGetStaticConstMacro(SpaceDimension)> InputVnlVectorType;
+  typedef vnl_vector_fixed<TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension)> OutputVnlVectorType;
+
+  /** Derivative of the output point with respect to the input point,
+   * jacobian[i][j] = d T_i / d x_j. */
+  typedef Matrix< TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension),
+                  itkGetStaticConstMacro(SpaceDimension) > SpatialJacobianType;
+
+  /** Type of the two components. */
+  typedef RThetaToCartesianTransform< TScalarType, NDimensions > ComponentTransformType;
+
+  /**  Method to transform a point. */
+  virtual OutputPointType TransformPoint(const InputPointType  &point ) const;
+
+  /** Transform numberOfPoints points at once. */
+  virtual void TransformPoints( const InputPointType * inputPoints,
+    OutputPointType * outputPoints,
+    unsigned long numberOfPoints ) const;
+
+  /** Method to transform a vector -
+   *  not applicable for this type of transform, since the result depends on
+   *  where the vector is.  Use TransformVector( vector, point ). */
+  virtual OutputVectorType TransformVector(const InputVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point )." );
+    return OutputVectorType();
+    }
+
+  /** Method to transform a vnl_vector -
+   *  not applicable for this type of transform */
+  virtual OutputVnlVectorType TransformVector(const InputVnlVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point ).");
+    return OutputVnlVectorType();
+    }
+
+  /** Method to transform a CovariantVector -
+   *  not applicable for this type of transform.  Use
+   *  TransformCovariantVector( vector, point ). */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType &) const
+    {
+    itkExceptionMacro(<< "Method not applicable for deformable transfrom.  Use TransformCovariantVector( vector, point ).");
+    return OutputCovariantVectorType();
+    }
+
+  /** Transform a vector, e.g. a displacement, located at point:
+   * ComputeJacobianWithRespectToPosition( point ) * vector. */
+  virtual OutputVectorType TransformVector( const InputVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform a covariant vector, e.g. a gradient, located at point: the
+   * inverse transpose of ComputeJacobianWithRespectToPosition( point ) times
+   * vector. */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform numberOfVectors vectors, each located at the corresponding
+   * point. */
+  virtual void TransformVectors( const InputPointType * points,
+    const InputVectorType * vectors,
+    OutputVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Transform numberOfVectors covariant vectors, each located at the
+   * corresponding point. */
+  virtual void TransformCovariantVectors( const InputPointType * points,
+    const InputCovariantVectorType * vectors,
+    OutputCovariantVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Derivative of the output point with respect to the Parameters at
+   * point, by the chain rule through the two components. */
+  virtual const JacobianType & GetJacobian( const InputPointType & point ) const;
+
+  /** Derivative of the output point with respect to the input point.  The
+   * directions other than RDirection, ThetaDirection and PhiDirection are
+   * passed through. */
+  virtual void ComputeJacobianWithRespectToPosition( const InputPointType & point,
+    SpatialJacobianType & jacobian ) const;
+
+  /** Indicates that this transform is linear. That is, given two
+   * points P and Q, and scalar coefficients a and b, then
+   *
+   *           T( a*P + b*Q ) = a * T(P) + b * T(Q)
+   */
+  virtual bool IsLinear() const { return false; }
+
+   /** Base inverse transform type. This type should not be changed to the
+    * concrete inverse transform type or inheritance would be lost.*/
+  typedef typename Superclass::InverseTransformBaseType InverseTransformBaseType;
+  typedef typename InverseTransformBaseType::Pointer    InverseTransformBasePointer;
+
+  /** Return an inverse of this transform, a CartesianToRThetaPhiTransform. */
+  virtual InverseTransformBasePointer GetInverseTransform() const;
+
+  /** The direction in the input image that corresponds to the radial
+   * component. */
+  virtual void SetRDirection( unsigned int direction );
+  itkGetConstMacro( RDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the angular (theta)
+   * component. */
+  virtual void SetThetaDirection( unsigned int direction );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the elevation
+   * (phi) component. */
+  virtual void SetPhiDirection( unsigned int direction );
+  itkGetConstMacro( PhiDirection, unsigned int );
+
+  virtual const ParametersType & GetParameters( void ) const
+    {
+    return this->m_Parameters;
+    }
+  virtual void SetParameters( const ParametersType & parameters );
+
+  /** We must provide an implementation because it is abstract. */
+  virtual void SetFixedParameters( const ParametersType & )
+    {
+    }
+
+  /** See CartesianToRThetaPhiTransform. */
+  virtual void SetRmin( const double& Rmin );
+  virtual void SetRmax( const double& Rmax );
+  virtual void SetPhiRadius( const double& phiRadius );
+  double GetPhiRadius() const
+    {
+    return this->m_Parameters[5];
+    }
+
+  virtual void SetSpacingTheta( double spacing );
+  itkGetConstMacro( SpacingTheta, double );
+  virtual void SetThetaArray( const itk::Array< double >& theta );
+  const itk::Array< double > & GetThetaArray() const
+    {
+    return m_RThetaTransform->GetThetaArray();
+    }
+
+  virtual void SetSpacingPhi( double spacing );
+  itkGetConstMacro( SpacingPhi, double );
+  virtual void SetPhiArray( const itk::Array< double >& phi );
+  const itk::Array< double > & GetPhiArray() const
+    {
+    return m_PhiTransform->GetThetaArray();
+    }
+
+  /** The component that maps the RDirection and ThetaDirection coordinates
+   * to ( u, y ). */
+  const ComponentTransformType * GetRThetaTransform() const
+    {
+    return m_RThetaTransform.GetPointer();
+    }
+
+  /** The component that maps ( u + PhiRadius, the PhiDirection coordinate )
+   * to ( x + PhiRadius, z ). */
+  const ComponentTransformType * GetPhiTransform() const
+    {
+    return m_PhiTransform.GetPointer();
+    }
+
+protected:
+  RThetaPhiToCartesianTransform();
+  ~RThetaPhiToCartesianTransform() {}
+
+  /** Set the Parameters of the components from this->m_Parameters. */
+  void UpdateComponentParameters();
+
+  unsigned int m_RDirection;
+  unsigned int m_ThetaDirection;
+  unsigned int m_PhiDirection;
+  double       m_SpacingTheta;
+  double       m_SpacingPhi;
+
+  typename ComponentTransformType::Pointer m_RThetaTransform;
+  typename ComponentTransformType::Pointer m_PhiTransform;
+
+private:
+  RThetaPhiToCartesianTransform( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRThetaPhiToCartesianTransform.txx"
+#endif
+
+#endif // __itkRThetaPhiToCartesianTransform_h
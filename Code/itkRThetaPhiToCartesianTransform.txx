@@ -0,0 +1,403 @@
+#ifndef __itkRThetaPhiToCartesianTransform_txx
+#define __itkRThetaPhiToCartesianTransform_txx
+
+#include "itkRThetaPhiToCartesianTransform.h"
+
+#include "itkCartesianToRThetaPhiTransform.h"
+
+#include "vnl/vnl_math.h"
+
+namespace itk
+{
+
+template < class TScalarType, unsigned int NDimensions >
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::RThetaPhiToCartesianTransform():
+  Superclass( SpaceDimension, 9 ),
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_PhiDirection( 2 ),
+  m_SpacingTheta( 0.0 ),
+  m_SpacingPhi( 0.0 )
+{
+  this->m_Parameters.Fill( 0.0 );
+  // Rmin invalid value to make sure it gets set
+  this->m_Parameters[0] = -1.0;
+  // Rmax invalid value to make sure it gets set
+  this->m_Parameters[1] = -1.0;
+
+  m_RThetaTransform = ComponentTransformType::New();
+  m_RThetaTransform->SetRDirection( m_RDirection );
+  m_RThetaTransform->SetThetaDirection( m_ThetaDirection );
+
+  m_PhiTransform = ComponentTransformType::New();
+  m_PhiTransform->SetRDirection( m_RDirection );
+  m_PhiTransform->SetThetaDirection( m_PhiDirection );
+  m_PhiTransform->SetRmin( 0.0 );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetRDirection( unsigned int direction )
+{
+  m_RDirection = direction;
+  m_RThetaTransform->SetRDirection( direction );
+  m_PhiTransform->SetRDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetThetaDirection( unsigned int direction )
+{
+  m_ThetaDirection = direction;
+  m_RThetaTransform->SetThetaDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetPhiDirection( unsigned int direction )
+{
+  m_PhiDirection = direction;
+  m_PhiTransform->SetThetaDirection( direction );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetParameters( const ParametersType & parameters )
+{
+  this->m_Parameters = parameters;
+  this->UpdateComponentParameters();
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::UpdateComponentParameters()
+{
+  ParametersType rThetaParameters( 5 );
+  ParametersType phiParameters( 5 );
+  for( unsigned int i = 0; i < 5; i++ )
+    {
+    rThetaParameters[i] = this->m_Parameters[i];
+    }
+  phiParameters[0] = 0.0;
+  phiParameters[1] = this->m_Parameters[1] + vnl_math_abs( this->m_Parameters[5] );
+  phiParameters[2] = this->m_Parameters[6];
+  phiParameters[3] = this->m_Parameters[7];
+  phiParameters[4] = this->m_Parameters[8];
+  m_RThetaTransform->SetParameters( rThetaParameters );
+  m_PhiTransform->SetParameters( phiParameters );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetRmin( const double& Rmin )
+{
+  this->m_Parameters[0] = Rmin;
+  m_RThetaTransform->SetRmin( Rmin );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetRmax( const double& Rmax )
+{
+  this->m_Parameters[1] = Rmax;
+  m_RThetaTransform->SetRmax( Rmax );
+  m_PhiTransform->SetRmax( Rmax + vnl_math_abs( this->m_Parameters[5] ) );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetPhiRadius( const double& phiRadius )
+{
+  this->m_Parameters[5] = phiRadius;
+  if( this->m_Parameters[1] >= 0.0 )
+    {
+    m_PhiTransform->SetRmax( this->m_Parameters[1] + vnl_math_abs( phiRadius ) );
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetSpacingTheta( double spacing )
+{
+  m_SpacingTheta = spacing;
+  m_RThetaTransform->SetSpacingTheta( spacing );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetThetaArray( const itk::Array< double >& thetaArray )
+{
+  m_RThetaTransform->SetThetaArray( thetaArray );
+  for( unsigned int i = 2; i < 5; i++ )
+    {
+    this->m_Parameters[i] = m_RThetaTransform->GetParameters()[i];
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetSpacingPhi( double spacing )
+{
+  m_SpacingPhi = spacing;
+  m_PhiTransform->SetSpacingTheta( spacing );
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::SetPhiArray( const itk::Array< double >& phiArray )
+{
+  if( this->m_Parameters[1] < 0.0 )
+    {
+    itkExceptionMacro( "SetRmax() must be called before SetPhiArray()." );
+    }
+  if( m_SpacingPhi == 0.0 )
+    {
+    itkExceptionMacro( "SetSpacingPhi() must be called before SetPhiArray()." );
+    }
+  m_PhiTransform->SetThetaArray( phiArray );
+  for( unsigned int i = 2; i < 5; i++ )
+    {
+    this->m_Parameters[i + 4] = m_PhiTransform->GetParameters()[i];
+    }
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaPhiToCartesianTransform< TScalarType, NDimensions>::OutputPointType
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformPoint( const InputPointType& inpoint ) const
+{
+  // The point in its frame, then the frame rotated about the phi axis.
+  const ScalarType phiRadius = this->m_Parameters[5];
+  OutputPointType point = m_RThetaTransform->TransformPoint( inpoint );
+  point[m_RDirection] += phiRadius;
+  point = m_PhiTransform->TransformPoint( point );
+  point[m_RDirection] -= phiRadius;
+  return point;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformPoints( const InputPointType * inputPoints,
+  OutputPointType * outputPoints,
+  unsigned long numberOfPoints ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  const unsigned long blockSize = 256;
+  OutputPointType frame[blockSize];
+  for( unsigned long start = 0; start < numberOfPoints; start += blockSize )
+    {
+    const unsigned long count = vnl_math_min( blockSize, numberOfPoints - start );
+    m_RThetaTransform->TransformPoints( inputPoints + start, frame, count );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      frame[i][m_RDirection] += phiRadius;
+      }
+    m_PhiTransform->TransformPoints( frame, outputPoints + start, count );
+    for( unsigned long i = 0; i < count; i++ )
+      {
+      outputPoints[start + i][m_RDirection] -= phiRadius;
+      }
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::ComputeJacobianWithRespectToPosition( const InputPointType & point,
+  SpatialJacobianType & jacobian ) const
+{
+  InputPointType frame = m_RThetaTransform->TransformPoint( point );
+  frame[m_RDirection] += this->m_Parameters[5];
+
+  SpatialJacobianType rThetaJacobian;
+  SpatialJacobianType phiJacobian;
+  m_RThetaTransform->ComputeJacobianWithRespectToPosition( point, rThetaJacobian );
+  m_PhiTransform->ComputeJacobianWithRespectToPosition( frame, phiJacobian );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    for( unsigned int j = 0; j < SpaceDimension; j++ )
+      {
+      double sum = 0.0;
+      for( unsigned int k = 0; k < SpaceDimension; k++ )
+        {
+        sum += phiJacobian[i][k] * rThetaJacobian[k][j];
+        }
+      jacobian[i][j] = sum;
+      }
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+const typename RThetaPhiToCartesianTransform< TScalarType, NDimensions>::JacobianType &
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::GetJacobian( const InputPointType & point ) const
+{
+  this->m_Jacobian.Fill( 0.0 );
+
+  InputPointType frame = m_RThetaTransform->TransformPoint( point );
+  frame[m_RDirection] += this->m_Parameters[5];
+
+  SpatialJacobianType phiJacobian;
+  m_PhiTransform->ComputeJacobianWithRespectToPosition( frame, phiJacobian );
+
+  // Rmin, ..., SpacingThetaOverDeltaTheta move the point in its frame, and
+  // PhiRadius shifts the input of the second component and its output back.
+  const JacobianType & rThetaParameterJacobian = m_RThetaTransform->GetJacobian( point );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    for( unsigned int j = 0; j < 5; j++ )
+      {
+      double sum = 0.0;
+      for( unsigned int k = 0; k < SpaceDimension; k++ )
+        {
+        sum += phiJacobian[i][k] * rThetaParameterJacobian( k, j );
+        }
+      this->m_Jacobian( i, j ) = sum;
+      }
+    this->m_Jacobian( i, 5 ) = phiJacobian[i][m_RDirection] - ( i == m_RDirection ? 1.0 : 0.0 );
+    }
+
+  // Phimin and SpacingPhiOverDeltaPhi are columns 3 and 4 of the second
+  // component.
+  const JacobianType & phiParameterJacobian = m_PhiTransform->GetJacobian( frame );
+  for( unsigned int i = 0; i < SpaceDimension; i++ )
+    {
+    this->m_Jacobian( i, 7 ) = phiParameterJacobian( i, 3 );
+    this->m_Jacobian( i, 8 ) = phiParameterJacobian( i, 4 );
+    }
+
+  return this->m_Jacobian;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaPhiToCartesianTransform< TScalarType, NDimensions>::OutputVectorType
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformVector( const InputVectorType & vector, const InputPointType & point ) const
+{
+  OutputVectorType output;
+  this->TransformVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaPhiToCartesianTransform< TScalarType, NDimensions>::OutputCovariantVectorType
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformCovariantVector( const InputCovariantVectorType & vector, const InputPointType & point ) const
+{
+  OutputCovariantVectorType output;
+  this->TransformCovariantVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformVectors( const InputPointType * points,
+  const InputVectorType * vectors,
+  OutputVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    InputPointType frame = m_RThetaTransform->TransformPoint( points[i] );
+    frame[m_RDirection] += phiRadius;
+    outputVectors[i] = m_PhiTransform->TransformVector(
+      m_RThetaTransform->TransformVector( vectors[i], points[i] ), frame );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::TransformCovariantVectors( const InputPointType * points,
+  const InputCovariantVectorType * vectors,
+  OutputCovariantVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  const ScalarType phiRadius = this->m_Parameters[5];
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    InputPointType frame = m_RThetaTransform->TransformPoint( points[i] );
+    frame[m_RDirection] += phiRadius;
+    outputVectors[i] = m_PhiTransform->TransformCovariantVector(
+      m_RThetaTransform->TransformCovariantVector( vectors[i], points[i] ), frame );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaPhiToCartesianTransform< TScalarType, NDimensions>::InverseTransformBasePointer
+RThetaPhiToCartesianTransform< TScalarType, NDimensions >
+::GetInverseTransform() const
+{
+  typedef itk::CartesianToRThetaPhiTransform< TScalarType, NDimensions > InverseType;
+  typename InverseType::Pointer inverse = InverseType::New();
+
+  inverse->SetRDirection( m_RDirection );
+  inverse->SetThetaDirection( m_ThetaDirection );
+  inverse->SetPhiDirection( m_PhiDirection );
+  inverse->SetSpacingTheta( m_SpacingTheta );
+  inverse->SetSpacingPhi( m_SpacingPhi );
+  inverse->SetParameters( this->GetParameters() );
+  if( this->GetThetaArray().Size() > 1 )
+    {
+    inverse->SetThetaArray( this->GetThetaArray() );
+    }
+  if( this->GetPhiArray().Size() > 1 )
+    {
+    inverse->SetPhiArray( this->GetPhiArray() );
+    }
+
+  return inverse.GetPointer();
+}
+
+
+}
+
+#endif // __itkRThetaPhiToCartesianTransform_txx
@@ -0,0 +1,220 @@
+#ifndef __itkRThetaScanGeometry_h
+#define __itkRThetaScanGeometry_h
+
+#include "itkArray.h"
+#include "itkObject.h"
+#include "itkMetaDataDictionary.h"
+#include "itkPoint.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkSize.h"
+#include "itkVector.h"
+
+#include "itkCartesianToRThetaTransform.h"
+#include "itkRThetaToCartesianTransform.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** @brief Immutable description of an (R, Theta) acquisition and of the
+ * Cartesian grid it is scan converted to.
+ *
+ * A geometry is created from the Radius / RadiusString and Theta /
+ * ThetaBinary / ThetaString MetaDataDictionary entries, the spacing and size of the input,
+ * the RDirection and ThetaDirection, and the output spacing in the
+ * ThetaDirection.  It holds Rmin, Rmax, a CartesianToRThetaTransform with the
+ * Theta array and its precomputed inverse-angle table, and the origin,
+ * spacing and size of the output.  None of it changes after creation, so one
+ * geometry can be shared by any number of filters and threads.
+ *
+ * GetGeometry() returns geometries from a process-wide cache.  The cache is
+ * searched by a hash of the inputs; on a hash match the inputs are compared
+ * byte for byte, so a collision cannot return the wrong geometry.  A caller
+ * that keeps the returned geometry can test whether it still applies with
+ * Matches(), which neither locks nor allocates, and only calls
+ * GetGeometry() again when the geometry changes.  Every GetGeometry() takes
+ * the cache's lock, so a filter's first update contends with the other
+ * threads that look up geometries, but only for the search of at most
+ * MaximumCacheSize entries; a geometry is parsed outside of the lock.  Because the dictionary entries are part of the key, the strings
+ * are only parsed when a geometry is created.
+ *
+ * "ThetaBinary" is a std::string that holds the Theta array as packed
+ * doubles in the byte order of the host.  It takes precedence over
+ * "ThetaString", and "Theta" takes precedence over both.  String values are
+ * converted in place, independently of the locale: the usual values are
+ * parsed directly, and only those beyond the precision of a double's
+ * mantissa go through a stream in the classic locale.
+ */
+template < class TScalarType, unsigned int NDimensions >
+class ITK_EXPORT RThetaScanGeometry :
+  public Object
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef RThetaScanGeometry Self;
+
+  /** Standard super class typedef support. */
+  typedef Object Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( RThetaScanGeometry, Object );
+
+  itkStaticConstMacro( Dimension, unsigned int, NDimensions );
+
+  typedef CartesianToRThetaTransform< TScalarType, NDimensions > TransformType;
+  typedef RThetaToCartesianTransform< TScalarType, NDimensions > InverseTransformType;
+  typedef Point< double, NDimensions >                           PointType;
+  typedef Vector< double, NDimensions >                          SpacingType;
+  typedef Size< NDimensions >                                    SizeType;
+
+  /** The geometry for the given dictionary and input, from the cache if an
+   * identical one has been created before.  If created is given, it is set
+   * to whether the dictionary had to be parsed, i.e. whether the cache
+   * missed.  Throws if the dictionary does not describe the Radius or the
+   * Theta array. */
+  static ConstPointer GetGeometry( const MetaDataDictionary & dict,
+    const SpacingType & inputSpacing,
+    const SizeType & inputSize,
+    unsigned int rDirection,
+    unsigned int thetaDirection,
+    double outputSpacingTheta,
+    bool * created = NULL );
+
+  /** Whether this geometry is the one GetGeometry() returns for the given
+   * arguments. */
+  bool Matches( const MetaDataDictionary & dict,
+    const SpacingType & inputSpacing,
+    const SizeType & inputSize,
+    unsigned int rDirection,
+    unsigned int thetaDirection,
+    double outputSpacingTheta ) const;
+
+  /** Remove every geometry from the cache.  Geometries that are still
+   * referenced stay valid. */
+  static void ClearCache();
+
+  /** Number of geometries in the cache. */
+  static unsigned long GetCacheSize();
+
+  /** When the cache is full, the geometry that GetGeometry() returned
+   * least recently is removed.  Defaults to 16. */
+  static void SetMaximumCacheSize( unsigned long size );
+  static unsigned long GetMaximumCacheSize();
+
+  /** Read the real value of the name entry of dict, of type double, or
+   * its name + "String" representation, e.g. "Radius" or "RadiusString".
+   * Returns false if neither entry exists and throws if the string cannot
+   * be parsed. */
+  static bool ReadReal( const MetaDataDictionary & dict,
+    const std::string & name,
+    double & value );
+
+  /** Read the name entry of dict, an Array< double >, or its
+   * name + "Binary" or name + "String" representation, e.g. "Theta",
+   * "ThetaBinary", or "ThetaString", in that order of precedence.  Returns
+   * false if none of the entries exists and throws if one cannot be
+   * parsed. */
+  static bool ReadRealArray( const MetaDataDictionary & dict,
+    const std::string & name,
+    Array< double > & values );
+
+  /** Configured with the RDirection, ThetaDirection, Rmin, Rmax,
+   * SpacingTheta and Theta array.  Its ThetaTolerance is 0. */
+  const TransformType * GetTransform() const
+    {
+    return m_Transform.GetPointer();
+    }
+
+  /** The inverse of GetTransform(), mapping (R, Theta) coordinates to
+   * Cartesian points. */
+  const InverseTransformType * GetInverseTransform() const
+    {
+    return m_InverseTransform.GetPointer();
+    }
+
+  itkGetConstMacro( Rmin, double );
+  itkGetConstMacro( Rmax, double );
+
+  /** Output grid.  The output's index starts at 0 and its direction is the
+   * identity. */
+  itkGetConstReferenceMacro( OutputOrigin, PointType );
+  itkGetConstReferenceMacro( OutputSpacing, SpacingType );
+  itkGetConstReferenceMacro( OutputSize, SizeType );
+
+  /** Hash of the arguments the geometry was created from. */
+  itkGetConstMacro( Hash, unsigned long );
+
+protected:
+  RThetaScanGeometry();
+  ~RThetaScanGeometry() {}
+
+  /** Geometries are only created by GetGeometry(). */
+  itkNewMacro( Self );
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Parse the dictionary and compute the output grid. */
+  void Initialize( const MetaDataDictionary & dict,
+    const SpacingType & inputSpacing,
+    const SizeType & inputSize,
+    unsigned int rDirection,
+    unsigned int thetaDirection,
+    double outputSpacingTheta );
+
+  /** Number of whitespace separated values in text. */
+  static unsigned long CountReals( const std::string & text );
+
+  /** Convert the value that follows position, skipping leading white space,
+   * and advance position past it.  Returns false if there is no number.
+   * position must point into a null terminated string.  The few values
+   * whose significant digits exceed a double's mantissa are converted by
+   * stream, which must be imbued with the classic locale and can be reused
+   * across calls. */
+  static bool ParseReal( const char *& position, double & value, std::istringstream & stream );
+
+  /** Pass the bytes that identify a geometry to visitor( data, length ).
+   * Returns false if the dictionary has no Radius or no Theta entry. */
+  template < class TVisitor >
+  static bool VisitKey( TVisitor & visitor,
+    const MetaDataDictionary & dict,
+    const SpacingType & inputSpacing,
+    const SizeType & inputSize,
+    unsigned int rDirection,
+    unsigned int thetaDirection,
+    double outputSpacingTheta );
+
+  typename TransformType::Pointer        m_Transform;
+  typename InverseTransformType::Pointer m_InverseTransform;
+  double                                 m_Rmin;
+  double                                 m_Rmax;
+  PointType                              m_OutputOrigin;
+  SpacingType                            m_OutputSpacing;
+  SizeType                               m_OutputSize;
+
+  unsigned long m_Hash;
+  std::string   m_Key;
+
+  typedef std::vector< ConstPointer > CacheType;
+  static CacheType           m_Cache;
+  static unsigned long       m_MaximumCacheSize;
+  static SimpleFastMutexLock m_CacheLock;
+
+private:
+  RThetaScanGeometry( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRThetaScanGeometry.txx"
+#endif
+
+#endif // __itkRThetaScanGeometry_h
@@ -0,0 +1,667 @@
+#ifndef __itkRThetaScanGeometry_txx
+#define __itkRThetaScanGeometry_txx
+
+#include "itkRThetaScanGeometry.h"
+
+#include "itkArray.h"
+#include "itkMetaDataObject.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <locale>
+
+namespace itk
+{
+
+namespace RThetaScanGeometryKey
+{
+
+/** FNV-1a hash of the key bytes. */
+class Hasher
+{
+public:
+  Hasher(): m_Hash( 2166136261UL ) {}
+
+  void operator()( const void * data, unsigned long length )
+    {
+    const unsigned char * bytes = static_cast< const unsigned char * >( data );
+    for( unsigned long i = 0; i < length; i++ )
+      {
+      m_Hash = ( ( m_Hash ^ bytes[i] ) * 16777619UL ) & 0xffffffffUL;
+      }
+    }
+
+  unsigned long m_Hash;
+};
+
+/** Copies the key bytes. */
+class Appender
+{
+public:
+  Appender( std::string & key ): m_Key( key ) {}
+
+  void operator()( const void * data, unsigned long length )
+    {
+    m_Key.append( static_cast< const char * >( data ), length );
+    }
+
+  std::string & m_Key;
+};
+
+/** Compares the key bytes with a stored key. */
+class Comparer
+{
+public:
+  Comparer( const std::string & key ): m_Key( key ), m_Position( 0 ), m_Equal( true ) {}
+
+  void operator()( const void * data, unsigned long length )
+    {
+    if( !m_Equal )
+      {
+      return;
+      }
+    if( m_Position + length > m_Key.size() ||
+        std::memcmp( m_Key.data() + m_Position, data, length ) != 0 )
+      {
+      m_Equal = false;
+      return;
+      }
+    m_Position += length;
+    }
+
+  bool IsEqual() const
+    {
+    return m_Equal && m_Position == m_Key.size();
+    }
+
+  const std::string & m_Key;
+  unsigned long       m_Position;
+  bool                m_Equal;
+};
+
+} // end namespace RThetaScanGeometryKey
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaScanGeometry< TScalarType, NDimensions >::CacheType
+RThetaScanGeometry< TScalarType, NDimensions >
+::m_Cache;
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned long
+RThetaScanGeometry< TScalarType, NDimensions >
+::m_MaximumCacheSize = 16;
+
+template < class TScalarType, unsigned int NDimensions >
+SimpleFastMutexLock
+RThetaScanGeometry< TScalarType, NDimensions >
+::m_CacheLock;
+
+
+template < class TScalarType, unsigned int NDimensions >
+RThetaScanGeometry< TScalarType, NDimensions >
+::RThetaScanGeometry():
+  m_Rmin( 0.0 ),
+  m_Rmax( 0.0 ),
+  m_Hash( 0 )
+{
+  m_OutputOrigin.Fill( 0.0 );
+  m_OutputSpacing.Fill( 1.0 );
+  m_OutputSize.Fill( 0 );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+template < class TVisitor >
+bool
+RThetaScanGeometry< TScalarType, NDimensions >
+::VisitKey( TVisitor & visitor,
+  const MetaDataDictionary & dict,
+  const SpacingType & inputSpacing,
+  const SizeType & inputSize,
+  unsigned int rDirection,
+  unsigned int thetaDirection,
+  double outputSpacingTheta )
+{
+  visitor( &rDirection, sizeof( rDirection ) );
+  visitor( &thetaDirection, sizeof( thetaDirection ) );
+  visitor( &outputSpacingTheta, sizeof( outputSpacingTheta ) );
+  for( unsigned int i = 0; i < NDimensions; i++ )
+    {
+    const double spacing = inputSpacing[i];
+    const unsigned long size = inputSize[i];
+    visitor( &spacing, sizeof( spacing ) );
+    visitor( &size, sizeof( size ) );
+    }
+
+  // The entries are tagged so that, e.g., a Radius and a RadiusString never
+  // produce the same bytes.  The precedence is the one of Initialize().
+  typedef const MetaDataObject< std::string >*     MetaStringType;
+  typedef const MetaDataObject< double >*          MetaDoubleType;
+  typedef const MetaDataObject< Array< double > >* MetaArrayType;
+  char tag;
+
+  MetaDoubleType r = dynamic_cast< MetaDoubleType >( dict["Radius"] );
+  MetaStringType rString = dynamic_cast< MetaStringType >( dict["RadiusString"] );
+  if( r != NULL )
+    {
+    tag = 'r';
+    const double radius = r->GetMetaDataObjectValue();
+    visitor( &tag, 1 );
+    visitor( &radius, sizeof( radius ) );
+    }
+  else if( rString != NULL )
+    {
+    tag = 'R';
+    const std::string & radius = rString->GetMetaDataObjectValue();
+    const unsigned long length = radius.size();
+    visitor( &tag, 1 );
+    visitor( &length, sizeof( length ) );
+    visitor( radius.data(), length );
+    }
+  else
+    {
+    return false;
+    }
+
+  MetaArrayType thetaArray = dynamic_cast< MetaArrayType >( dict["Theta"] );
+  MetaStringType thetaArrayBinary = dynamic_cast< MetaStringType >( dict["ThetaBinary"] );
+  MetaStringType thetaArrayString = dynamic_cast< MetaStringType >( dict["ThetaString"] );
+  if( thetaArray != NULL )
+    {
+    tag = 't';
+    const Array< double > & theta = thetaArray->GetMetaDataObjectValue();
+    const unsigned long length = theta.Size();
+    visitor( &tag, 1 );
+    visitor( &length, sizeof( length ) );
+    visitor( theta.data_block(), length * sizeof( double ) );
+    }
+  else if( thetaArrayBinary != NULL )
+    {
+    tag = 'b';
+    const std::string & theta = thetaArrayBinary->GetMetaDataObjectValue();
+    const unsigned long length = theta.size();
+    visitor( &tag, 1 );
+    visitor( &length, sizeof( length ) );
+    visitor( theta.data(), length );
+    }
+  else if( thetaArrayString != NULL )
+    {
+    tag = 'T';
+    const std::string & theta = thetaArrayString->GetMetaDataObjectValue();
+    const unsigned long length = theta.size();
+    visitor( &tag, 1 );
+    visitor( &length, sizeof( length ) );
+    visitor( theta.data(), length );
+    }
+  else
+    {
+    return false;
+    }
+
+  return true;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaScanGeometry< TScalarType, NDimensions >::ConstPointer
+RThetaScanGeometry< TScalarType, NDimensions >
+::GetGeometry( const MetaDataDictionary & dict,
+  const SpacingType & inputSpacing,
+  const SizeType & inputSize,
+  unsigned int rDirection,
+  unsigned int thetaDirection,
+  double outputSpacingTheta,
+  bool * created )
+{
+  if( created )
+    {
+    *created = false;
+    }
+  RThetaScanGeometryKey::Hasher hasher;
+  const bool complete = VisitKey( hasher, dict, inputSpacing, inputSize,
+    rDirection, thetaDirection, outputSpacingTheta );
+
+  if( complete )
+    {
+    ConstPointer cached;
+    m_CacheLock.Lock();
+    for( typename CacheType::iterator it = m_Cache.begin(); it != m_Cache.end(); ++it )
+      {
+      if( ( *it )->m_Hash == hasher.m_Hash &&
+          ( *it )->Matches( dict, inputSpacing, inputSize, rDirection, thetaDirection, outputSpacingTheta ) )
+        {
+        // The cache is ordered from the least to the most recently used.
+        cached = *it;
+        std::rotate( it, it + 1, m_Cache.end() );
+        break;
+        }
+      }
+    m_CacheLock.Unlock();
+    if( cached.IsNotNull() )
+      {
+      return cached;
+      }
+    }
+
+  // Parse outside of the lock.  Initialize() throws the appropriate
+  // exception if an entry is missing.
+  Pointer geometry = Self::New();
+  geometry->Initialize( dict, inputSpacing, inputSize, rDirection, thetaDirection, outputSpacingTheta );
+  if( created )
+    {
+    *created = true;
+    }
+  geometry->m_Hash = hasher.m_Hash;
+  RThetaScanGeometryKey::Appender appender( geometry->m_Key );
+  VisitKey( appender, dict, inputSpacing, inputSize, rDirection, thetaDirection, outputSpacingTheta );
+
+  // Another thread may have added the same geometry in the meantime; keep
+  // the first one so that all the callers share it.
+  ConstPointer result = geometry.GetPointer();
+  m_CacheLock.Lock();
+  for( typename CacheType::iterator it = m_Cache.begin(); it != m_Cache.end(); ++it )
+    {
+    if( ( *it )->m_Hash == geometry->m_Hash && ( *it )->m_Key == geometry->m_Key )
+      {
+      result = *it;
+      std::rotate( it, it + 1, m_Cache.end() );
+      break;
+      }
+    }
+  if( result.GetPointer() == geometry.GetPointer() && m_MaximumCacheSize > 0 )
+    {
+    if( m_Cache.size() >= m_MaximumCacheSize )
+      {
+      m_Cache.erase( m_Cache.begin(), m_Cache.begin() + ( m_Cache.size() - m_MaximumCacheSize + 1 ) );
+      }
+    m_Cache.push_back( result );
+    }
+  m_CacheLock.Unlock();
+
+  return result;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+bool
+RThetaScanGeometry< TScalarType, NDimensions >
+::Matches( const MetaDataDictionary & dict,
+  const SpacingType & inputSpacing,
+  const SizeType & inputSize,
+  unsigned int rDirection,
+  unsigned int thetaDirection,
+  double outputSpacingTheta ) const
+{
+  RThetaScanGeometryKey::Comparer comparer( m_Key );
+  return VisitKey( comparer, dict, inputSpacing, inputSize,
+      rDirection, thetaDirection, outputSpacingTheta ) &&
+    comparer.IsEqual();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaScanGeometry< TScalarType, NDimensions >
+::ClearCache()
+{
+  // Release the geometries after unlocking; their destructors do not need
+  // the lock.
+  CacheType released;
+  m_CacheLock.Lock();
+  released.swap( m_Cache );
+  m_CacheLock.Unlock();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned long
+RThetaScanGeometry< TScalarType, NDimensions >
+::GetCacheSize()
+{
+  m_CacheLock.Lock();
+  const unsigned long size = m_Cache.size();
+  m_CacheLock.Unlock();
+  return size;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaScanGeometry< TScalarType, NDimensions >
+::SetMaximumCacheSize( unsigned long size )
+{
+  CacheType released;
+  m_CacheLock.Lock();
+  m_MaximumCacheSize = size;
+  if( m_Cache.size() > size )
+    {
+    released.assign( m_Cache.begin(), m_Cache.begin() + ( m_Cache.size() - size ) );
+    m_Cache.erase( m_Cache.begin(), m_Cache.begin() + ( m_Cache.size() - size ) );
+    }
+  m_CacheLock.Unlock();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned long
+RThetaScanGeometry< TScalarType, NDimensions >
+::GetMaximumCacheSize()
+{
+  m_CacheLock.Lock();
+  const unsigned long size = m_MaximumCacheSize;
+  m_CacheLock.Unlock();
+  return size;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaScanGeometry< TScalarType, NDimensions >
+::Initialize( const MetaDataDictionary & dict,
+  const SpacingType & inputSpacing,
+  const SizeType & inputSize,
+  unsigned int rDirection,
+  unsigned int thetaDirection,
+  double outputSpacingTheta )
+{
+  m_Transform = TransformType::New();
+  m_Transform->SetRDirection( rDirection );
+  m_Transform->SetThetaDirection( thetaDirection );
+
+  // Rmin.
+  if( !ReadReal( dict, "Radius", m_Rmin ) )
+    {
+    itkExceptionMacro( "Could not find Radius MetaDataDictionary value to perform RTheta transform." );
+    }
+  m_Transform->SetRmin( m_Rmin );
+
+  // Rmax.
+  m_Rmax = m_Rmin + inputSize[rDirection] * inputSpacing[rDirection];
+  m_Transform->SetRmax( m_Rmax );
+
+  m_Transform->SetSpacingTheta( inputSpacing[thetaDirection] );
+
+  // Theta.
+  Array< double > theta;
+  if( !ReadRealArray( dict, "Theta", theta ) )
+    {
+    itkExceptionMacro( "Could not find 'Theta' MetaDataDictionary entry to perform RTheta transform." );
+    }
+  m_Transform->SetThetaArray( theta );
+
+  m_InverseTransform = dynamic_cast< InverseTransformType * >(
+    m_Transform->GetInverseTransform().GetPointer() );
+
+  // Output grid.
+  m_OutputSpacing = inputSpacing;
+  if( outputSpacingTheta == 0.0 ) // has not been initialized
+    {
+    m_OutputSpacing[thetaDirection] = inputSpacing[thetaDirection] / 2.;
+    }
+  else
+    {
+    m_OutputSpacing[thetaDirection] = outputSpacingTheta;
+    }
+
+  m_OutputOrigin.Fill( 0.0 );
+  m_OutputOrigin[rDirection] = m_Transform->GetRmincosMaxAbsTheta();
+  m_OutputOrigin[thetaDirection] = m_Transform->GetRmaxsinThetamin();
+
+  m_OutputSize = inputSize;
+  m_OutputSize[rDirection] = static_cast< unsigned int >( vcl_ceil( ( m_Rmax - m_Transform->GetRmincosMaxAbsTheta() ) / m_OutputSpacing[rDirection] ) );
+  m_OutputSize[thetaDirection] = static_cast< unsigned int >( vcl_ceil( vcl_abs( 2.0 * m_Transform->GetRmaxsinThetamin() / m_OutputSpacing[thetaDirection] ) ) );
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+bool
+RThetaScanGeometry< TScalarType, NDimensions >
+::ReadReal( const MetaDataDictionary & dict,
+  const std::string & name,
+  double & value )
+{
+  typedef const MetaDataObject< std::string >* MetaStringType;
+  typedef const MetaDataObject< double >* MetaDoubleType;
+  MetaDoubleType real = dynamic_cast< MetaDoubleType >( dict[name] );
+  MetaStringType realString = dynamic_cast< MetaStringType >( dict[name + "String"] );
+  if( real != NULL )
+    {
+    value = real->GetMetaDataObjectValue();
+    return true;
+    }
+  if( realString != NULL )
+    {
+    const char * position = realString->GetMetaDataObjectValue().c_str();
+    std::istringstream stream;
+    stream.imbue( std::locale::classic() );
+    if( !ParseReal( position, value, stream ) )
+      {
+      itkGenericExceptionMacro( "Could not parse the '" << name << "String' MetaDataDictionary entry." );
+      }
+    return true;
+    }
+  return false;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+bool
+RThetaScanGeometry< TScalarType, NDimensions >
+::ReadRealArray( const MetaDataDictionary & dict,
+  const std::string & name,
+  Array< double > & values )
+{
+  typedef const MetaDataObject< std::string >* MetaStringType;
+  typedef const MetaDataObject< Array< double > >* MetaArrayType;
+  MetaArrayType array = dynamic_cast< MetaArrayType >( dict[name] );
+  MetaStringType arrayBinary = dynamic_cast< MetaStringType >( dict[name + "Binary"] );
+  MetaStringType arrayString = dynamic_cast< MetaStringType >( dict[name + "String"] );
+  if( array != NULL )
+    {
+    values = array->GetMetaDataObjectValue();
+    return true;
+    }
+  if( arrayBinary != NULL )
+    {
+    const std::string & binary = arrayBinary->GetMetaDataObjectValue();
+    if( binary.size() % sizeof( double ) != 0 )
+      {
+      itkGenericExceptionMacro( "The size of the '" << name << "Binary' MetaDataDictionary entry is not a multiple of sizeof( double )." );
+      }
+    values.SetSize( binary.size() / sizeof( double ) );
+    if( values.Size() > 0 )
+      {
+      std::memcpy( values.data_block(), binary.data(), binary.size() );
+      }
+    return true;
+    }
+  if( arrayString != NULL )
+    {
+    // Count the values, then convert them in place into the array.
+    const std::string & text = arrayString->GetMetaDataObjectValue();
+    values.SetSize( CountReals( text ) );
+    const char * position = text.c_str();
+    std::istringstream stream;
+    stream.imbue( std::locale::classic() );
+    for( unsigned int i = 0; i < values.Size(); i++ )
+      {
+      if( !ParseReal( position, values[i], stream ) )
+        {
+        itkGenericExceptionMacro( "Could not parse value " << i << " of the '" << name << "String' MetaDataDictionary entry." );
+        }
+      }
+    return true;
+    }
+  return false;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+unsigned long
+RThetaScanGeometry< TScalarType, NDimensions >
+::CountReals( const std::string & text )
+{
+  unsigned long count = 0;
+  bool inValue = false;
+  for( std::string::const_iterator it = text.begin(); it != text.end(); ++it )
+    {
+    const bool isSpace = std::isspace( static_cast< unsigned char >( *it ) ) != 0;
+    if( !isSpace && !inValue )
+      {
+      ++count;
+      }
+    inValue = !isSpace;
+    }
+  return count;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+bool
+RThetaScanGeometry< TScalarType, NDimensions >
+::ParseReal( const char *& position, double & value, std::istringstream & stream )
+{
+  const char * p = position;
+  while( std::isspace( static_cast< unsigned char >( *p ) ) )
+    {
+    ++p;
+    }
+  const bool negative = ( *p == '-' );
+  if( *p == '+' || *p == '-' )
+    {
+    ++p;
+    }
+  const char * const magnitude = p;
+
+  // The significant digits are accumulated while they are exactly
+  // representable, i.e. up to 2^53, and the value is mantissa *
+  // 10^exponent.  Zeros are only applied when a nonzero digit follows, so
+  // that trailing zeros do not count against the precision.
+  const double maximumMantissa = 9007199254740992.0;
+  double mantissa = 0.0;
+  long exponent = 0;
+  long pendingZeros = 0;
+  bool exact = true;
+  bool anyDigit = false;
+  bool fraction = false;
+  for( ;; ++p )
+    {
+    if( *p == '.' && !fraction )
+      {
+      fraction = true;
+      continue;
+      }
+    if( !std::isdigit( static_cast< unsigned char >( *p ) ) )
+      {
+      break;
+      }
+    anyDigit = true;
+    if( fraction )
+      {
+      --exponent;
+      }
+    const int digit = *p - '0';
+    if( digit == 0 )
+      {
+      if( mantissa != 0.0 )
+        {
+        ++pendingZeros;
+        }
+      continue;
+      }
+    // Test before multiplying: a product above 2^53 would already be
+    // rounded, and could round down to 2^53.
+    for( ; pendingZeros >= 0 && exact; --pendingZeros )
+      {
+      const int addend = ( pendingZeros == 0 ? digit : 0 );
+      exact = ( mantissa <= ( maximumMantissa - addend ) / 10.0 );
+      if( exact )
+        {
+        mantissa = 10.0 * mantissa + addend;
+        }
+      }
+    pendingZeros = 0;
+    }
+  if( !anyDigit )
+    {
+    return false;
+    }
+  exponent += pendingZeros;
+
+  if( *p == 'e' || *p == 'E' )
+    {
+    const char * q = p + 1;
+    const bool negativeExponent = ( *q == '-' );
+    if( *q == '+' || *q == '-' )
+      {
+      ++q;
+      }
+    if( std::isdigit( static_cast< unsigned char >( *q ) ) )
+      {
+      long exponentValue = 0;
+      for( ; std::isdigit( static_cast< unsigned char >( *q ) ); ++q )
+        {
+        if( exponentValue < 100000 )
+          {
+          exponentValue = 10 * exponentValue + ( *q - '0' );
+          }
+        }
+      exponent += negativeExponent ? -exponentValue : exponentValue;
+      p = q;
+      }
+    }
+
+  // An exact mantissa scaled by an exact power of ten rounds once, so the
+  // result is correctly rounded.  Other values, e.g. with 17 significant
+  // digits, are converted by the stream.
+  static const double powersOfTen[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+  if( mantissa == 0.0 )
+    {
+    value = 0.0;
+    }
+  else if( exact && exponent >= -22 && exponent <= 22 )
+    {
+    value = exponent < 0 ? mantissa / powersOfTen[-exponent] : mantissa * powersOfTen[exponent];
+    }
+  else
+    {
+    stream.clear();
+    stream.str( std::string( magnitude, p ) );
+    stream >> value;
+    if( stream.fail() )
+      {
+      return false;
+      }
+    }
+  if( negative )
+    {
+    value = -value;
+    }
+  position = p;
+  return true;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaScanGeometry< TScalarType, NDimensions >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "Rmin: " << m_Rmin << std::endl;
+  os << indent << "Rmax: " << m_Rmax << std::endl;
+  os << indent << "OutputOrigin: " << m_OutputOrigin << std::endl;
+  os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
+  os << indent << "OutputSize: " << m_OutputSize << std::endl;
+  os << indent << "Hash: " << m_Hash << std::endl;
+  os << indent << "Transform: " << m_Transform.GetPointer() << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkRThetaScanGeometry_txx
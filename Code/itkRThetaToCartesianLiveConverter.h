@@ -0,0 +1,350 @@
+#ifndef __itkRThetaToCartesianLiveConverter_h
+#define __itkRThetaToCartesianLiveConverter_h
+
+#include "itkObject.h"
+#include "itkConditionVariable.h"
+#include "itkMultiThreader.h"
+#include "itkRealTimeClock.h"
+#include "itkSimpleMutexLock.h"
+
+#include "itkResampleRThetaToCartesianImageFilter.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** @brief Persistent scan converter for frames that arrive one at a time.
+ *
+ * A live acquisition pushes raw (R, Theta) frame buffers with PushFrame().
+ * The buffers are copied into a ring of preallocated slots and converted by
+ * a pool of worker threads that stays alive between frames.  The converted
+ * frames are handed back either through a callback, called from a worker
+ * thread, or through PopFrame() / WaitFrame() and ReleaseFrame().
+ *
+ * Start() takes a template frame whose size, spacing, origin, and
+ * MetaDataDictionary describe every later frame.  It resolves the scan
+ * geometry, computes the RThetaToCartesianLookupTable, and allocates every
+ * input and output buffer, so converting a frame allocates no memory.  Each
+ * frame is split across all the workers, like one threaded update of
+ * ResampleRThetaToCartesianImageFilter, and frames are converted in the
+ * order they were pushed.
+ *
+ * The latency of a frame is the time from PushFrame() until its conversion
+ * is complete.  The worst case is bounded by the ring: when no slot is
+ * free, PushFrame() drops the oldest frame that has not started, or the
+ * oldest converted frame that has not been popped.  A frame that has waited
+ * longer than MaximumLatency when a worker would start it is dropped as
+ * well.  Dropped frames are counted and never delivered.
+ *
+ * ImportFrame() converts a frame without copying it: the slot reads the
+ * caller's input buffer, e.g. a scanner's DMA buffer, in place, and can
+ * write into the caller's output buffer.  The buffers are handed back
+ * through the BufferReleaseCallback once the slot is free again.
+ *
+ * The settings are read by Start(); changing them afterwards requires Stop()
+ * and Start() again.
+ */
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision = double >
+class ITK_EXPORT RThetaToCartesianLiveConverter :
+  public Object
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef RThetaToCartesianLiveConverter Self;
+
+  /** Standard super class typedef support. */
+  typedef Object Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( RThetaToCartesianLiveConverter, Object );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  typedef TInputImage                                        InputImageType;
+  typedef TOutputImage                                       OutputImageType;
+  typedef typename InputImageType::PixelType                 InputPixelType;
+  typedef typename OutputImageType::PixelType                OutputPixelType;
+  typedef ResampleRThetaToCartesianImageFilter< InputImageType, OutputImageType,
+    TInterpolatorPrecision >                                 FilterType;
+  typedef typename FilterType::GeometryType                  GeometryType;
+  typedef typename FilterType::InterpolationModeType         InterpolationModeType;
+  typedef typename FilterType::LogCompressionFunctorType     LogCompressionFunctorType;
+  typedef typename OutputImageType::RegionType               OutputRegionType;
+
+  /** A converted frame.  Image stays valid and unchanged until the frame is
+   * released.  It is an output of the converter's internal filter, so it
+   * should be read, not updated or streamed. */
+  struct FrameType
+    {
+    const OutputImageType * Image;
+    /** Sequence number of the PushFrame() call, starting at 0. */
+    unsigned long           FrameNumber;
+    /** Seconds from PushFrame() until the conversion was complete. */
+    double                  Latency;
+    unsigned int            Slot;
+    };
+
+  /** Called from a worker thread for every converted frame.  The frame is
+   * released when the callback returns. */
+  typedef void ( *FrameCallbackType )( const FrameType & frame, void * clientData );
+
+  /** Called with the buffers of an ImportFrame() once the converter no
+   * longer uses them: after the frame was released, or when it is dropped.
+   * output is NULL if the frame was converted into the ring.  It is called
+   * with the converter's lock held, so it must not call the converter. */
+  typedef void ( *BufferReleaseCallbackType )( const InputPixelType * input,
+    OutputPixelType * output, void * clientData );
+
+  /** The direction in the input image that corresponds to the radial
+   * component. */
+  itkSetMacro( RDirection, unsigned int );
+  itkGetConstMacro( RDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the angular
+   * component. */
+  itkSetMacro( ThetaDirection, unsigned int );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  /** See ResampleRThetaToCartesianImageFilter::SetOutputSpacingTheta(). */
+  itkSetMacro( OutputSpacingTheta, double );
+  itkGetConstMacro( OutputSpacingTheta, double );
+
+  itkSetMacro( DefaultPixelValue, OutputPixelType );
+  itkGetConstMacro( DefaultPixelValue, OutputPixelType );
+
+  /** See ResampleRThetaToCartesianImageFilter::SetInterpolationMode(). */
+  itkSetMacro( InterpolationMode, InterpolationModeType );
+  itkGetConstMacro( InterpolationMode, InterpolationModeType );
+
+  /** See ResampleRThetaToCartesianImageFilter::SetUseLogCompression(). */
+  itkSetMacro( UseLogCompression, bool );
+  itkGetConstMacro( UseLogCompression, bool );
+  itkBooleanMacro( UseLogCompression );
+
+  const LogCompressionFunctorType & GetLogCompressionFunctor() const
+    {
+    return m_LogCompressionFunctor;
+    }
+  void SetLogCompressionFunctor( const LogCompressionFunctorType & functor )
+    {
+    m_LogCompressionFunctor = functor;
+    }
+
+  /** Number of worker threads.  Defaults to the global default number of
+   * threads. */
+  itkSetClampMacro( NumberOfWorkers, unsigned int, 1, ITK_MAX_THREADS );
+  itkGetConstMacro( NumberOfWorkers, unsigned int );
+
+  /** Number of frames in the ring, i.e. frames that can be queued,
+   * converting, or waiting to be popped at once.  Defaults to 4. */
+  itkSetClampMacro( NumberOfSlots, unsigned int, 2, NumericTraits< unsigned int >::max() );
+  itkGetConstMacro( NumberOfSlots, unsigned int );
+
+  /** Frames that have waited longer than this many seconds when they would
+   * be started are dropped.  0, the default, never drops on age. */
+  itkSetMacro( MaximumLatency, double );
+  itkGetConstMacro( MaximumLatency, double );
+
+  /** Deliver the frames through callback instead of PopFrame().  NULL, the
+   * default, queues them. */
+  void SetFrameCallback( FrameCallbackType callback, void * clientData );
+
+  /** Hand the buffers of ImportFrame() back through callback.  NULL, the
+   * default, does not notify. */
+  void SetBufferReleaseCallback( BufferReleaseCallbackType callback, void * clientData );
+
+  /** Prepare the geometry and the buffers for frames like templateFrame and
+   * start the workers. */
+  void Start( const InputImageType * templateFrame );
+
+  /** Stop the workers.  Frames that are queued are discarded. */
+  void Stop();
+
+  bool GetRunning() const
+    {
+    return m_Running;
+    }
+
+  /** Copy a frame, stored like the buffer of the template frame, into the
+   * ring.  Returns false if no slot could be freed for it. */
+  bool PushFrame( const InputPixelType * buffer );
+
+  /** Convert a frame, stored like the buffer of the template frame, in
+   * place.  input must stay valid and unchanged, and output, which holds
+   * the pixels of GetOutputRegion(), must not be used, until they are
+   * released.  A NULL output converts into the ring.  Returns false if no
+   * slot could be freed, in which case the buffers are not released. */
+  bool ImportFrame( const InputPixelType * input, OutputPixelType * output = NULL );
+
+  /** Region of every converted frame.  Valid after Start(). */
+  OutputRegionType GetOutputRegion() const;
+
+  /** Take the oldest converted frame.  Returns false if there is none. */
+  bool PopFrame( FrameType & frame );
+
+  /** Wait for a converted frame.  Returns false if the converter is
+   * stopped. */
+  bool WaitFrame( FrameType & frame );
+
+  /** Return a popped frame's slot to the ring. */
+  void ReleaseFrame( const FrameType & frame );
+
+  /** Statistics since Start(). */
+  unsigned long GetNumberOfConvertedFrames() const;
+  unsigned long GetNumberOfDroppedFrames() const;
+  double GetLastLatency() const;
+  double GetMeanLatency() const;
+  double GetMaximumObservedLatency() const;
+
+  /** The geometry resolved by Start(). */
+  const GeometryType * GetGeometry() const;
+
+protected:
+  RThetaToCartesianLiveConverter();
+  ~RThetaToCartesianLiveConverter();
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** The filter whose frame conversion the workers share. */
+  class ConversionFilter : public FilterType
+    {
+  public:
+    typedef ConversionFilter                  Self;
+    typedef SmartPointer< Self >              Pointer;
+    typedef typename FilterType::FrameScratchType ScratchType;
+    typedef typename FilterType::OutputImageRegionType OutputImageRegionType;
+
+    itkNewMacro( Self );
+
+    void ConvertFrame( unsigned int frame, const OutputImageRegionType & region,
+      ScratchType & scratch )
+      {
+      ProgressReporter progress( this, 1, region.GetNumberOfPixels() );
+      this->ThreadedGenerateFrame( frame, region, progress, scratch );
+      }
+
+    using FilterType::SplitRegion;
+    using FilterType::ComputeSummedAreaTable;
+
+  protected:
+    ConversionFilter() {}
+    };
+  typedef typename ConversionFilter::ScratchType           ScratchType;
+  typedef typename ConversionFilter::OutputImageRegionType OutputImageRegionType;
+
+  enum SlotStateType
+    {
+    Free,
+    Filling,
+    Pending,
+    Converting,
+    Ready,
+    Delivered
+    };
+
+  struct SlotType
+    {
+    SlotStateType State;
+    unsigned long FrameNumber;
+    /** Order of arrival in the current state, for finding the oldest. */
+    unsigned long Sequence;
+    double        PushTime;
+    double        Latency;
+    /** Buffers of ImportFrame(), or NULL. */
+    const InputPixelType * ImportedInput;
+    OutputPixelType *      ImportedOutput;
+    };
+
+  static ITK_THREAD_RETURN_TYPE WorkerThread( void * arg );
+  void Work();
+
+  /** Take a slot for a new frame and mark it Filling, or return -1. */
+  int AcquireSlot();
+
+  /** Queue a filled slot for conversion. */
+  void QueueSlot( int slot );
+
+  /** Free every slot and release the buffers of ImportFrame(). */
+  void ReleaseSlots();
+
+  /** The following are called with m_Lock held. */
+  int FindOldestSlot( SlotStateType state ) const;
+  bool StartNextFrame();
+  void FinishFrame();
+  void DropSlot( int slot );
+  void FreeSlot( int slot );
+
+private:
+  RThetaToCartesianLiveConverter( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+  unsigned int          m_RDirection;
+  unsigned int          m_ThetaDirection;
+  double                m_OutputSpacingTheta;
+  OutputPixelType       m_DefaultPixelValue;
+  InterpolationModeType m_InterpolationMode;
+  bool                  m_UseLogCompression;
+  unsigned int          m_NumberOfWorkers;
+  unsigned int          m_NumberOfSlots;
+  double                m_MaximumLatency;
+
+  LogCompressionFunctorType m_LogCompressionFunctor;
+
+  FrameCallbackType m_FrameCallback;
+  void *            m_FrameCallbackData;
+
+  BufferReleaseCallbackType m_BufferReleaseCallback;
+  void *                    m_BufferReleaseCallbackData;
+
+  typename ConversionFilter::Pointer               m_Filter;
+  std::vector< typename InputImageType::Pointer >  m_Inputs;
+  unsigned long                                    m_FrameSize;
+  std::vector< OutputImageRegionType >             m_Bands;
+  std::vector< ScratchType >                       m_Scratch;
+
+  /** The buffers of the ring, and containers for the buffers of
+   * ImportFrame(), of every slot. */
+  typedef typename InputImageType::PixelContainer  InputPixelContainerType;
+  typedef typename OutputImageType::PixelContainer OutputPixelContainerType;
+  std::vector< typename InputPixelContainerType::Pointer >  m_InputContainers;
+  std::vector< typename OutputPixelContainerType::Pointer > m_OutputContainers;
+  std::vector< typename InputPixelContainerType::Pointer >  m_ImportedInputContainers;
+  std::vector< typename OutputPixelContainerType::Pointer > m_ImportedOutputContainers;
+
+  MultiThreader::Pointer     m_Threader;
+  std::vector< int >         m_ThreadIds;
+  RealTimeClock::Pointer     m_Clock;
+
+  /** Everything below is guarded by m_Lock. */
+  mutable SimpleMutexLock    m_Lock;
+  ConditionVariable::Pointer m_Condition;
+  bool                       m_Running;
+  bool                       m_Stopping;
+  unsigned int               m_NextWorker;
+  std::vector< SlotType >    m_Slots;
+  unsigned long              m_NextFrameNumber;
+  unsigned long              m_NextSequence;
+  int                        m_CurrentSlot;
+  unsigned int               m_NextBand;
+  unsigned int               m_BandsRemaining;
+
+  unsigned long m_NumberOfConvertedFrames;
+  unsigned long m_NumberOfDroppedFrames;
+  double        m_LastLatency;
+  double        m_TotalLatency;
+  double        m_MaximumObservedLatency;
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRThetaToCartesianLiveConverter.txx"
+#endif
+
+#endif // __itkRThetaToCartesianLiveConverter_h
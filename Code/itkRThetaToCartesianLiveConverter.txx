@@ -0,0 +1,660 @@
+#ifndef __itkRThetaToCartesianLiveConverter_txx
+#define __itkRThetaToCartesianLiveConverter_txx
+
+#include "itkRThetaToCartesianLiveConverter.h"
+
+#include <cstring>
+
+namespace itk
+{
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::RThetaToCartesianLiveConverter():
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_OutputSpacingTheta( 0.0 ),
+  m_DefaultPixelValue( NumericTraits< OutputPixelType >::Zero ),
+  m_InterpolationMode( FilterType::LinearInterpolation ),
+  m_UseLogCompression( false ),
+  m_NumberOfWorkers( MultiThreader::GetGlobalDefaultNumberOfThreads() ),
+  m_NumberOfSlots( 4 ),
+  m_MaximumLatency( 0.0 ),
+  m_FrameCallback( NULL ),
+  m_FrameCallbackData( NULL ),
+  m_BufferReleaseCallback( NULL ),
+  m_BufferReleaseCallbackData( NULL ),
+  m_FrameSize( 0 ),
+  m_Running( false ),
+  m_Stopping( false ),
+  m_NextWorker( 0 ),
+  m_NextFrameNumber( 0 ),
+  m_NextSequence( 0 ),
+  m_CurrentSlot( -1 ),
+  m_NextBand( 0 ),
+  m_BandsRemaining( 0 ),
+  m_NumberOfConvertedFrames( 0 ),
+  m_NumberOfDroppedFrames( 0 ),
+  m_LastLatency( 0.0 ),
+  m_TotalLatency( 0.0 ),
+  m_MaximumObservedLatency( 0.0 )
+{
+  m_Clock = RealTimeClock::New();
+  m_Condition = ConditionVariable::New();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::~RThetaToCartesianLiveConverter()
+{
+  this->Stop();
+  this->ReleaseSlots();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SetFrameCallback( FrameCallbackType callback, void * clientData )
+{
+  m_FrameCallback = callback;
+  m_FrameCallbackData = clientData;
+  this->Modified();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SetBufferReleaseCallback( BufferReleaseCallbackType callback, void * clientData )
+{
+  m_BufferReleaseCallback = callback;
+  m_BufferReleaseCallbackData = clientData;
+  this->Modified();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::Start( const InputImageType * templateFrame )
+{
+  this->Stop();
+  this->ReleaseSlots();
+
+  if( templateFrame == NULL )
+    {
+    itkExceptionMacro( "A template frame is required." );
+    }
+
+  // Every slot is a frame of one multi-frame filter, so the geometry, the
+  // lookup table, and the outputs are set up by a single update.
+  m_Filter = ConversionFilter::New();
+  m_Filter->SetRDirection( m_RDirection );
+  m_Filter->SetThetaDirection( m_ThetaDirection );
+  m_Filter->SetOutputSpacingTheta( m_OutputSpacingTheta );
+  m_Filter->SetDefaultPixelValue( m_DefaultPixelValue );
+  m_Filter->SetInterpolationMode( m_InterpolationMode );
+  m_Filter->SetUseLogCompression( m_UseLogCompression );
+  m_Filter->SetLogCompressionFunctor( m_LogCompressionFunctor );
+  m_Filter->UseLookupTableOn();
+  m_Filter->SetNumberOfThreads( m_NumberOfWorkers );
+
+  const typename InputImageType::RegionType & region = templateFrame->GetLargestPossibleRegion();
+  m_FrameSize = region.GetNumberOfPixels();
+  m_Inputs.resize( m_NumberOfSlots );
+  for( unsigned int slot = 0; slot < m_NumberOfSlots; slot++ )
+    {
+    m_Inputs[slot] = InputImageType::New();
+    m_Inputs[slot]->CopyInformation( templateFrame );
+    m_Inputs[slot]->SetRegions( region );
+    m_Inputs[slot]->Allocate();
+    m_Inputs[slot]->FillBuffer( NumericTraits< InputPixelType >::Zero );
+    m_Filter->SetInput( slot, m_Inputs[slot] );
+    }
+  m_Inputs[0]->SetMetaDataDictionary( templateFrame->GetMetaDataDictionary() );
+  m_Filter->Update();
+
+  m_InputContainers.resize( m_NumberOfSlots );
+  m_OutputContainers.resize( m_NumberOfSlots );
+  m_ImportedInputContainers.resize( m_NumberOfSlots );
+  m_ImportedOutputContainers.resize( m_NumberOfSlots );
+  for( unsigned int slot = 0; slot < m_NumberOfSlots; slot++ )
+    {
+    m_InputContainers[slot] = m_Inputs[slot]->GetPixelContainer();
+    m_OutputContainers[slot] = m_Filter->GetOutput( slot )->GetPixelContainer();
+    m_ImportedInputContainers[slot] = InputPixelContainerType::New();
+    m_ImportedOutputContainers[slot] = OutputPixelContainerType::New();
+    }
+
+  const OutputImageRegionType & outputRegion = m_Filter->GetOutput()->GetRequestedRegion();
+  OutputImageRegionType band;
+  const int numberOfBands = m_Filter->SplitRegion( outputRegion, 0, m_NumberOfWorkers, band );
+  m_Bands.resize( numberOfBands );
+  for( int i = 0; i < numberOfBands; i++ )
+    {
+    m_Filter->SplitRegion( outputRegion, i, m_NumberOfWorkers, m_Bands[i] );
+    }
+
+  // A line interpolates at most two slices in every pass through direction.
+  m_Scratch.assign( m_NumberOfWorkers, ScratchType() );
+  for( unsigned int worker = 0; worker < m_NumberOfWorkers; worker++ )
+    {
+    m_Scratch[worker].SliceOffsets.reserve( 1 << OutputImageType::ImageDimension );
+    m_Scratch[worker].SliceWeights.reserve( 1 << OutputImageType::ImageDimension );
+    }
+
+  SlotType freeSlot;
+  freeSlot.State = Free;
+  freeSlot.FrameNumber = 0;
+  freeSlot.Sequence = 0;
+  freeSlot.PushTime = 0.0;
+  freeSlot.Latency = 0.0;
+  freeSlot.ImportedInput = NULL;
+  freeSlot.ImportedOutput = NULL;
+  m_Slots.assign( m_NumberOfSlots, freeSlot );
+
+  m_Running = true;
+  m_Stopping = false;
+  m_NextWorker = 0;
+  m_NextFrameNumber = 0;
+  m_NextSequence = 0;
+  m_CurrentSlot = -1;
+  m_NextBand = 0;
+  m_BandsRemaining = 0;
+  m_NumberOfConvertedFrames = 0;
+  m_NumberOfDroppedFrames = 0;
+  m_LastLatency = 0.0;
+  m_TotalLatency = 0.0;
+  m_MaximumObservedLatency = 0.0;
+
+  m_Threader = MultiThreader::New();
+  m_ThreadIds.clear();
+  for( unsigned int worker = 0; worker < m_NumberOfWorkers; worker++ )
+    {
+    m_ThreadIds.push_back( m_Threader->SpawnThread( Self::WorkerThread, this ) );
+    }
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::Stop()
+{
+  if( !m_Running )
+    {
+    return;
+    }
+
+  m_Lock.Lock();
+  m_Stopping = true;
+  m_Condition->Broadcast();
+  m_Lock.Unlock();
+
+  for( unsigned int i = 0; i < m_ThreadIds.size(); i++ )
+    {
+    m_Threader->TerminateThread( m_ThreadIds[i] );
+    }
+  m_ThreadIds.clear();
+
+  // Frames that were popped stay valid until the next Start().
+  m_Lock.Lock();
+  for( unsigned int slot = 0; slot < m_Slots.size(); slot++ )
+    {
+    if( m_Slots[slot].State == Pending || m_Slots[slot].State == Converting )
+      {
+      this->FreeSlot( slot );
+      }
+    }
+  m_Running = false;
+  m_CurrentSlot = -1;
+  m_Condition->Broadcast();
+  m_Lock.Unlock();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ReleaseSlots()
+{
+  m_Lock.Lock();
+  for( unsigned int slot = 0; slot < m_Slots.size(); slot++ )
+    {
+    if( m_Slots[slot].State != Free )
+      {
+      this->FreeSlot( slot );
+      }
+    }
+  m_Lock.Unlock();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+int
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::AcquireSlot()
+{
+  m_Lock.Lock();
+  if( !m_Running || m_Stopping )
+    {
+    m_Lock.Unlock();
+    return -1;
+    }
+
+  // Make room by dropping the stalest frame that nobody is working on.
+  int slot = this->FindOldestSlot( Free );
+  if( slot < 0 )
+    {
+    slot = this->FindOldestSlot( Pending );
+    if( slot < 0 && m_FrameCallback == NULL )
+      {
+      slot = this->FindOldestSlot( Ready );
+      }
+    if( slot >= 0 )
+      {
+      this->DropSlot( slot );
+      }
+    }
+  if( slot < 0 )
+    {
+    // The rejected frame still takes its number.
+    m_NextFrameNumber++;
+    m_NumberOfDroppedFrames++;
+    m_Lock.Unlock();
+    return -1;
+    }
+
+  m_Slots[slot].State = Filling;
+  m_Slots[slot].FrameNumber = m_NextFrameNumber++;
+  m_Slots[slot].PushTime = m_Clock->GetTimeStamp();
+  m_Lock.Unlock();
+  return slot;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::QueueSlot( int slot )
+{
+  if( m_Filter->GetInterpolationMode() == FilterType::AntiAliasedInterpolation )
+    {
+    m_Filter->ComputeSummedAreaTable( slot );
+    }
+
+  m_Lock.Lock();
+  m_Slots[slot].State = Pending;
+  m_Slots[slot].Sequence = m_NextSequence++;
+  m_Condition->Broadcast();
+  m_Lock.Unlock();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PushFrame( const InputPixelType * buffer )
+{
+  const int slot = this->AcquireSlot();
+  if( slot < 0 )
+    {
+    return false;
+    }
+  std::memcpy( m_Inputs[slot]->GetBufferPointer(), buffer, m_FrameSize * sizeof( InputPixelType ) );
+  this->QueueSlot( slot );
+  return true;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ImportFrame( const InputPixelType * input, OutputPixelType * output )
+{
+  const int slot = this->AcquireSlot();
+  if( slot < 0 )
+    {
+    return false;
+    }
+
+  // The slot is Filling, so no other thread touches its images.
+  m_ImportedInputContainers[slot]->SetImportPointer( const_cast< InputPixelType * >( input ),
+    m_FrameSize, false );
+  m_Inputs[slot]->SetPixelContainer( m_ImportedInputContainers[slot] );
+  if( output != NULL )
+    {
+    m_ImportedOutputContainers[slot]->SetImportPointer( output,
+      this->GetOutputRegion().GetNumberOfPixels(), false );
+    m_Filter->GetOutput( slot )->SetPixelContainer( m_ImportedOutputContainers[slot] );
+    }
+  m_Slots[slot].ImportedInput = input;
+  m_Slots[slot].ImportedOutput = output;
+
+  this->QueueSlot( slot );
+  return true;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+typename RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >::OutputRegionType
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetOutputRegion() const
+{
+  return m_Filter.IsNull() ? OutputRegionType() : m_Filter->GetOutput()->GetLargestPossibleRegion();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PopFrame( FrameType & frame )
+{
+  m_Lock.Lock();
+  const int slot = this->FindOldestSlot( Ready );
+  if( slot < 0 )
+    {
+    m_Lock.Unlock();
+    return false;
+    }
+  m_Slots[slot].State = Delivered;
+  frame.Image = m_Filter->GetOutput( slot );
+  frame.FrameNumber = m_Slots[slot].FrameNumber;
+  frame.Latency = m_Slots[slot].Latency;
+  frame.Slot = slot;
+  m_Lock.Unlock();
+  return true;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::WaitFrame( FrameType & frame )
+{
+  m_Lock.Lock();
+  while( m_Running && !m_Stopping && this->FindOldestSlot( Ready ) < 0 )
+    {
+    m_Condition->Wait( &m_Lock );
+    }
+  m_Lock.Unlock();
+  return this->PopFrame( frame );
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ReleaseFrame( const FrameType & frame )
+{
+  m_Lock.Lock();
+  if( frame.Slot < m_Slots.size() && m_Slots[frame.Slot].State == Delivered )
+    {
+    this->FreeSlot( frame.Slot );
+    m_Condition->Broadcast();
+    }
+  m_Lock.Unlock();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+ITK_THREAD_RETURN_TYPE
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::WorkerThread( void * arg )
+{
+  MultiThreader::ThreadInfoStruct * info = static_cast< MultiThreader::ThreadInfoStruct * >( arg );
+  static_cast< Self * >( info->UserData )->Work();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::Work()
+{
+  m_Lock.Lock();
+  ScratchType & scratch = m_Scratch[m_NextWorker++];
+  while( !m_Stopping )
+    {
+    if( m_CurrentSlot >= 0 && m_NextBand < m_Bands.size() )
+      {
+      const unsigned int slot = m_CurrentSlot;
+      const unsigned int band = m_NextBand++;
+      m_Lock.Unlock();
+      m_Filter->ConvertFrame( slot, m_Bands[band], scratch );
+      m_Lock.Lock();
+      if( --m_BandsRemaining == 0 )
+        {
+        this->FinishFrame();
+        }
+      }
+    else if( m_CurrentSlot >= 0 || !this->StartNextFrame() )
+      {
+      m_Condition->Wait( &m_Lock );
+      }
+    }
+  m_Lock.Unlock();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+int
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::FindOldestSlot( SlotStateType state ) const
+{
+  int oldest = -1;
+  for( unsigned int slot = 0; slot < m_Slots.size(); slot++ )
+    {
+    if( m_Slots[slot].State == state &&
+        ( oldest < 0 || m_Slots[slot].Sequence < m_Slots[oldest].Sequence ) )
+      {
+      oldest = slot;
+      }
+    }
+  return oldest;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::StartNextFrame()
+{
+  while( true )
+    {
+    const int slot = this->FindOldestSlot( Pending );
+    if( slot < 0 )
+      {
+      return false;
+      }
+    if( m_MaximumLatency > 0.0 &&
+        m_Clock->GetTimeStamp() - m_Slots[slot].PushTime > m_MaximumLatency )
+      {
+      this->DropSlot( slot );
+      continue;
+      }
+    m_Slots[slot].State = Converting;
+    m_CurrentSlot = slot;
+    m_NextBand = 0;
+    m_BandsRemaining = m_Bands.size();
+    m_Condition->Broadcast();
+    return true;
+    }
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::FinishFrame()
+{
+  const unsigned int slot = m_CurrentSlot;
+  m_CurrentSlot = -1;
+
+  SlotType & finished = m_Slots[slot];
+  finished.Latency = m_Clock->GetTimeStamp() - finished.PushTime;
+  m_NumberOfConvertedFrames++;
+  m_LastLatency = finished.Latency;
+  m_TotalLatency += finished.Latency;
+  m_MaximumObservedLatency = vnl_math_max( m_MaximumObservedLatency, finished.Latency );
+
+  if( m_FrameCallback != NULL )
+    {
+    // The other workers can start the next frame during the callback.
+    finished.State = Delivered;
+    FrameType frame;
+    frame.Image = m_Filter->GetOutput( slot );
+    frame.FrameNumber = finished.FrameNumber;
+    frame.Latency = finished.Latency;
+    frame.Slot = slot;
+    m_Condition->Broadcast();
+    m_Lock.Unlock();
+    ( *m_FrameCallback )( frame, m_FrameCallbackData );
+    m_Lock.Lock();
+    this->FreeSlot( slot );
+    }
+  else
+    {
+    finished.State = Ready;
+    finished.Sequence = m_NextSequence++;
+    }
+  m_Condition->Broadcast();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::DropSlot( int slot )
+{
+  this->FreeSlot( slot );
+  m_NumberOfDroppedFrames++;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::FreeSlot( int slot )
+{
+  SlotType & freed = m_Slots[slot];
+  freed.State = Free;
+  if( freed.ImportedInput != NULL )
+    {
+    // Return the ring's buffers before the caller reuses its own.
+    m_Inputs[slot]->SetPixelContainer( m_InputContainers[slot] );
+    if( freed.ImportedOutput != NULL )
+      {
+      m_Filter->GetOutput( slot )->SetPixelContainer( m_OutputContainers[slot] );
+      }
+    if( m_BufferReleaseCallback != NULL )
+      {
+      ( *m_BufferReleaseCallback )( freed.ImportedInput, freed.ImportedOutput,
+        m_BufferReleaseCallbackData );
+      }
+    freed.ImportedInput = NULL;
+    freed.ImportedOutput = NULL;
+    }
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+unsigned long
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetNumberOfConvertedFrames() const
+{
+  m_Lock.Lock();
+  const unsigned long frames = m_NumberOfConvertedFrames;
+  m_Lock.Unlock();
+  return frames;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+unsigned long
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetNumberOfDroppedFrames() const
+{
+  m_Lock.Lock();
+  const unsigned long frames = m_NumberOfDroppedFrames;
+  m_Lock.Unlock();
+  return frames;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+double
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetLastLatency() const
+{
+  m_Lock.Lock();
+  const double latency = m_LastLatency;
+  m_Lock.Unlock();
+  return latency;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+double
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetMeanLatency() const
+{
+  m_Lock.Lock();
+  const double latency = m_NumberOfConvertedFrames > 0 ?
+    m_TotalLatency / m_NumberOfConvertedFrames : 0.0;
+  m_Lock.Unlock();
+  return latency;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+double
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetMaximumObservedLatency() const
+{
+  m_Lock.Lock();
+  const double latency = m_MaximumObservedLatency;
+  m_Lock.Unlock();
+  return latency;
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+const typename RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >::GeometryType *
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GetGeometry() const
+{
+  return m_Filter.IsNull() ? NULL : m_Filter->GetGeometry();
+}
+
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+RThetaToCartesianLiveConverter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "RDirection: " << m_RDirection << std::endl;
+  os << indent << "ThetaDirection: " << m_ThetaDirection << std::endl;
+  os << indent << "OutputSpacingTheta: " << m_OutputSpacingTheta << std::endl;
+  os << indent << "DefaultPixelValue: "
+     << static_cast< typename NumericTraits< OutputPixelType >::PrintType >( m_DefaultPixelValue ) << std::endl;
+  os << indent << "InterpolationMode: " << m_InterpolationMode << std::endl;
+  os << indent << "UseLogCompression: " << m_UseLogCompression << std::endl;
+  os << indent << "NumberOfWorkers: " << m_NumberOfWorkers << std::endl;
+  os << indent << "NumberOfSlots: " << m_NumberOfSlots << std::endl;
+  os << indent << "MaximumLatency: " << m_MaximumLatency << std::endl;
+  os << indent << "Running: " << m_Running << std::endl;
+  os << indent << "NumberOfConvertedFrames: " << this->GetNumberOfConvertedFrames() << std::endl;
+  os << indent << "NumberOfDroppedFrames: " << this->GetNumberOfDroppedFrames() << std::endl;
+  os << indent << "MeanLatency: " << this->GetMeanLatency() << std::endl;
+  os << indent << "MaximumObservedLatency: " << this->GetMaximumObservedLatency() << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkRThetaToCartesianLiveConverter_txx
@@ -0,0 +1,326 @@
+#ifndef __itkRThetaToCartesianLookupTable_h
+#define __itkRThetaToCartesianLookupTable_h
+
+#include "itkObject.h"
+#include "itkImageBase.h"
+#include "itkInterpolateImageFunction.h"
+
+#include "itkCartesianToRThetaTransform.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** @brief Precomputed scan conversion mapping from Cartesian output pixels to
+ * (R, Theta) input pixels.
+ *
+ * For every output pixel in the plane spanned by the RDirection and the
+ * ThetaDirection, the table stores the input index of the lower corner of
+ * the bilinear interpolation neighborhood along with the fractional weights
+ * in the RDirection and the ThetaDirection.  The other directions are passed
+ * through by CartesianToRThetaTransform, so one plane of entries serves every
+ * slice and every frame that shares the geometry.
+ *
+ * The table is computed once with Compute().  Afterwards, converting a frame
+ * only requires gathering four input samples per output pixel; there are no
+ * transcendental function evaluations or virtual calls.
+ *
+ * Entries whose ThetaIndex is negative lie outside of the input buffer and
+ * should receive the default pixel value.  The outermost valid entries of
+ * every line are recorded as a span so that the pixels outside of the
+ * imaging sector can be filled without reading the table.  Valid entries are chosen so that
+ * the index + 1 neighbor is always inside the buffer, i.e. reading all four
+ * corners is always safe.  The index and the weight also locate the sample
+ * for kernels other than the bilinear one.
+ *
+ * With UseFixedPointEntries enabled, Compute() also stores every entry as
+ * the input buffer offset of its lower corner and the four bilinear weights
+ * as integers.  These compact entries interpolate integer pixels without
+ * floating point arithmetic.
+ *
+ * WriteFile() saves the table in a binary file that records the geometry
+ * key, and ReadFile() maps such a file read only into memory instead of
+ * computing the table.  The entries are used in place, so reading costs
+ * the page faults of the entries that are touched, and processes that map
+ * the same file share its pages.  The files are a cache: a file of another
+ * version, byte order, entry layout, or geometry is rejected.
+ * ComputeFileName() names the file of a geometry after a hash of its key.
+ */
+template < class TInputImage, class TCoordRep = double >
+class ITK_EXPORT RThetaToCartesianLookupTable :
+  public Object
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef RThetaToCartesianLookupTable Self;
+
+  /** Standard super class typedef support. */
+  typedef Object Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( RThetaToCartesianLookupTable, Object );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the image. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TInputImage::ImageDimension );
+
+  typedef TInputImage                                        InputImageType;
+  typedef TCoordRep                                          CoordRepType;
+  typedef ImageBase< itkGetStaticConstMacro( ImageDimension ) > ImageBaseType;
+  typedef typename ImageBaseType::SizeType                   SizeType;
+  typedef typename ImageBaseType::IndexType                  IndexType;
+
+  typedef CartesianToRThetaTransform< TCoordRep,
+    itkGetStaticConstMacro( ImageDimension ) >               TransformType;
+  typedef InterpolateImageFunction< TInputImage, TCoordRep > InterpolatorType;
+
+  /** Values that determine the contents of the table.  If the key computed
+   * for a new update matches GetGeometryKey(), the table can be reused. */
+  typedef Array< double > GeometryKeyType;
+
+  /** One output pixel's interpolation neighborhood.  The indices are relative
+   * to the start of the input's buffered region. */
+  struct EntryType
+    {
+    int        RIndex;
+    int        ThetaIndex;
+    TCoordRep  RWeight;
+    TCoordRep  ThetaWeight;
+    };
+  typedef std::vector< EntryType > EntryContainerType;
+
+  /** Number of fractional bits of the fixed point weights. */
+  itkStaticConstMacro( FixedPointShift, unsigned int, 15 );
+
+  /** An entry in fixed point.  BufferOffset is the offset of the neighbor
+   * ( RIndex, ThetaIndex ) from the start of the input buffer, or negative
+   * if the entry is invalid.  The weights of the neighbors
+   * ( RIndex, ThetaIndex ), ( RIndex + 1, ThetaIndex ),
+   * ( RIndex, ThetaIndex + 1 ), and ( RIndex + 1, ThetaIndex + 1 ) sum to
+   * 1 << FixedPointShift, so an interpolation of 16 bit pixels fits in an
+   * int. */
+  struct FixedPointEntryType
+    {
+    int            BufferOffset;
+    unsigned short Weights[4];
+    };
+  typedef std::vector< FixedPointEntryType > FixedPointEntryContainerType;
+
+  /** Round entry to fixed point, for an input buffer with the given offsets
+   * between samples in the RDirection and the ThetaDirection. */
+  static void ComputeFixedPointEntry( const EntryType & entry,
+    long rOffset,
+    long thetaOffset,
+    FixedPointEntryType & fixedPointEntry );
+
+  /** The [Begin, End) range of entries along one line of the table that can
+   * be valid.  Lines run along the lower of RDirection and ThetaDirection,
+   * and the positions are relative to the start of the output's largest
+   * possible region.  Every entry outside of the span is invalid. */
+  struct SpanType
+    {
+    unsigned long Begin;
+    unsigned long End;
+    };
+  typedef std::vector< SpanType > SpanContainerType;
+
+  /** Compute the key that identifies the geometry the table depends on. */
+  static GeometryKeyType ComputeGeometryKey( const TransformType * transform,
+    const ImageBaseType * output,
+    const ImageBaseType * input );
+
+  /** Compute the table entries for the largest possible region of output.
+   * The interpolator's input image provides the input geometry, and its
+   * IsInsideBuffer() decides which output pixels receive the default value.
+   * */
+  virtual void Compute( const TransformType * transform,
+    const ImageBaseType * output,
+    const InterpolatorType * interpolator );
+
+  itkGetConstReferenceMacro( GeometryKey, GeometryKeyType );
+
+  /** Version of the file format of WriteFile(). */
+  itkStaticConstMacro( FileVersion, unsigned int, 1 );
+
+  /** Name of the file of the table of key, without a directory: a 64 bit
+   * hash of the key, the coordinate type, and the dimension. */
+  static std::string ComputeFileName( const GeometryKeyType & key );
+
+  /** Save the table to fileName.  The file is written under a temporary
+   * name and renamed, so that concurrent readers never see a partial file.
+   * Returns false if it could not be written. */
+  bool WriteFile( const std::string & fileName ) const;
+
+  /** Map the table saved in fileName read only, if it exists, was written
+   * by a compatible build, its geometry key is key, and its entries and
+   * spans cover the largest possible region of output.  Otherwise the
+   * table is left unchanged and false is returned. */
+  bool ReadFile( const std::string & fileName, const GeometryKeyType & key,
+    const ImageBaseType * output );
+
+  /** Whether the entries are read from a file mapped by ReadFile(). */
+  bool GetMemoryMapped() const
+    {
+    return m_MappedAddress != NULL;
+    }
+
+  /** Also store every entry in fixed point.  Takes effect at the next
+   * Compute().  Defaults to off. */
+  itkSetMacro( UseFixedPointEntries, bool );
+  itkGetConstMacro( UseFixedPointEntries, bool );
+  itkBooleanMacro( UseFixedPointEntries );
+
+  /** Whether the last Compute() stored fixed point entries whose offsets
+   * are valid for the buffer of input. */
+  bool HasFixedPointEntries( const ImageBaseType * input ) const
+    {
+    return m_NumberOfFixedPointEntries == m_NumberOfEntries &&
+      m_FixedPointROffset == input->GetOffsetTable()[m_RDirection] &&
+      m_FixedPointThetaOffset == input->GetOffsetTable()[m_ThetaDirection];
+    }
+
+  /** The direction in the output image that the table's RIndex corresponds
+   * to. */
+  itkGetConstMacro( RDirection, unsigned int );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  /** Offsets between entries for consecutive output pixels in the RDirection
+   * and the ThetaDirection.  The entries are stored in the same order as the
+   * output image's buffer. */
+  itkGetConstMacro( RStride, unsigned long );
+  itkGetConstMacro( ThetaStride, unsigned long );
+
+  /** Number of entries with a valid interpolation neighborhood. */
+  itkGetConstMacro( NumberOfValidEntries, unsigned long );
+
+  const EntryType * GetEntries() const
+    {
+    return m_NumberOfEntries == 0 ? NULL : m_EntryBuffer;
+    }
+
+  /** Entry for the output pixel with the given index. */
+  const EntryType & GetEntry( const IndexType & index ) const
+    {
+    return m_EntryBuffer[ ( index[m_RDirection] - m_StartIndex[m_RDirection] ) * m_RStride +
+      ( index[m_ThetaDirection] - m_StartIndex[m_ThetaDirection] ) * m_ThetaStride ];
+    }
+
+  /** Fixed point entry for the output pixel with the given index, stored in
+   * the same order as the entries.  Only valid if HasFixedPointEntries(). */
+  const FixedPointEntryType & GetFixedPointEntry( const IndexType & index ) const
+    {
+    return m_FixedPointEntryBuffer[ ( index[m_RDirection] - m_StartIndex[m_RDirection] ) * m_RStride +
+      ( index[m_ThetaDirection] - m_StartIndex[m_ThetaDirection] ) * m_ThetaStride ];
+    }
+
+  unsigned long GetNumberOfEntries() const
+    {
+    return m_NumberOfEntries;
+    }
+
+  /** Span of the line that contains the output pixel with the given index. */
+  const SpanType & GetSpan( const IndexType & index ) const
+    {
+    const unsigned int spanDirection = m_RDirection < m_ThetaDirection ? m_ThetaDirection : m_RDirection;
+    return m_SpanBuffer[ index[spanDirection] - m_StartIndex[spanDirection] ];
+    }
+
+protected:
+  RThetaToCartesianLookupTable();
+  ~RThetaToCartesianLookupTable();
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Point the buffers below at the containers, after they have been
+   * filled by Compute(), and release a mapped file. */
+  void UseContainers();
+
+  /** Unmap the file of ReadFile(), if any. */
+  void ReleaseMappedFile();
+
+  /** Fixed size start of the file of WriteFile().  It is followed by the
+   * key, the spans, the entries, and the fixed point entries, each aligned
+   * to FileAlignment bytes from the start of the file. */
+  struct FileHeaderType
+    {
+    char          Magic[8];
+    unsigned int  Version;
+    unsigned int  ByteOrderMark;
+    unsigned int  CoordinateSize;
+    unsigned int  EntrySize;
+    unsigned int  FixedPointEntrySize;
+    unsigned int  SpanSize;
+    unsigned int  Dimension;
+    unsigned int  RDirection;
+    unsigned int  ThetaDirection;
+    unsigned long KeySize;
+    unsigned long NumberOfSpans;
+    unsigned long NumberOfEntries;
+    unsigned long NumberOfFixedPointEntries;
+    unsigned long NumberOfValidEntries;
+    unsigned long RStride;
+    unsigned long ThetaStride;
+    long          FixedPointROffset;
+    long          FixedPointThetaOffset;
+    long          StartIndex[ImageDimension];
+    };
+  itkStaticConstMacro( FileAlignment, unsigned long, 64 );
+
+  /** The header that WriteFile() would write for the current table. */
+  void FillFileHeader( FileHeaderType & header ) const;
+
+  /** Offsets and sizes in bytes of the key, the spans, the entries, and
+   * the fixed point entries of a file with header.  Returns the size of the
+   * file. */
+  static unsigned long ComputeFileLayout( const FileHeaderType & header,
+    unsigned long offsets[4],
+    unsigned long sizes[4] );
+
+  GeometryKeyType    m_GeometryKey;
+  EntryContainerType m_Entries;
+  SpanContainerType  m_Spans;
+
+  unsigned int  m_RDirection;
+  unsigned int  m_ThetaDirection;
+  unsigned long m_RStride;
+  unsigned long m_ThetaStride;
+  unsigned long m_NumberOfValidEntries;
+  IndexType     m_StartIndex;
+
+  bool                         m_UseFixedPointEntries;
+  FixedPointEntryContainerType m_FixedPointEntries;
+  long                         m_FixedPointROffset;
+  long                         m_FixedPointThetaOffset;
+
+  /** The table in use: the containers above after Compute(), or the
+   * sections of the mapped file after ReadFile(). */
+  const EntryType *           m_EntryBuffer;
+  unsigned long               m_NumberOfEntries;
+  const SpanType *            m_SpanBuffer;
+  unsigned long               m_NumberOfSpans;
+  const FixedPointEntryType * m_FixedPointEntryBuffer;
+  unsigned long               m_NumberOfFixedPointEntries;
+
+  void *        m_MappedAddress;
+  unsigned long m_MappedSize;
+
+private:
+  RThetaToCartesianLookupTable( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+};
+
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkRThetaToCartesianLookupTable.txx"
+#endif
+
+#endif // __itkRThetaToCartesianLookupTable_h
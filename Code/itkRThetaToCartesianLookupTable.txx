@@ -0,0 +1,668 @@
+#ifndef __itkRThetaToCartesianLookupTable_txx
+#define __itkRThetaToCartesianLookupTable_txx
+
+#include "itkRThetaToCartesianLookupTable.h"
+
+#include "itkCartesianToRThetaFunctor.h"
+#include "itkContinuousIndex.h"
+
+#include "vnl/vnl_math.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined( _WIN32 )
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+
+template < class TInputImage, class TCoordRep >
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::RThetaToCartesianLookupTable():
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_RStride( 0 ),
+  m_ThetaStride( 0 ),
+  m_NumberOfValidEntries( 0 ),
+  m_UseFixedPointEntries( false ),
+  m_FixedPointROffset( 0 ),
+  m_FixedPointThetaOffset( 0 ),
+  m_EntryBuffer( NULL ),
+  m_NumberOfEntries( 0 ),
+  m_SpanBuffer( NULL ),
+  m_NumberOfSpans( 0 ),
+  m_FixedPointEntryBuffer( NULL ),
+  m_NumberOfFixedPointEntries( 0 ),
+  m_MappedAddress( NULL ),
+  m_MappedSize( 0 )
+{
+  m_StartIndex.Fill( 0 );
+}
+
+
+template < class TInputImage, class TCoordRep >
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::~RThetaToCartesianLookupTable()
+{
+  this->ReleaseMappedFile();
+}
+
+
+template < class TInputImage, class TCoordRep >
+typename RThetaToCartesianLookupTable< TInputImage, TCoordRep >::GeometryKeyType
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ComputeGeometryKey( const TransformType * transform,
+  const ImageBaseType * output,
+  const ImageBaseType * input )
+{
+  const unsigned int rDirection = transform->GetRDirection();
+  const unsigned int thetaDirection = transform->GetThetaDirection();
+  const typename TransformType::ParametersType & parameters = transform->GetParameters();
+
+  const Array< double > & thetaArray = transform->GetThetaArray();
+  GeometryKeyType key( 3 + parameters.Size() + 2 * 10 + thetaArray.Size() );
+  unsigned int k = 0;
+  key[k++] = rDirection;
+  key[k++] = thetaDirection;
+  key[k++] = transform->GetSpacingTheta();
+  for( unsigned int i = 0; i < parameters.Size(); i++ )
+    {
+    key[k++] = parameters[i];
+    }
+
+  const unsigned int planeDirections[2] = { rDirection, thetaDirection };
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    const unsigned int d = planeDirections[i];
+    key[k++] = output->GetOrigin()[d];
+    key[k++] = output->GetSpacing()[d];
+    key[k++] = output->GetLargestPossibleRegion().GetIndex()[d];
+    key[k++] = output->GetLargestPossibleRegion().GetSize()[d];
+    key[k++] = input->GetOrigin()[d];
+    key[k++] = input->GetSpacing()[d];
+    key[k++] = input->GetLargestPossibleRegion().GetIndex()[d];
+    key[k++] = input->GetLargestPossibleRegion().GetSize()[d];
+    key[k++] = input->GetBufferedRegion().GetIndex()[d];
+    key[k++] = input->GetBufferedRegion().GetSize()[d];
+    }
+
+  // A non-uniform array changes the mapping without changing the parameters.
+  for( unsigned int i = 0; i < thetaArray.Size(); i++ )
+    {
+    key[k++] = thetaArray[i];
+    }
+
+  return key;
+}
+
+
+/** Lower neighbor and weight along one axis.  The neighbor is clamped so that
+ * neighbor + 1 is inside the region, which reproduces the boundary handling
+ * of LinearInterpolateImageFunction. */
+template < class TCoordRep >
+inline void
+RThetaToCartesianLookupTableNeighbor( const TCoordRep continuousIndex,
+  const long start,
+  const unsigned long size,
+  int & neighbor,
+  TCoordRep & weight )
+{
+  const long base = static_cast< long >( vcl_floor( continuousIndex ) );
+  long relative = base - start;
+  weight = continuousIndex - static_cast< TCoordRep >( base );
+  if( relative < 0 )
+    {
+    relative = 0;
+    weight = 0.0;
+    }
+  else if( relative >= static_cast< long >( size ) - 1 )
+    {
+    if( size > 1 )
+      {
+      relative = size - 2;
+      weight = 1.0;
+      }
+    else
+      {
+      relative = 0;
+      weight = 0.0;
+      }
+    }
+  neighbor = static_cast< int >( relative );
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ComputeFixedPointEntry( const EntryType & entry,
+  long rOffset,
+  long thetaOffset,
+  FixedPointEntryType & fixedPointEntry )
+{
+  unsigned short * weights = fixedPointEntry.Weights;
+  if( entry.ThetaIndex < 0 )
+    {
+    fixedPointEntry.BufferOffset = -1;
+    weights[0] = weights[1] = weights[2] = weights[3] = 0;
+    return;
+    }
+  fixedPointEntry.BufferOffset = static_cast< int >( entry.RIndex * rOffset + entry.ThetaIndex * thetaOffset );
+
+  // The cumulative sums of the weights are rounded, so every weight is
+  // within one unit of the exact value and they sum to one exactly.
+  const double one = static_cast< double >( 1 << FixedPointShift );
+  const double rWeight = entry.RWeight;
+  const double thetaWeight = entry.ThetaWeight;
+  const int first = static_cast< int >( ( 1.0 - rWeight ) * ( 1.0 - thetaWeight ) * one + 0.5 );
+  const int second = static_cast< int >( ( 1.0 - thetaWeight ) * one + 0.5 );
+  const int third = static_cast< int >( ( 1.0 - rWeight * thetaWeight ) * one + 0.5 );
+  weights[0] = static_cast< unsigned short >( first );
+  weights[1] = static_cast< unsigned short >( second - first );
+  weights[2] = static_cast< unsigned short >( third - second );
+  weights[3] = static_cast< unsigned short >( ( 1 << FixedPointShift ) - third );
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::Compute( const TransformType * transform,
+  const ImageBaseType * output,
+  const InterpolatorType * interpolator )
+{
+  const InputImageType * input = interpolator->GetInputImage();
+  if( input == NULL )
+    {
+    itkExceptionMacro( "The interpolator's input image must be set before Compute()." );
+    }
+
+  m_GeometryKey = ComputeGeometryKey( transform, output, input );
+
+  m_RDirection = transform->GetRDirection();
+  m_ThetaDirection = transform->GetThetaDirection();
+
+  const typename ImageBaseType::RegionType & outputRegion = output->GetLargestPossibleRegion();
+  const SizeType & outputSize = outputRegion.GetSize();
+  m_StartIndex = outputRegion.GetIndex();
+  const unsigned long rSize = outputSize[m_RDirection];
+  const unsigned long thetaSize = outputSize[m_ThetaDirection];
+  if( m_RDirection < m_ThetaDirection )
+    {
+    m_RStride = 1;
+    m_ThetaStride = rSize;
+    }
+  else
+    {
+    m_ThetaStride = 1;
+    m_RStride = thetaSize;
+    }
+
+  const typename InputImageType::RegionType & inputRegion = input->GetBufferedRegion();
+  const long inputRStart = inputRegion.GetIndex()[m_RDirection];
+  const long inputThetaStart = inputRegion.GetIndex()[m_ThetaDirection];
+  const unsigned long inputRSize = inputRegion.GetSize()[m_RDirection];
+  const unsigned long inputThetaSize = inputRegion.GetSize()[m_ThetaDirection];
+
+  m_Entries.resize( rSize * thetaSize );
+  m_NumberOfValidEntries = 0;
+
+  typedef typename TransformType::InputPointType  PointType;
+  typedef ContinuousIndex< TCoordRep, ImageDimension > ContinuousIndexType;
+  Functor::CartesianToRTheta< TCoordRep, ImageDimension > cartesianToRTheta;
+  cartesianToRTheta.SetTransform( transform );
+  IndexType outputIndex = m_StartIndex;
+  PointType outputPoint;
+  PointType inputPoint;
+  ContinuousIndexType inputIndex;
+  for( unsigned long thetaIt = 0; thetaIt < thetaSize; thetaIt++ )
+    {
+    outputIndex[m_ThetaDirection] = m_StartIndex[m_ThetaDirection] + thetaIt;
+    for( unsigned long rIt = 0; rIt < rSize; rIt++ )
+      {
+      outputIndex[m_RDirection] = m_StartIndex[m_RDirection] + rIt;
+      output->TransformIndexToPhysicalPoint( outputIndex, outputPoint );
+      inputPoint = outputPoint;
+      cartesianToRTheta( outputPoint[m_RDirection], outputPoint[m_ThetaDirection],
+        inputPoint[m_RDirection], inputPoint[m_ThetaDirection] );
+      input->TransformPhysicalPointToContinuousIndex( inputPoint, inputIndex );
+      // Only the (R, Theta) plane is tested here.  The pass through directions
+      // are handled per slice by the caller.
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        if( d != m_RDirection && d != m_ThetaDirection )
+          {
+          inputIndex[d] = inputRegion.GetIndex()[d];
+          }
+        }
+
+      EntryType & entry = m_Entries[ rIt * m_RStride + thetaIt * m_ThetaStride ];
+      if( interpolator->IsInsideBuffer( inputIndex ) )
+        {
+        RThetaToCartesianLookupTableNeighbor< TCoordRep >( inputIndex[m_RDirection],
+          inputRStart, inputRSize, entry.RIndex, entry.RWeight );
+        RThetaToCartesianLookupTableNeighbor< TCoordRep >( inputIndex[m_ThetaDirection],
+          inputThetaStart, inputThetaSize, entry.ThetaIndex, entry.ThetaWeight );
+        ++m_NumberOfValidEntries;
+        }
+      else
+        {
+        entry.RIndex = -1;
+        entry.ThetaIndex = -1;
+        entry.RWeight = 0.0;
+        entry.ThetaWeight = 0.0;
+        }
+      }
+    }
+
+  // Spans of the lines along the lower of the two directions.
+  const unsigned long lineLength = ( m_RDirection < m_ThetaDirection ) ? rSize : thetaSize;
+  const unsigned long numberOfLines = ( m_RDirection < m_ThetaDirection ) ? thetaSize : rSize;
+  m_Spans.resize( numberOfLines );
+  for( unsigned long line = 0; line < numberOfLines; line++ )
+    {
+    const EntryType * lineEntries = &m_Entries[ line * lineLength ];
+    SpanType & span = m_Spans[line];
+    span.Begin = 0;
+    while( span.Begin < lineLength && lineEntries[span.Begin].ThetaIndex < 0 )
+      {
+      ++span.Begin;
+      }
+    span.End = lineLength;
+    while( span.End > span.Begin && lineEntries[span.End - 1].ThetaIndex < 0 )
+      {
+      --span.End;
+      }
+    }
+
+  m_FixedPointEntries.clear();
+  if( m_UseFixedPointEntries )
+    {
+    m_FixedPointROffset = input->GetOffsetTable()[m_RDirection];
+    m_FixedPointThetaOffset = input->GetOffsetTable()[m_ThetaDirection];
+    m_FixedPointEntries.resize( m_Entries.size() );
+    for( unsigned long i = 0; i < m_Entries.size(); i++ )
+      {
+      ComputeFixedPointEntry( m_Entries[i], m_FixedPointROffset, m_FixedPointThetaOffset,
+        m_FixedPointEntries[i] );
+      }
+    }
+
+  this->UseContainers();
+  this->Modified();
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::UseContainers()
+{
+  this->ReleaseMappedFile();
+  m_NumberOfEntries = m_Entries.size();
+  m_EntryBuffer = m_Entries.empty() ? NULL : &m_Entries[0];
+  m_SpanBuffer = m_Spans.empty() ? NULL : &m_Spans[0];
+  m_NumberOfSpans = m_Spans.size();
+  m_NumberOfFixedPointEntries = m_FixedPointEntries.size();
+  m_FixedPointEntryBuffer = m_FixedPointEntries.empty() ? NULL : &m_FixedPointEntries[0];
+}
+
+
+/** Map fileName read only and shared.  Returns NULL if the file cannot be
+ * opened or mapped, or is smaller than minimumSize bytes. */
+inline void *
+RThetaToCartesianLookupTableMapFile( const std::string & fileName,
+  unsigned long minimumSize,
+  unsigned long & size )
+{
+  void * address = NULL;
+#if defined( _WIN32 )
+  HANDLE file = CreateFileA( fileName.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+    NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+  if( file == INVALID_HANDLE_VALUE )
+    {
+    return NULL;
+    }
+  LARGE_INTEGER fileSize;
+  if( GetFileSizeEx( file, &fileSize ) && fileSize.QuadPart >= static_cast< LONGLONG >( minimumSize ) )
+    {
+    // The view keeps the mapping alive after its handles are closed.
+    HANDLE mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+    if( mapping != NULL )
+      {
+      address = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+      size = static_cast< unsigned long >( fileSize.QuadPart );
+      CloseHandle( mapping );
+      }
+    }
+  CloseHandle( file );
+#else
+  const int file = open( fileName.c_str(), O_RDONLY );
+  if( file < 0 )
+    {
+    return NULL;
+    }
+  struct stat status;
+  if( fstat( file, &status ) == 0 && status.st_size >= static_cast< off_t >( minimumSize ) )
+    {
+    address = mmap( NULL, status.st_size, PROT_READ, MAP_SHARED, file, 0 );
+    if( address == MAP_FAILED )
+      {
+      address = NULL;
+      }
+    size = static_cast< unsigned long >( status.st_size );
+    }
+  close( file );
+#endif
+  return address;
+}
+
+
+inline void
+RThetaToCartesianLookupTableUnmapFile( void * address, unsigned long size )
+{
+#if defined( _WIN32 )
+  (void)size;
+  UnmapViewOfFile( address );
+#else
+  munmap( address, size );
+#endif
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ReleaseMappedFile()
+{
+  if( m_MappedAddress != NULL )
+    {
+    RThetaToCartesianLookupTableUnmapFile( m_MappedAddress, m_MappedSize );
+    m_MappedAddress = NULL;
+    m_MappedSize = 0;
+    m_EntryBuffer = NULL;
+    m_NumberOfEntries = 0;
+    m_SpanBuffer = NULL;
+    m_NumberOfSpans = 0;
+    m_FixedPointEntryBuffer = NULL;
+    m_NumberOfFixedPointEntries = 0;
+    }
+}
+
+
+template < class TInputImage, class TCoordRep >
+std::string
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ComputeFileName( const GeometryKeyType & key )
+{
+  // Two 32 bit FNV-1a hashes with different offset bases.
+  unsigned int hashes[2] = { 2166136261u, 3323198485u };
+  const unsigned int prefix[3] = { FileVersion, ImageDimension, sizeof( TCoordRep ) };
+  for( unsigned int h = 0; h < 2; h++ )
+    {
+    const unsigned char * bytes = reinterpret_cast< const unsigned char * >( prefix );
+    for( unsigned int i = 0; i < sizeof( prefix ); i++ )
+      {
+      hashes[h] = ( hashes[h] ^ bytes[i] ) * 16777619u;
+      }
+    for( unsigned int k = 0; k < key.Size(); k++ )
+      {
+      const double value = key[k];
+      bytes = reinterpret_cast< const unsigned char * >( &value );
+      for( unsigned int i = 0; i < sizeof( double ); i++ )
+        {
+        hashes[h] = ( hashes[h] ^ bytes[i] ) * 16777619u;
+        }
+      }
+    }
+
+  char name[64];
+  std::sprintf( name, "RThetaToCartesianLookupTable-%08x%08x.lut", hashes[0], hashes[1] );
+  return std::string( name );
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::FillFileHeader( FileHeaderType & header ) const
+{
+  std::memset( &header, 0, sizeof( header ) );
+  std::memcpy( header.Magic, "RTCLUT\r\n", 8 );
+  header.Version = FileVersion;
+  header.ByteOrderMark = 0x01020304;
+  header.CoordinateSize = sizeof( TCoordRep );
+  header.EntrySize = sizeof( EntryType );
+  header.FixedPointEntrySize = sizeof( FixedPointEntryType );
+  header.SpanSize = sizeof( SpanType );
+  header.Dimension = ImageDimension;
+  header.RDirection = m_RDirection;
+  header.ThetaDirection = m_ThetaDirection;
+  header.KeySize = m_GeometryKey.Size();
+  header.NumberOfSpans = m_NumberOfSpans;
+  header.NumberOfEntries = m_NumberOfEntries;
+  header.NumberOfFixedPointEntries = m_NumberOfFixedPointEntries;
+  header.NumberOfValidEntries = m_NumberOfValidEntries;
+  header.RStride = m_RStride;
+  header.ThetaStride = m_ThetaStride;
+  header.FixedPointROffset = m_FixedPointROffset;
+  header.FixedPointThetaOffset = m_FixedPointThetaOffset;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    header.StartIndex[d] = m_StartIndex[d];
+    }
+}
+
+
+template < class TInputImage, class TCoordRep >
+unsigned long
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ComputeFileLayout( const FileHeaderType & header, unsigned long offsets[4], unsigned long sizes[4] )
+{
+  const unsigned long alignment = FileAlignment;
+  sizes[0] = header.KeySize * sizeof( double );
+  sizes[1] = header.NumberOfSpans * sizeof( SpanType );
+  sizes[2] = header.NumberOfEntries * sizeof( EntryType );
+  sizes[3] = header.NumberOfFixedPointEntries * sizeof( FixedPointEntryType );
+  unsigned long end = sizeof( FileHeaderType );
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    offsets[i] = ( end + alignment - 1 ) / alignment * alignment;
+    end = offsets[i] + sizes[i];
+    }
+  return end;
+}
+
+
+template < class TInputImage, class TCoordRep >
+bool
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::WriteFile( const std::string & fileName ) const
+{
+  if( m_NumberOfEntries == 0 )
+    {
+    return false;
+    }
+
+  FileHeaderType header;
+  this->FillFileHeader( header );
+  unsigned long offsets[4];
+  unsigned long sizes[4];
+  ComputeFileLayout( header, offsets, sizes );
+  const char * sections[4] = {
+    reinterpret_cast< const char * >( m_GeometryKey.data_block() ),
+    reinterpret_cast< const char * >( m_SpanBuffer ),
+    reinterpret_cast< const char * >( m_EntryBuffer ),
+    reinterpret_cast< const char * >( m_FixedPointEntryBuffer ) };
+
+  // The temporary name is unique to the process and the table.
+  std::ostringstream temporaryName;
+#if defined( _WIN32 )
+  temporaryName << fileName << "." << GetCurrentProcessId() << "." << this << ".tmp";
+#else
+  temporaryName << fileName << "." << getpid() << "." << this << ".tmp";
+#endif
+  std::ofstream stream( temporaryName.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+  if( !stream )
+    {
+    return false;
+    }
+  stream.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+  unsigned long position = sizeof( header );
+  const std::vector< char > padding( FileAlignment, 0 );
+  for( unsigned int i = 0; i < 4; i++ )
+    {
+    stream.write( &padding[0], offsets[i] - position );
+    if( sizes[i] > 0 )
+      {
+      stream.write( sections[i], sizes[i] );
+      }
+    position = offsets[i] + sizes[i];
+    }
+  stream.close();
+  if( !stream )
+    {
+    std::remove( temporaryName.str().c_str() );
+    return false;
+    }
+
+#if defined( _WIN32 )
+  const bool renamed = MoveFileExA( temporaryName.str().c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+#else
+  const bool renamed = std::rename( temporaryName.str().c_str(), fileName.c_str() ) == 0;
+#endif
+  if( !renamed )
+    {
+    std::remove( temporaryName.str().c_str() );
+    }
+  return renamed;
+}
+
+
+template < class TInputImage, class TCoordRep >
+bool
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::ReadFile( const std::string & fileName, const GeometryKeyType & key,
+  const ImageBaseType * output )
+{
+  unsigned long mappedSize = 0;
+  void * address = RThetaToCartesianLookupTableMapFile( fileName, sizeof( FileHeaderType ), mappedSize );
+  if( address == NULL )
+    {
+    return false;
+    }
+  const char * file = static_cast< const char * >( address );
+
+  // Everything but the table's contents must be what this build writes.
+  FileHeaderType header;
+  std::memcpy( &header, file, sizeof( header ) );
+  FileHeaderType expected;
+  this->FillFileHeader( expected );
+  unsigned long offsets[4];
+  unsigned long sizes[4];
+  bool compatible = std::memcmp( header.Magic, expected.Magic, sizeof( header.Magic ) ) == 0 &&
+    header.Version == expected.Version &&
+    header.ByteOrderMark == expected.ByteOrderMark &&
+    header.CoordinateSize == expected.CoordinateSize &&
+    header.EntrySize == expected.EntrySize &&
+    header.FixedPointEntrySize == expected.FixedPointEntrySize &&
+    header.SpanSize == expected.SpanSize &&
+    header.Dimension == expected.Dimension &&
+    header.KeySize == key.Size() &&
+    header.RDirection < ImageDimension &&
+    header.ThetaDirection < ImageDimension &&
+    ComputeFileLayout( header, offsets, sizes ) <= mappedSize;
+  if( compatible )
+    {
+    // The key records the size of the plane, but a damaged file could hold
+    // fewer entries or spans, which the conversion reads unchecked.
+    const typename ImageBaseType::RegionType & outputRegion = output->GetLargestPossibleRegion();
+    const unsigned long rSize = outputRegion.GetSize()[header.RDirection];
+    const unsigned long thetaSize = outputRegion.GetSize()[header.ThetaDirection];
+    const bool rFirst = header.RDirection < header.ThetaDirection;
+    compatible = header.RDirection == key[0] &&
+      header.ThetaDirection == key[1] &&
+      header.NumberOfEntries == rSize * thetaSize &&
+      header.NumberOfSpans == ( rFirst ? thetaSize : rSize ) &&
+      ( header.NumberOfFixedPointEntries == 0 ||
+        header.NumberOfFixedPointEntries == header.NumberOfEntries ) &&
+      header.NumberOfValidEntries <= header.NumberOfEntries &&
+      header.RStride == ( rFirst ? 1 : thetaSize ) &&
+      header.ThetaStride == ( rFirst ? rSize : 1 );
+    for( unsigned int d = 0; d < ImageDimension && compatible; d++ )
+      {
+      compatible = header.StartIndex[d] == outputRegion.GetIndex()[d];
+      }
+    }
+  if( compatible )
+    {
+    const double * fileKey = reinterpret_cast< const double * >( file + offsets[0] );
+    for( unsigned int k = 0; k < key.Size() && compatible; k++ )
+      {
+      compatible = fileKey[k] == key[k];
+      }
+    }
+  if( !compatible )
+    {
+    RThetaToCartesianLookupTableUnmapFile( address, mappedSize );
+    return false;
+    }
+
+  this->ReleaseMappedFile();
+  EntryContainerType().swap( m_Entries );
+  SpanContainerType().swap( m_Spans );
+  FixedPointEntryContainerType().swap( m_FixedPointEntries );
+
+  m_MappedAddress = address;
+  m_MappedSize = mappedSize;
+  m_GeometryKey = key;
+  m_RDirection = header.RDirection;
+  m_ThetaDirection = header.ThetaDirection;
+  m_RStride = header.RStride;
+  m_ThetaStride = header.ThetaStride;
+  m_NumberOfValidEntries = header.NumberOfValidEntries;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    m_StartIndex[d] = header.StartIndex[d];
+    }
+  m_SpanBuffer = reinterpret_cast< const SpanType * >( file + offsets[1] );
+  m_NumberOfSpans = header.NumberOfSpans;
+  m_EntryBuffer = reinterpret_cast< const EntryType * >( file + offsets[2] );
+  m_NumberOfEntries = header.NumberOfEntries;
+  m_FixedPointEntryBuffer = header.NumberOfFixedPointEntries == 0 ? NULL :
+    reinterpret_cast< const FixedPointEntryType * >( file + offsets[3] );
+  m_NumberOfFixedPointEntries = header.NumberOfFixedPointEntries;
+  m_FixedPointROffset = header.FixedPointROffset;
+  m_FixedPointThetaOffset = header.FixedPointThetaOffset;
+
+  this->Modified();
+  return true;
+}
+
+
+template < class TInputImage, class TCoordRep >
+void
+RThetaToCartesianLookupTable< TInputImage, TCoordRep >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+  os << indent << "RDirection: " << m_RDirection << std::endl;
+  os << indent << "ThetaDirection: " << m_ThetaDirection << std::endl;
+  os << indent << "NumberOfEntries: " << m_NumberOfEntries << std::endl;
+  os << indent << "NumberOfValidEntries: " << m_NumberOfValidEntries << std::endl;
+  os << indent << "UseFixedPointEntries: " << m_UseFixedPointEntries << std::endl;
+  os << indent << "MemoryMapped: " << this->GetMemoryMapped() << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkRThetaToCartesianLookupTable_txx
@@ -8,6 +8,7 @@
 #ifndef __itkRThetaToCartesianTransform_h
 #define __itkRThetaToCartesianTransform_h
 
+#include "itkMatrix.h"
 #include "itkTransform.h"
 
 namespace itk
@@ -94,14 +95,26 @@ public:
   typedef vnl_vector_fixed<TScalarType,
                   itkGetStaticConstMacro(SpaceDimension)> OutputVnlVectorType;
   
+  /** Derivative of the output point with respect to the input point,
+   * jacobian[i][j] = d T_i / d x_j. */
+  typedef Matrix< TScalarType,
+                  itkGetStaticConstMacro(SpaceDimension),
+                  itkGetStaticConstMacro(SpaceDimension) > SpatialJacobianType;
+
   /**  Method to transform a point. */
   virtual OutputPointType TransformPoint(const InputPointType  &point ) const;
 
+  /** Transform numberOfPoints points at once. */
+  virtual void TransformPoints( const InputPointType * inputPoints,
+    OutputPointType * outputPoints,
+    unsigned long numberOfPoints ) const;
+
   /** Method to transform a vector - 
-   *  not applicable for this type of transform. */
+   *  not applicable for this type of transform, since the result depends on
+   *  where the vector is.  Use TransformVector( vector, point ). */
   virtual OutputVectorType TransformVector(const InputVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transform." );
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point )." );
     return OutputVectorType(); 
     }
 
@@ -109,24 +122,57 @@ public:
    *  not applicable for this type of transform */
   virtual OutputVnlVectorType TransformVector(const InputVnlVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transform. ");
+    itkExceptionMacro(<< "Method not applicable for deformable transform.  Use TransformVector( vector, point ).");
     return OutputVnlVectorType(); 
     }
 
   /** Method to transform a CovariantVector - 
-   *  not applicable for this type of transform */
+   *  not applicable for this type of transform.  Use
+   *  TransformCovariantVector( vector, point ). */
   virtual OutputCovariantVectorType TransformCovariantVector(
     const InputCovariantVectorType &) const
     { 
-    itkExceptionMacro(<< "Method not applicable for deformable transfrom. ");
+    itkExceptionMacro(<< "Method not applicable for deformable transfrom.  Use TransformCovariantVector( vector, point ).");
     return OutputCovariantVectorType(); 
     } 
 
-  virtual const JacobianType & GetJacobian( const InputPointType & point ) const
-    {
-    itkExceptionMacro(<< "GetJacobian has not been implemented yet.");
-    return this->m_Jacobian;
-    }
+  /** Transform a vector, e.g. a displacement, located at point:
+   * ComputeJacobianWithRespectToPosition( point ) * vector. */
+  virtual OutputVectorType TransformVector( const InputVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform a covariant vector, e.g. a gradient, located at point: the
+   * inverse transpose of ComputeJacobianWithRespectToPosition( point ) times
+   * vector. */
+  virtual OutputCovariantVectorType TransformCovariantVector(
+    const InputCovariantVectorType & vector,
+    const InputPointType & point ) const;
+
+  /** Transform numberOfVectors vectors, each located at the corresponding
+   * point.  Equivalent to TransformVector( vectors[i], points[i] ). */
+  virtual void TransformVectors( const InputPointType * points,
+    const InputVectorType * vectors,
+    OutputVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Transform numberOfVectors covariant vectors, each located at the
+   * corresponding point. */
+  virtual void TransformCovariantVectors( const InputPointType * points,
+    const InputCovariantVectorType * vectors,
+    OutputCovariantVectorType * outputVectors,
+    unsigned long numberOfVectors ) const;
+
+  /** Derivative of the output point with respect to the Parameters at
+   * point.  Only Rmin, and for a uniform ThetaArray Thetamin and
+   * SpacingThetaOverDeltaTheta, enter the transform; the other columns are
+   * zero. */
+  virtual const JacobianType & GetJacobian( const InputPointType & point ) const;
+
+  /** Derivative of the output point with respect to the input point.  The
+   * directions other than RDirection and ThetaDirection are passed
+   * through. */
+  virtual void ComputeJacobianWithRespectToPosition( const InputPointType & point,
+    SpatialJacobianType & jacobian ) const;
 
   /** Indicates that this transform is linear. That is, given two
    * points P and Q, and scalar coefficients a and b, then
@@ -198,17 +244,37 @@ public:
    *	each element in the ThetaDirection.  ThetaArray.size() should be the
    *	same as the size of the image in the ThetaDirection.  The MaxAbsTheta,
    *	Thetamin, and SpacingThetaOverDeltaTheta Parameters are defined after
-   *	calling this method.  SetSpacingTheta() and SetRmin() SetRmax() must be called before this. */
+   *	calling this method.  SetSpacingTheta() and SetRmin() SetRmax() must be called before this.
+   *
+   *	If the angles are not uniformly spaced but strictly monotonic, the
+   *	ThetaDirection coordinate divided by SpacingTheta is treated as a
+   *	fractional line index, and the angle is interpolated linearly between
+   *	the neighboring lines.  Other arrays are mapped linearly, as by
+   *	CartesianToRThetaTransform. */
   virtual void SetThetaArray( const itk::Array< double >& theta );
 
+  itkGetConstReferenceMacro( ThetaArray, itk::Array< double > );
+
+  /** Whether the ThetaArray is uniformly spaced.  See
+   * CartesianToRThetaTransform::GetThetaArrayIsUniform(). */
+  itkGetConstMacro( ThetaArrayIsUniform, bool );
+
 protected:
   RThetaToCartesianTransform();
   ~RThetaToCartesianTransform() {}
 
+  /** Angle of the ThetaDirection coordinate thetaCoordinate, and the
+   * derivative of the angle with respect to it. */
+  double ComputeTheta( double thetaCoordinate, double & derivative ) const;
+
   unsigned int m_RDirection;
   unsigned int m_ThetaDirection;
   double m_SpacingTheta;
 
+  itk::Array< double > m_ThetaArray;
+  bool                 m_ThetaArrayIsUniform;
+  bool                 m_InterpolateThetaArray;
+
   ScalarType m_RmaxsinThetamin;
   ScalarType m_RmincosMaxAbsTheta;
 
@@ -16,7 +16,9 @@ RThetaToCartesianTransform< TScalarType, NDimensions >
   Superclass( SpaceDimension, 5 ),
   m_RDirection( 0 ),
   m_ThetaDirection( 1 ),
-  m_SpacingTheta( 0.0 )
+  m_SpacingTheta( 0.0 ),
+  m_ThetaArrayIsUniform( true ),
+  m_InterpolateThetaArray( false )
 {
   // Rmin invalid value to make sure it gets set
   this->m_Parameters[0] = -1.0;
@@ -54,7 +56,57 @@ RThetaToCartesianTransform< TScalarType, NDimensions >
     }
 
   // SpacingThetaOverDeltaTheta
-  this->m_Parameters[4] = m_SpacingTheta / ( thetaArray[1] - thetaArray[0] ) ;
+  const double deltaTheta = thetaArray[1] - thetaArray[0];
+  this->m_Parameters[4] = m_SpacingTheta / deltaTheta;
+
+  m_ThetaArray = thetaArray;
+  m_ThetaArrayIsUniform = true;
+  const double uniformTolerance = 1.0e-3 * vnl_math_abs( deltaTheta );
+  for( unsigned int i = 2; i < thetaArray.Size(); i++ )
+    {
+    if( vnl_math_abs( thetaArray[i] - ( thetaArray[0] + i * deltaTheta ) ) > uniformTolerance )
+      {
+      m_ThetaArrayIsUniform = false;
+      break;
+      }
+    }
+
+  // Like CartesianToRThetaTransform, only a strictly monotonic array is
+  // interpolated; any other is mapped linearly, so that this remains the
+  // inverse of the forward transform.
+  const double thetaSign = deltaTheta < 0.0 ? -1.0 : 1.0;
+  m_InterpolateThetaArray = !m_ThetaArrayIsUniform;
+  for( unsigned int i = 0; i + 1 < thetaArray.Size() && m_InterpolateThetaArray; i++ )
+    {
+    if( thetaSign * ( thetaArray[i + 1] - thetaArray[i] ) <= 0.0 )
+      {
+      m_InterpolateThetaArray = false;
+      }
+    }
+
+  this->Modified();
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+double
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::ComputeTheta( double thetaCoordinate, double & derivative ) const
+{
+  if( !m_InterpolateThetaArray )
+    {
+    derivative = 1.0 / this->m_Parameters[4];
+    return this->m_Parameters[3] + thetaCoordinate / this->m_Parameters[4];
+    }
+
+  // Interpolate between the neighboring lines; the first and last steps
+  // are extrapolated.
+  const double index = thetaCoordinate / m_SpacingTheta;
+  const long lastSegment = static_cast< long >( m_ThetaArray.Size() ) - 2;
+  const long line = vnl_math_min( vnl_math_max( static_cast< long >( vcl_floor( index ) ), 0l ), lastSegment );
+  const double step = m_ThetaArray[line + 1] - m_ThetaArray[line];
+  derivative = step / m_SpacingTheta;
+  return m_ThetaArray[line] + ( index - line ) * step;
 }
 
 
@@ -65,7 +117,8 @@ RThetaToCartesianTransform< TScalarType, NDimensions >
 {
   OutputPointType outpoint = inpoint;
 
-  ScalarType theta = this->m_Parameters[3] + inpoint[m_ThetaDirection] / this->m_Parameters[4];
+  double derivative;
+  ScalarType theta = this->ComputeTheta( inpoint[m_ThetaDirection], derivative );
   ScalarType r     = this->m_Parameters[0] + inpoint[m_RDirection];
 
   outpoint[m_RDirection] = r * vcl_cos( theta );
@@ -75,6 +128,173 @@ RThetaToCartesianTransform< TScalarType, NDimensions >
 }
 
 
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::TransformPoints( const InputPointType * inputPoints,
+  OutputPointType * outputPoints,
+  unsigned long numberOfPoints ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const ScalarType Rmin = this->m_Parameters[0];
+  double derivative;
+  for( unsigned long i = 0; i < numberOfPoints; i++ )
+    {
+    const ScalarType theta = this->ComputeTheta( inputPoints[i][thetaDirection], derivative );
+    const ScalarType r = Rmin + inputPoints[i][rDirection];
+    outputPoints[i] = inputPoints[i];
+    outputPoints[i][rDirection] = r * vcl_cos( theta );
+    outputPoints[i][thetaDirection] = r * vcl_sin( theta );
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::ComputeJacobianWithRespectToPosition( const InputPointType & point,
+  SpatialJacobianType & jacobian ) const
+{
+  // x = r cos( theta ) and y = r sin( theta ), where r = Rmin + the RDirection
+  // coordinate and theta is a function of the ThetaDirection coordinate.
+  double derivative;
+  const double theta = this->ComputeTheta( point[m_ThetaDirection], derivative );
+  const double r = this->m_Parameters[0] + point[m_RDirection];
+  const double cosine = vcl_cos( theta );
+  const double sine = vcl_sin( theta );
+
+  jacobian.SetIdentity();
+  jacobian[m_RDirection][m_RDirection] = cosine;
+  jacobian[m_RDirection][m_ThetaDirection] = -r * sine * derivative;
+  jacobian[m_ThetaDirection][m_RDirection] = sine;
+  jacobian[m_ThetaDirection][m_ThetaDirection] = r * cosine * derivative;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+const typename RThetaToCartesianTransform< TScalarType, NDimensions>::JacobianType &
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::GetJacobian( const InputPointType & point ) const
+{
+  this->m_Jacobian.Fill( 0.0 );
+
+  double derivative;
+  const double theta = this->ComputeTheta( point[m_ThetaDirection], derivative );
+  const double r = this->m_Parameters[0] + point[m_RDirection];
+  const double cosine = vcl_cos( theta );
+  const double sine = vcl_sin( theta );
+
+  // Rmin moves the point along the line.
+  this->m_Jacobian( m_RDirection, 0 ) = cosine;
+  this->m_Jacobian( m_ThetaDirection, 0 ) = sine;
+
+  // theta = Thetamin + coordinate / SpacingThetaOverDeltaTheta rotates it.
+  // The interpolation of a non-uniform array does not use the Parameters.
+  if( !m_InterpolateThetaArray )
+    {
+    // d theta / d SpacingThetaOverDeltaTheta
+    const double spacingThetaOverDeltaTheta = this->m_Parameters[4];
+    const double dTheta = -point[m_ThetaDirection] /
+      ( spacingThetaOverDeltaTheta * spacingThetaOverDeltaTheta );
+    this->m_Jacobian( m_RDirection, 3 ) = -r * sine;
+    this->m_Jacobian( m_ThetaDirection, 3 ) = r * cosine;
+    this->m_Jacobian( m_RDirection, 4 ) = -r * sine * dTheta;
+    this->m_Jacobian( m_ThetaDirection, 4 ) = r * cosine * dTheta;
+    }
+
+  return this->m_Jacobian;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaToCartesianTransform< TScalarType, NDimensions>::OutputVectorType
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::TransformVector( const InputVectorType & vector, const InputPointType & point ) const
+{
+  OutputVectorType output;
+  this->TransformVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+typename RThetaToCartesianTransform< TScalarType, NDimensions>::OutputCovariantVectorType
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::TransformCovariantVector( const InputCovariantVectorType & vector, const InputPointType & point ) const
+{
+  OutputCovariantVectorType output;
+  this->TransformCovariantVectors( &point, &vector, &output, 1 );
+  return output;
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::TransformVectors( const InputPointType * points,
+  const InputVectorType * vectors,
+  OutputVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const double Rmin = this->m_Parameters[0];
+  double derivative;
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    const double theta = this->ComputeTheta( points[i][thetaDirection], derivative );
+    const double r = Rmin + points[i][rDirection];
+    const double cosine = vcl_cos( theta );
+    const double sine = vcl_sin( theta );
+    const double vr = vectors[i][rDirection];
+    const double vtheta = r * derivative * vectors[i][thetaDirection];
+    OutputVectorType & output = outputVectors[i];
+    for( unsigned int d = 0; d < SpaceDimension; d++ )
+      {
+      output[d] = vectors[i][d];
+      }
+    output[rDirection] = cosine * vr - sine * vtheta;
+    output[thetaDirection] = sine * vr + cosine * vtheta;
+    }
+}
+
+
+template < class TScalarType, unsigned int NDimensions >
+void
+RThetaToCartesianTransform< TScalarType, NDimensions >
+::TransformCovariantVectors( const InputPointType * points,
+  const InputCovariantVectorType * vectors,
+  OutputCovariantVectorType * outputVectors,
+  unsigned long numberOfVectors ) const
+{
+  // The inverse transpose of the Jacobian, see
+  // ComputeJacobianWithRespectToPosition(), is
+  //   [ cos( theta )  -sin( theta ) / ( r derivative ) ]
+  //   [ sin( theta )   cos( theta ) / ( r derivative ) ].
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const double Rmin = this->m_Parameters[0];
+  double derivative;
+  for( unsigned long i = 0; i < numberOfVectors; i++ )
+    {
+    const double theta = this->ComputeTheta( points[i][thetaDirection], derivative );
+    const double r = Rmin + points[i][rDirection];
+    const double cosine = vcl_cos( theta );
+    const double sine = vcl_sin( theta );
+    const double gr = vectors[i][rDirection];
+    const double gtheta = vectors[i][thetaDirection] / ( r * derivative );
+    OutputCovariantVectorType & output = outputVectors[i];
+    for( unsigned int d = 0; d < SpaceDimension; d++ )
+      {
+      output[d] = vectors[i][d];
+      }
+    output[rDirection] = cosine * gr - sine * gtheta;
+    output[thetaDirection] = sine * gr + cosine * gtheta;
+    }
+}
+
+
 template < class TScalarType, unsigned int NDimensions >
 typename RThetaToCartesianTransform< TScalarType, NDimensions>::InverseTransformBasePointer
 RThetaToCartesianTransform< TScalarType, NDimensions >
@@ -87,6 +307,10 @@ RThetaToCartesianTransform< TScalarType, NDimensions >
   inverse->SetThetaDirection( m_ThetaDirection );
   inverse->SetSpacingTheta( m_SpacingTheta );
   inverse->SetParameters( this->GetParameters() );
+  if( m_ThetaArray.Size() > 1 )
+    {
+    inverse->SetThetaArray( m_ThetaArray );
+    }
 
   return inverse.GetPointer();
 }
@@ -0,0 +1,179 @@
+#ifndef __itkResampleCartesianToRThetaImageFilter_h
+#define __itkResampleCartesianToRThetaImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkRThetaScanGeometry.h"
+#include "itkRThetaToCartesianTransform.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** @brief Resample a Cartesian image onto the (R, Theta) grid of an
+ * acquisition.  This is the inverse of ResampleRThetaToCartesianImageFilter,
+ * e.g. to take a segmentation, a region of interest mask, or simulated data
+ * back into the native sampling of a curvilinear array.
+ *
+ *  Properties:
+ *  ReferenceImage
+ *    An (R, Theta) image, usually the acquisition itself, whose size,
+ *    spacing, origin, and MetaDataDictionary define the output grid.  It
+ *    needs the same "Radius" / "RadiusString" and "Theta" / "ThetaBinary" /
+ *    "ThetaString" MetaDataDictionary entries as the input of
+ *    ResampleRThetaToCartesianImageFilter.  Only its information is used,
+ *    not its pixels.
+ *
+ *  RDirection
+ *    The direction in the output image that corresponds to the radial
+ *    component.  The Cartesian input has x along this direction.
+ *
+ *  ThetaDirection
+ *    The direction in the output image that corresponds to the angular
+ *    component.  The Cartesian input has y along this direction.
+ *
+ * The output has the reference image's grid, an identity direction, and a
+ * copy of its MetaDataDictionary, so it can be scan converted again with
+ * ResampleRThetaToCartesianImageFilter.  The other directions are passed
+ * through.  Samples that fall outside of the input are set to the
+ * DefaultPixelValue.
+ *
+ * The geometry is resolved through the same RThetaScanGeometry cache as the
+ * forward filter.  The mapping is separable: a sample at radius r on line
+ * theta is at ( r cos theta, r sin theta ), so the radius of every sample
+ * and the cosine and sine of every line are tabulated once per geometry and
+ * each output pixel costs two multiply-adds and a bilinear interpolation.
+ * The conversion is multithreaded, and the input requested region is the
+ * Cartesian bounding box of the output requested region.
+ */
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision = double >
+class ITK_EXPORT ResampleCartesianToRThetaImageFilter :
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef ResampleCartesianToRThetaImageFilter Self;
+
+  /** Standard super class typedef support. */
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /**Typedefs from the superclass */
+  typedef typename Superclass::InputImageType  InputImageType;
+  typedef typename Superclass::OutputImageType OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( ResampleCartesianToRThetaImageFilter, ImageToImageFilter );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the image. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TInputImage::ImageDimension );
+
+  /** Type of the reference image. */
+  typedef ImageBase< itkGetStaticConstMacro( ImageDimension ) > ReferenceImageType;
+
+  /** The (R, Theta) image that defines the output grid. */
+  itkSetConstObjectMacro( ReferenceImage, ReferenceImageType );
+  itkGetConstObjectMacro( ReferenceImage, ReferenceImageType );
+
+  /** The direction in the output image that corresponds to the radial
+   * component. */
+  itkSetMacro( RDirection, unsigned int );
+  itkGetConstMacro( RDirection, unsigned int );
+
+  /** The direction in the output image that corresponds to the angular
+   * (theta) component. */
+  itkSetMacro( ThetaDirection, unsigned int );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  virtual void SetDefaultPixelValue( OutputPixelType defaultValue )
+    {
+    m_DefaultPixelValue = defaultValue;
+    this->Modified();
+    }
+  itkGetConstMacro( DefaultPixelValue, OutputPixelType );
+
+  /** Scan geometry type. */
+  typedef itk::RThetaScanGeometry< TInterpolatorPrecision, ImageDimension > GeometryType;
+
+  /** The geometry of the last output information update. */
+  const GeometryType * GetGeometry() const
+    {
+    return m_Geometry.GetPointer();
+    }
+
+protected:
+  ResampleCartesianToRThetaImageFilter();
+  ~ResampleCartesianToRThetaImageFilter() {}
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Standard process object method. */
+  virtual void GenerateOutputInformation();
+  virtual void GenerateInputRequestedRegion();
+
+  virtual void BeforeThreadedGenerateData();
+  virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId );
+
+  /** Component types. */
+  typedef typename GeometryType::InverseTransformType TransformType;
+  typedef itk::LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecision > InterpolatorType;
+
+  /** Tabulate the radius of every sample and the cosine and sine of every
+   * line of the output's largest possible region. */
+  void ComputeTrigonometryTables( const OutputImageType * outputPtr );
+
+  /** Input buffer offsets and weights of the slices that an output line in
+   * the directions other than RDirection and ThetaDirection interpolates
+   * from.  Empty if the line falls outside the input. */
+  void ComputeSliceNeighbors( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    std::vector< long >& offsets,
+    std::vector< TInterpolatorPrecision >& weights ) const;
+
+private:
+  ResampleCartesianToRThetaImageFilter( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+  typename ReferenceImageType::ConstPointer m_ReferenceImage;
+
+  unsigned int m_RDirection;
+  unsigned int m_ThetaDirection;
+
+  OutputPixelType m_DefaultPixelValue;
+
+  /** Shared geometry and its inverse transform, set in
+   * GenerateOutputInformation(). */
+  typename GeometryType::ConstPointer  m_Geometry;
+  typename TransformType::ConstPointer m_Transform;
+
+  typename InterpolatorType::Pointer m_Interpolator;
+
+  /** Radius of every sample in the RDirection and the cosine and sine of
+   * every line in the ThetaDirection of the output, valid for m_Geometry,
+   * m_TableOrigin, and m_TableRegion. */
+  std::vector< TInterpolatorPrecision > m_Radii;
+  std::vector< TInterpolatorPrecision > m_Cosines;
+  std::vector< TInterpolatorPrecision > m_Sines;
+  typename OutputImageType::PointType   m_TableOrigin;
+  typename OutputImageType::RegionType  m_TableRegion;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkResampleCartesianToRThetaImageFilter.txx"
+#endif
+
+#endif // __itkResampleCartesianToRThetaImageFilter_h
@@ -0,0 +1,463 @@
+#ifndef __itkResampleCartesianToRThetaImageFilter_txx
+#define __itkResampleCartesianToRThetaImageFilter_txx
+
+#include "itkResampleCartesianToRThetaImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "itkRThetaToCartesianLookupTable.h"
+
+#include "vnl/vnl_math.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ResampleCartesianToRThetaImageFilter():
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_DefaultPixelValue( NumericTraits< OutputPixelType >::Zero )
+{
+  m_Interpolator = InterpolatorType::New();
+  m_TableOrigin.Fill( 0.0 );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GenerateOutputInformation()
+{
+  // The input's information is not used, only the reference image's.
+  typename OutputImageType::Pointer outputPtr = this->GetOutput();
+  if( !outputPtr )
+    {
+    return;
+    }
+  if( m_ReferenceImage.IsNull() )
+    {
+    itkExceptionMacro( "The ReferenceImage must be set to define the (R, Theta) output grid." );
+    }
+
+  const MetaDataDictionary & dict = m_ReferenceImage->GetMetaDataDictionary();
+  const typename ReferenceImageType::SpacingType & spacing = m_ReferenceImage->GetSpacing();
+  const typename ReferenceImageType::RegionType & largestRegion = m_ReferenceImage->GetLargestPossibleRegion();
+  const typename ReferenceImageType::SizeType & size = largestRegion.GetSize();
+  typename GeometryType::ConstPointer previousGeometry = m_Geometry;
+  if( m_Geometry.IsNull() ||
+      !m_Geometry->Matches( dict, spacing, size, m_RDirection, m_ThetaDirection, 0.0 ) )
+    {
+    m_Geometry = GeometryType::GetGeometry( dict, spacing, size,
+      m_RDirection, m_ThetaDirection, 0.0 );
+    }
+  m_Transform = m_Geometry->GetInverseTransform();
+
+  outputPtr->SetLargestPossibleRegion( largestRegion );
+  outputPtr->SetSpacing( spacing );
+  outputPtr->SetOrigin( m_ReferenceImage->GetOrigin() );
+  typename OutputImageType::DirectionType identity;
+  identity.SetIdentity();
+  outputPtr->SetDirection( identity );
+  outputPtr->SetMetaDataDictionary( dict );
+
+  if( m_Geometry != previousGeometry || m_Radii.empty() ||
+      outputPtr->GetOrigin() != m_TableOrigin ||
+      outputPtr->GetLargestPossibleRegion() != m_TableRegion )
+    {
+    this->ComputeTrigonometryTables( outputPtr );
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeTrigonometryTables( const OutputImageType * outputPtr )
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const typename OutputImageType::RegionType & region = outputPtr->GetLargestPossibleRegion();
+  const typename OutputImageType::PointType & origin = outputPtr->GetOrigin();
+  const typename OutputImageType::SpacingType & spacing = outputPtr->GetSpacing();
+  const double Rmin = m_Geometry->GetRmin();
+
+  const unsigned long rSize = region.GetSize()[rDirection];
+  m_Radii.resize( rSize );
+  for( unsigned long i = 0; i < rSize; i++ )
+    {
+    m_Radii[i] = static_cast< TInterpolatorPrecision >( Rmin + origin[rDirection] +
+      spacing[rDirection] * ( region.GetIndex()[rDirection] + static_cast< double >( i ) ) );
+    }
+
+  // A point at unit radius transforms to ( cos theta, sin theta ).  The
+  // transform interpolates non-uniform Theta arrays.
+  const unsigned long thetaSize = region.GetSize()[thetaDirection];
+  m_Cosines.resize( thetaSize );
+  m_Sines.resize( thetaSize );
+  typename TransformType::InputPointType point;
+  point.Fill( 0.0 );
+  point[rDirection] = 1.0 - Rmin;
+  for( unsigned long i = 0; i < thetaSize; i++ )
+    {
+    point[thetaDirection] = origin[thetaDirection] +
+      spacing[thetaDirection] * ( region.GetIndex()[thetaDirection] + static_cast< double >( i ) );
+    const typename TransformType::OutputPointType unit = m_Transform->TransformPoint( point );
+    m_Cosines[i] = unit[rDirection];
+    m_Sines[i] = unit[thetaDirection];
+    }
+
+  m_TableOrigin = origin;
+  m_TableRegion = region;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GenerateInputRequestedRegion()
+{
+  InputImageType * inputPtr = const_cast< InputImageType * >( this->GetInput() );
+  if( !inputPtr )
+    {
+    return;
+    }
+
+  const InputImageRegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+  const OutputImageType * outputPtr = this->GetOutput();
+  const OutputImageRegionType & outputRegion = outputPtr->GetRequestedRegion();
+
+  // The bounds below assume an axis aligned input.
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( outputRegion.GetNumberOfPixels() == 0 || inputPtr->GetDirection() != identity )
+    {
+    inputPtr->SetRequestedRegion( largestRegion );
+    return;
+    }
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const typename OutputImageType::PointType & outputOrigin = outputPtr->GetOrigin();
+  const typename OutputImageType::SpacingType & outputSpacing = outputPtr->GetSpacing();
+  const typename OutputImageRegionType::IndexType & outputLargestIndex =
+    outputPtr->GetLargestPossibleRegion().GetIndex();
+
+  // Physical extent of the output region in the passed through directions.
+  double lower[ImageDimension];
+  double upper[ImageDimension];
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    const double first = outputOrigin[d] + outputSpacing[d] * outputRegion.GetIndex()[d];
+    const double last = first + outputSpacing[d] *
+      ( static_cast< double >( outputRegion.GetSize()[d] ) - 1.0 );
+    lower[d] = vnl_math_min( first, last );
+    upper[d] = vnl_math_max( first, last );
+    }
+
+  // x = r cos( theta ) and y = r sin( theta ) are bilinear in the radius and
+  // the tabulated cosine and sine, so their extremes are at the products of
+  // the extremes.
+  const unsigned long rFirst = outputRegion.GetIndex()[rDirection] - outputLargestIndex[rDirection];
+  const unsigned long rLast = rFirst + outputRegion.GetSize()[rDirection] - 1;
+  const double radii[2] = { m_Radii[rFirst], m_Radii[rLast] };
+  const unsigned long thetaFirst = outputRegion.GetIndex()[thetaDirection] - outputLargestIndex[thetaDirection];
+  const unsigned long thetaLast = thetaFirst + outputRegion.GetSize()[thetaDirection] - 1;
+  double cosines[2] = { m_Cosines[thetaFirst], m_Cosines[thetaFirst] };
+  double sines[2] = { m_Sines[thetaFirst], m_Sines[thetaFirst] };
+  for( unsigned long i = thetaFirst + 1; i <= thetaLast; i++ )
+    {
+    cosines[0] = vnl_math_min( cosines[0], static_cast< double >( m_Cosines[i] ) );
+    cosines[1] = vnl_math_max( cosines[1], static_cast< double >( m_Cosines[i] ) );
+    sines[0] = vnl_math_min( sines[0], static_cast< double >( m_Sines[i] ) );
+    sines[1] = vnl_math_max( sines[1], static_cast< double >( m_Sines[i] ) );
+    }
+  lower[rDirection] = upper[rDirection] = radii[0] * cosines[0];
+  lower[thetaDirection] = upper[thetaDirection] = radii[0] * sines[0];
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    for( unsigned int j = 0; j < 2; j++ )
+      {
+      lower[rDirection] = vnl_math_min( lower[rDirection], radii[i] * cosines[j] );
+      upper[rDirection] = vnl_math_max( upper[rDirection], radii[i] * cosines[j] );
+      lower[thetaDirection] = vnl_math_min( lower[thetaDirection], radii[i] * sines[j] );
+      upper[thetaDirection] = vnl_math_max( upper[thetaDirection], radii[i] * sines[j] );
+      }
+    }
+
+  // Continuous index bounds, widened by one sample on each side for the
+  // interpolation, and cropped.
+  const typename InputImageType::PointType & inputOrigin = inputPtr->GetOrigin();
+  const typename InputImageType::SpacingType & inputSpacing = inputPtr->GetSpacing();
+  typename InputImageType::IndexType index = largestRegion.GetIndex();
+  typename InputImageType::SizeType size = largestRegion.GetSize();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    const double a = ( lower[d] - inputOrigin[d] ) / inputSpacing[d];
+    const double b = ( upper[d] - inputOrigin[d] ) / inputSpacing[d];
+    const double start = largestRegion.GetIndex()[d];
+    const double last = start + static_cast< double >( largestRegion.GetSize()[d] ) - 1.0;
+    const double first = vnl_math_min( vnl_math_max( vcl_floor( vnl_math_min( a, b ) ) - 1.0, start ), last );
+    const double end = vnl_math_min( vnl_math_max( vcl_ceil( vnl_math_max( a, b ) ) + 1.0, start ), last );
+    if( !( first <= end ) )
+      {
+      continue;
+      }
+    index[d] = static_cast< long >( first );
+    size[d] = static_cast< unsigned long >( end - first ) + 1;
+    }
+
+  InputImageRegionType inputRegion;
+  inputRegion.SetIndex( index );
+  inputRegion.SetSize( size );
+  inputPtr->SetRequestedRegion( inputRegion );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::BeforeThreadedGenerateData()
+{
+  m_Interpolator->SetInputImage( this->GetInput() );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeSliceNeighbors( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  std::vector< long >& offsets,
+  std::vector< TInterpolatorPrecision >& weights ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+
+  offsets.clear();
+  weights.clear();
+
+  // The transform passes the other directions through unchanged.
+  typedef typename TransformType::InputPointType PointType;
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  PointType point;
+  outputPtr->TransformIndexToPhysicalPoint( lineIndex, point );
+  ContinuousIndexType inputIndex;
+  inputPtr->TransformPhysicalPointToContinuousIndex( point, inputIndex );
+
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  inputIndex[rDirection] = bufferedRegion.GetIndex()[rDirection];
+  inputIndex[thetaDirection] = bufferedRegion.GetIndex()[thetaDirection];
+  if( !m_Interpolator->IsInsideBuffer( inputIndex ) )
+    {
+    return;
+    }
+
+  // Linear interpolation between the neighboring slices, clamped to the
+  // buffer the same way as LinearInterpolateImageFunction.
+  const typename InputImageType::IndexType & startIndex = m_Interpolator->GetStartIndex();
+  const typename InputImageType::IndexType & endIndex = m_Interpolator->GetEndIndex();
+  typename InputImageType::IndexType baseIndex;
+  TInterpolatorPrecision distance[ImageDimension];
+  unsigned int passThroughDirections[ImageDimension];
+  unsigned int numberOfPassThrough = 0;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d == rDirection || d == thetaDirection )
+      {
+      baseIndex[d] = bufferedRegion.GetIndex()[d];
+      distance[d] = 0.0;
+      continue;
+      }
+    baseIndex[d] = static_cast< long >( vcl_floor( inputIndex[d] ) );
+    distance[d] = inputIndex[d] - static_cast< TInterpolatorPrecision >( baseIndex[d] );
+    passThroughDirections[numberOfPassThrough++] = d;
+    }
+
+  const unsigned int numberOfNeighbors = 1 << numberOfPassThrough;
+  typename InputImageType::IndexType neighborIndex;
+  for( unsigned int counter = 0; counter < numberOfNeighbors; counter++ )
+    {
+    neighborIndex = baseIndex;
+    TInterpolatorPrecision overlap = 1.0;
+    for( unsigned int j = 0; j < numberOfPassThrough; j++ )
+      {
+      const unsigned int d = passThroughDirections[j];
+      if( counter & ( 1 << j ) )
+        {
+        neighborIndex[d] = vnl_math_min( baseIndex[d] + 1, endIndex[d] );
+        overlap *= distance[d];
+        }
+      else
+        {
+        neighborIndex[d] = vnl_math_max( baseIndex[d], startIndex[d] );
+        overlap *= 1.0 - distance[d];
+        }
+      }
+    if( overlap != 0.0 )
+      {
+      offsets.push_back( inputPtr->ComputeOffset( neighborIndex ) );
+      weights.push_back( overlap );
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId )
+{
+  const InputImageType * inputPtr = this->GetInput();
+  OutputImageType * outputPtr = this->GetOutput();
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+
+  typedef typename InputImageType::PixelType InputPixelType;
+  const InputPixelType * inputBuffer = inputPtr->GetBufferPointer();
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  const typename InputImageType::SizeType & inputSize = bufferedRegion.GetSize();
+  // x is stored along the RDirection and y along the ThetaDirection of the
+  // input.  Neighbors in a direction with a single sample carry zero weight.
+  const long xOffset = inputPtr->GetOffsetTable()[rDirection];
+  const long yOffset = inputPtr->GetOffsetTable()[thetaDirection];
+  const long xStep = inputSize[rDirection] > 1 ? xOffset : 0;
+  const long yStep = inputSize[thetaDirection] > 1 ? yOffset : 0;
+
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
+  const unsigned long lineLength = outputRegionForThread.GetSize()[lineDirection];
+  const typename OutputImageType::IndexType & largestIndex = outputPtr->GetLargestPossibleRegion().GetIndex();
+  const unsigned long radiusStep = ( lineDirection == rDirection ) ? 1 : 0;
+  const unsigned long angleStep = 1 - radiusStep;
+
+  OutputPixelType * outputBuffer = outputPtr->GetBufferPointer();
+  const long outputStep = outputPtr->GetOffsetTable()[lineDirection];
+
+  const double minOutputValue = static_cast< double >( NumericTraits< OutputPixelType >::NonpositiveMin() );
+  const double maxOutputValue = static_cast< double >( NumericTraits< OutputPixelType >::max() );
+
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  const ContinuousIndexType & startIndex = m_Interpolator->GetStartContinuousIndex();
+  const ContinuousIndexType & endIndex = m_Interpolator->GetEndContinuousIndex();
+  const TInterpolatorPrecision xLow = startIndex[rDirection];
+  const TInterpolatorPrecision xHigh = endIndex[rDirection];
+  const TInterpolatorPrecision yLow = startIndex[thetaDirection];
+  const TInterpolatorPrecision yHigh = endIndex[thetaDirection];
+  const TInterpolatorPrecision xScale = 1.0 / inputPtr->GetSpacing()[rDirection];
+  const TInterpolatorPrecision yScale = 1.0 / inputPtr->GetSpacing()[thetaDirection];
+  const TInterpolatorPrecision xShift = -inputPtr->GetOrigin()[rDirection] * xScale;
+  const TInterpolatorPrecision yShift = -inputPtr->GetOrigin()[thetaDirection] * yScale;
+  const long xStart = bufferedRegion.GetIndex()[rDirection];
+  const long yStart = bufferedRegion.GetIndex()[thetaDirection];
+
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  const bool axisAligned = ( inputPtr->GetDirection() == identity );
+
+  std::vector< long > sliceOffsets;
+  std::vector< TInterpolatorPrecision > sliceWeights;
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  typedef ImageLinearIteratorWithIndex< OutputImageType > OutputIteratorType;
+  OutputIteratorType outIt( outputPtr, outputRegionForThread );
+  outIt.SetDirection( lineDirection );
+  for( outIt.GoToBegin(); !outIt.IsAtEnd(); outIt.NextLine() )
+    {
+    const typename OutputImageType::IndexType & lineIndex = outIt.GetIndex();
+    OutputPixelType * out = outputBuffer + outputPtr->ComputeOffset( lineIndex );
+    const TInterpolatorPrecision * radius = &m_Radii[lineIndex[rDirection] - largestIndex[rDirection]];
+    const TInterpolatorPrecision * cosine = &m_Cosines[lineIndex[thetaDirection] - largestIndex[thetaDirection]];
+    const TInterpolatorPrecision * sine = &m_Sines[lineIndex[thetaDirection] - largestIndex[thetaDirection]];
+
+    if( axisAligned )
+      {
+      this->ComputeSliceNeighbors( inputPtr, outputPtr, lineIndex, sliceOffsets, sliceWeights );
+      }
+    const unsigned int numberOfSlices = sliceOffsets.size();
+
+    typename TransformType::OutputPointType point;
+    outputPtr->TransformIndexToPhysicalPoint( lineIndex, point );
+    ContinuousIndexType inputIndex;
+
+    for( unsigned long i = 0; i < lineLength; i++ )
+      {
+      const TInterpolatorPrecision r = radius[i * radiusStep];
+      const TInterpolatorPrecision x = r * cosine[i * angleStep];
+      const TInterpolatorPrecision y = r * sine[i * angleStep];
+      double value;
+      bool inside;
+      if( axisAligned )
+        {
+        const TInterpolatorPrecision xIndex = x * xScale + xShift;
+        const TInterpolatorPrecision yIndex = y * yScale + yShift;
+        inside = numberOfSlices > 0 &&
+          xIndex >= xLow && xIndex < xHigh && yIndex >= yLow && yIndex < yHigh;
+        value = 0.0;
+        if( inside )
+          {
+          int xNeighbor;
+          int yNeighbor;
+          TInterpolatorPrecision xWeight;
+          TInterpolatorPrecision yWeight;
+          RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( xIndex,
+            xStart, inputSize[rDirection], xNeighbor, xWeight );
+          RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( yIndex,
+            yStart, inputSize[thetaDirection], yNeighbor, yWeight );
+          const long planeOffset = xNeighbor * xOffset + yNeighbor * yOffset;
+          for( unsigned int slice = 0; slice < numberOfSlices; slice++ )
+            {
+            const InputPixelType * p = inputBuffer + sliceOffsets[slice] + planeOffset;
+            const TInterpolatorPrecision lower = ( 1.0 - xWeight ) * p[0] + xWeight * p[xStep];
+            const TInterpolatorPrecision upper = ( 1.0 - xWeight ) * p[yStep] + xWeight * p[yStep + xStep];
+            value += sliceWeights[slice] * ( ( 1.0 - yWeight ) * lower + yWeight * upper );
+            }
+          }
+        }
+      else
+        {
+        point[rDirection] = x;
+        point[thetaDirection] = y;
+        inputPtr->TransformPhysicalPointToContinuousIndex( point, inputIndex );
+        inside = m_Interpolator->IsInsideBuffer( inputIndex );
+        value = inside ? static_cast< double >( m_Interpolator->EvaluateAtContinuousIndex( inputIndex ) ) : 0.0;
+        }
+
+      if( !inside )
+        {
+        *out = m_DefaultPixelValue;
+        }
+      else if( value < minOutputValue )
+        {
+        *out = NumericTraits< OutputPixelType >::NonpositiveMin();
+        }
+      else if( value > maxOutputValue )
+        {
+        *out = NumericTraits< OutputPixelType >::max();
+        }
+      else
+        {
+        *out = static_cast< OutputPixelType >( value );
+        }
+      out += outputStep;
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleCartesianToRThetaImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "ReferenceImage: " << m_ReferenceImage.GetPointer() << std::endl;
+  os << indent << "RDirection: " << m_RDirection << std::endl;
+  os << indent << "ThetaDirection: " << m_ThetaDirection << std::endl;
+  os << indent << "DefaultPixelValue: "
+     << static_cast< typename NumericTraits< OutputPixelType >::PrintType >( m_DefaultPixelValue ) << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkResampleCartesianToRThetaImageFilter_txx
@@ -0,0 +1,186 @@
+#ifndef __itkResampleRThetaPhiToCartesianImageFilter_h
+#define __itkResampleRThetaPhiToCartesianImageFilter_h
+
+#include "itkImageToImageFilter.h"
+
+#include "itkCartesianToRThetaPhiTransform.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkRThetaScanGeometry.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** @brief Scan convert a volume that was acquired in (R, Theta, Phi) space,
+ * e.g. by a mechanically swept curvilinear array or a matrix array, in a
+ * single pass.
+ *
+ *  Properties:
+ *  RDirection, ThetaDirection, PhiDirection
+ *    The directions in the input image assumed to correspond to the radial,
+ *    angular (theta), and elevation angle (phi) components.  Default to 0,
+ *    1, and 2.
+ *
+ * The input needs the MetaDataDictionary entries of
+ * ResampleRThetaToCartesianImageFilter and "Phi", "PhiBinary", or
+ * "PhiString", the angle in radians of every frame in the PhiDirection, in
+ * the same formats as Theta.  "PhiRadius" or "PhiRadiusString", the
+ * distance from the center of the theta rotation to the phi axis, defaults
+ * to 0.  See CartesianToRThetaPhiTransform for the geometry.
+ *
+ * The output covers the bounding box of the imaging volume, with x along the
+ * RDirection, y along the ThetaDirection, and z along the PhiDirection.  Its
+ * spacing in the ThetaDirection and PhiDirection is OutputSpacingTheta and
+ * OutputSpacingPhi, or half of the input spacing if they are not set; in the
+ * RDirection it is the input spacing.  Other directions, e.g. time, are
+ * passed through sample for sample.  Output pixels outside of the imaging
+ * volume are set to the DefaultPixelValue.
+ *
+ * The conversion is multithreaded and interpolates trilinearly.  The distance
+ * from the phi axis and the phi coordinate of every output column, an (x, z)
+ * pair, are tabulated when the geometry changes.  Each output line along x
+ * then costs one call to CartesianToRThetaTransform::TransformRThetaCoordinates()
+ * for r and theta.  Lines beyond Rmax from the theta axis are skipped.
+ * Inputs with a non-identity direction are transformed and interpolated point
+ * by point.  Because a line crosses every frame, the input requested region
+ * spans the whole (R, Theta, Phi) extent of the input.
+ */
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision = double >
+class ITK_EXPORT ResampleRThetaPhiToCartesianImageFilter :
+  public ImageToImageFilter< TInputImage, TOutputImage >
+{
+public:
+  /** Standard "Self" typedef.   */
+  typedef ResampleRThetaPhiToCartesianImageFilter Self;
+
+  /** Standard super class typedef support. */
+  typedef ImageToImageFilter< TInputImage, TOutputImage > Superclass;
+
+  /** Smart pointer typedef support  */
+  typedef SmartPointer< Self > Pointer;
+  typedef SmartPointer< const Self > ConstPointer;
+
+  /**Typedefs from the superclass */
+  typedef typename Superclass::InputImageType  InputImageType;
+  typedef typename Superclass::OutputImageType OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+
+  /** Run-time type information (and related methods) */
+  itkTypeMacro( ResampleRThetaPhiToCartesianImageFilter, ImageToImageFilter );
+
+  /** Method for creation through the object factory. */
+  itkNewMacro( Self );
+
+  /** Dimension of the image, at least 3. */
+  itkStaticConstMacro( ImageDimension, unsigned int, TInputImage::ImageDimension );
+
+  /** The direction in the input image that corresponds to the radial
+   * component. */
+  itkSetMacro( RDirection, unsigned int );
+  itkGetConstMacro( RDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the angular (theta)
+   * component. */
+  itkSetMacro( ThetaDirection, unsigned int );
+  itkGetConstMacro( ThetaDirection, unsigned int );
+
+  /** The direction in the input image that corresponds to the elevation
+   * angle (phi) component. */
+  itkSetMacro( PhiDirection, unsigned int );
+  itkGetConstMacro( PhiDirection, unsigned int );
+
+  /** Tolerated error of both angles, as a fraction of their sample spacing.
+   * See CartesianToRThetaTransform::SetThetaTolerance(). */
+  itkSetMacro( ThetaTolerance, double );
+  itkGetConstMacro( ThetaTolerance, double );
+
+  /** The output spacing in the ThetaDirection and the PhiDirection.  If not
+   * set, half of the input spacing is used. */
+  itkSetMacro( OutputSpacingTheta, double );
+  itkGetConstMacro( OutputSpacingTheta, double );
+  itkSetMacro( OutputSpacingPhi, double );
+  itkGetConstMacro( OutputSpacingPhi, double );
+
+  virtual void SetDefaultPixelValue( OutputPixelType defaultValue )
+    {
+    m_DefaultPixelValue = defaultValue;
+    this->Modified();
+    }
+  itkGetConstMacro( DefaultPixelValue, OutputPixelType );
+
+  /** Scan geometry type, for the Radius and the Theta array. */
+  typedef itk::RThetaScanGeometry< TInterpolatorPrecision, ImageDimension > GeometryType;
+
+  /** Transform type. */
+  typedef itk::CartesianToRThetaPhiTransform< TInterpolatorPrecision, ImageDimension > TransformType;
+
+  /** The transform of the last output information update. */
+  const TransformType * GetTransform() const
+    {
+    return m_Transform.GetPointer();
+    }
+
+protected:
+  ResampleRThetaPhiToCartesianImageFilter();
+  ~ResampleRThetaPhiToCartesianImageFilter() {}
+
+  void PrintSelf( std::ostream& os, Indent indent ) const;
+
+  /** Standard process object method. */
+  virtual void GenerateOutputInformation();
+  virtual void GenerateInputRequestedRegion();
+
+  virtual void BeforeThreadedGenerateData();
+  virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId );
+
+  typedef itk::LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecision > InterpolatorType;
+
+  /** Tabulate the distance from the theta axis in the frame, u, and the
+   * PhiDirection coordinate of every column of the output's largest
+   * possible region.  u is negative where the column is behind the phi
+   * axis or the theta axis. */
+  void ComputeColumnTable( const OutputImageType * outputPtr );
+
+private:
+  ResampleRThetaPhiToCartesianImageFilter( const Self& ); // purposely not implemented
+  void operator=( const Self& ); // purposely not implemented
+
+  unsigned int m_RDirection;
+  unsigned int m_ThetaDirection;
+  unsigned int m_PhiDirection;
+  double       m_ThetaTolerance;
+  double       m_OutputSpacingTheta;
+  double       m_OutputSpacingPhi;
+
+  OutputPixelType m_DefaultPixelValue;
+
+  /** The shared (R, Theta) geometry, and the transform built from it and
+   * the Phi entries, set in GenerateOutputInformation(). */
+  typename GeometryType::ConstPointer m_Geometry;
+  typename TransformType::Pointer     m_Transform;
+  Array< double >                     m_PhiArray;
+  double                              m_PhiRadius;
+  double                              m_SpacingPhi;
+
+  typename InterpolatorType::Pointer m_Interpolator;
+
+  /** u and the PhiDirection coordinate of every output column, indexed by
+   * the RDirection fastest, valid for the output grid below.  Cleared when
+   * m_Transform is rebuilt. */
+  std::vector< TInterpolatorPrecision > m_ColumnDistances;
+  std::vector< TInterpolatorPrecision > m_ColumnPhis;
+  typename OutputImageType::PointType   m_TableOrigin;
+  typename OutputImageType::SpacingType m_TableSpacing;
+  typename OutputImageType::RegionType  m_TableRegion;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkResampleRThetaPhiToCartesianImageFilter.txx"
+#endif
+
+#endif // __itkResampleRThetaPhiToCartesianImageFilter_h
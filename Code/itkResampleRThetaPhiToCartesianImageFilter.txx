@@ -0,0 +1,474 @@
+#ifndef __itkResampleRThetaPhiToCartesianImageFilter_txx
+#define __itkResampleRThetaPhiToCartesianImageFilter_txx
+
+#include "itkResampleRThetaPhiToCartesianImageFilter.h"
+
+#include "itkImageLinearIteratorWithIndex.h"
+#include "itkNumericTraits.h"
+#include "itkProgressReporter.h"
+#include "itkRThetaToCartesianLookupTable.h"
+
+#include "vnl/vnl_math.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ResampleRThetaPhiToCartesianImageFilter():
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_PhiDirection( 2 ),
+  m_ThetaTolerance( 0.0 ),
+  m_OutputSpacingTheta( 0.0 ),
+  m_OutputSpacingPhi( 0.0 ),
+  m_DefaultPixelValue( NumericTraits< OutputPixelType >::Zero ),
+  m_PhiRadius( 0.0 ),
+  m_SpacingPhi( 0.0 )
+{
+  m_Interpolator = InterpolatorType::New();
+  m_TableOrigin.Fill( 0.0 );
+  m_TableSpacing.Fill( 0.0 );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GenerateOutputInformation()
+{
+  typename InputImageType::ConstPointer inputPtr = this->GetInput();
+  typename OutputImageType::Pointer     outputPtr = this->GetOutput();
+
+  if ( !inputPtr || !outputPtr )
+    {
+    return;
+    }
+  if( ImageDimension < 3 )
+    {
+    itkExceptionMacro( "The input needs an RDirection, a ThetaDirection, and a PhiDirection." );
+    }
+
+  // Radius and Theta from the shared geometry cache.
+  const MetaDataDictionary & dict = inputPtr->GetMetaDataDictionary();
+  const typename InputImageType::SpacingType & spacing = inputPtr->GetSpacing();
+  const InputImageRegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+  const typename InputImageType::SizeType & size = largestRegion.GetSize();
+  typename GeometryType::ConstPointer previousGeometry = m_Geometry;
+  if( m_Geometry.IsNull() ||
+      !m_Geometry->Matches( dict, spacing, size, m_RDirection, m_ThetaDirection, m_OutputSpacingTheta ) )
+    {
+    m_Geometry = GeometryType::GetGeometry( dict, spacing, size,
+      m_RDirection, m_ThetaDirection, m_OutputSpacingTheta );
+    }
+
+  Array< double > phi;
+  if( !GeometryType::ReadRealArray( dict, "Phi", phi ) )
+    {
+    itkExceptionMacro( "Could not find 'Phi' MetaDataDictionary entry to perform RThetaPhi transform." );
+    }
+  if( phi.Size() < 2 )
+    {
+    itkExceptionMacro( "The 'Phi' MetaDataDictionary entry needs at least two angles." );
+    }
+  double phiRadius = 0.0;
+  GeometryType::ReadReal( dict, "PhiRadius", phiRadius );
+
+  // The transform, and the column table that depends on it, are only
+  // rebuilt when the geometry changes.
+  const double spacingPhi = spacing[m_PhiDirection];
+  if( m_Transform.IsNull() || m_Geometry != previousGeometry ||
+      phi != m_PhiArray || phiRadius != m_PhiRadius || spacingPhi != m_SpacingPhi ||
+      m_Transform->GetThetaTolerance() != m_ThetaTolerance ||
+      m_Transform->GetRDirection() != m_RDirection ||
+      m_Transform->GetThetaDirection() != m_ThetaDirection ||
+      m_Transform->GetPhiDirection() != m_PhiDirection )
+    {
+    typename TransformType::Pointer transform = TransformType::New();
+    transform->SetRDirection( m_RDirection );
+    transform->SetThetaDirection( m_ThetaDirection );
+    transform->SetPhiDirection( m_PhiDirection );
+    transform->SetRmin( m_Geometry->GetRmin() );
+    transform->SetRmax( m_Geometry->GetRmax() );
+    transform->SetPhiRadius( phiRadius );
+    transform->SetSpacingTheta( spacing[m_ThetaDirection] );
+    transform->SetThetaArray( m_Geometry->GetTransform()->GetThetaArray() );
+    transform->SetSpacingPhi( spacingPhi );
+    transform->SetPhiArray( phi );
+    transform->SetThetaTolerance( m_ThetaTolerance );
+    m_Transform = transform;
+    m_PhiArray = phi;
+    m_PhiRadius = phiRadius;
+    m_SpacingPhi = spacingPhi;
+    m_ColumnDistances.clear();
+    m_ColumnPhis.clear();
+    }
+
+  // Bounding box of the volume.  x and z are monotonic in r cos( theta ),
+  // cos( phi ), and sin( phi ), and y in r and sin( theta ), so the extremes
+  // are at the extreme radii and angles, or at an angle of 0.
+  const Array< double > & theta = m_Geometry->GetTransform()->GetThetaArray();
+  double thetas[3] = { theta.min_value(), theta.max_value(), 0.0 };
+  const unsigned int numberOfThetas = ( thetas[0] < 0.0 && thetas[1] > 0.0 ) ? 3 : 2;
+  double phis[3] = { phi.min_value(), phi.max_value(), 0.0 };
+  const unsigned int numberOfPhis = ( phis[0] < 0.0 && phis[1] > 0.0 ) ? 3 : 2;
+  const double radii[2] = { m_Geometry->GetRmin(), m_Geometry->GetRmax() };
+  double lower[3];
+  double upper[3];
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    lower[i] = NumericTraits< double >::max();
+    upper[i] = NumericTraits< double >::NonpositiveMin();
+    }
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    for( unsigned int j = 0; j < numberOfThetas; j++ )
+      {
+      const double u = radii[i] * vcl_cos( thetas[j] );
+      const double y = radii[i] * vcl_sin( thetas[j] );
+      for( unsigned int k = 0; k < numberOfPhis; k++ )
+        {
+        const double corner[3] = {
+          ( u + phiRadius ) * vcl_cos( phis[k] ) - phiRadius,
+          y,
+          ( u + phiRadius ) * vcl_sin( phis[k] ) };
+        for( unsigned int d = 0; d < 3; d++ )
+          {
+          lower[d] = vnl_math_min( lower[d], corner[d] );
+          upper[d] = vnl_math_max( upper[d], corner[d] );
+          }
+        }
+      }
+    }
+
+  // The other directions are passed through.
+  typename OutputImageType::SpacingType outputSpacing = spacing;
+  outputSpacing[m_ThetaDirection] = ( m_OutputSpacingTheta == 0.0 ) ?
+    spacing[m_ThetaDirection] / 2. : m_OutputSpacingTheta;
+  outputSpacing[m_PhiDirection] = ( m_OutputSpacingPhi == 0.0 ) ?
+    spacing[m_PhiDirection] / 2. : m_OutputSpacingPhi;
+  typename OutputImageType::PointType outputOrigin = inputPtr->GetOrigin();
+  typename OutputImageType::IndexType outputIndex = largestRegion.GetIndex();
+  typename OutputImageType::SizeType outputSize = size;
+  const unsigned int volumeDirections[3] = { m_RDirection, m_ThetaDirection, m_PhiDirection };
+  for( unsigned int i = 0; i < 3; i++ )
+    {
+    const unsigned int d = volumeDirections[i];
+    outputOrigin[d] = lower[i];
+    outputIndex[d] = 0;
+    outputSize[d] = vnl_math_max( static_cast< unsigned long >(
+        vcl_ceil( ( upper[i] - lower[i] ) / outputSpacing[d] ) ), 1ul );
+    }
+
+  typename OutputImageType::RegionType outputRegion;
+  outputRegion.SetIndex( outputIndex );
+  outputRegion.SetSize( outputSize );
+  outputPtr->SetLargestPossibleRegion( outputRegion );
+  outputPtr->SetSpacing( outputSpacing );
+  outputPtr->SetOrigin( outputOrigin );
+  typename OutputImageType::DirectionType identity;
+  identity.SetIdentity();
+  outputPtr->SetDirection( identity );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GenerateInputRequestedRegion()
+{
+  InputImageType * inputPtr = const_cast< InputImageType * >( this->GetInput() );
+  if( !inputPtr )
+    {
+    return;
+    }
+
+  // The whole (R, Theta, Phi) extent, and the output requested region in
+  // the passed through directions, which map sample for sample.
+  const InputImageRegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+  const OutputImageRegionType & outputRegion = this->GetOutput()->GetRequestedRegion();
+  typename InputImageType::IndexType index = largestRegion.GetIndex();
+  typename InputImageType::SizeType size = largestRegion.GetSize();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d != m_RDirection && d != m_ThetaDirection && d != m_PhiDirection )
+      {
+      index[d] = outputRegion.GetIndex()[d];
+      size[d] = outputRegion.GetSize()[d];
+      }
+    }
+  InputImageRegionType inputRegion;
+  inputRegion.SetIndex( index );
+  inputRegion.SetSize( size );
+  inputRegion.Crop( largestRegion );
+  inputPtr->SetRequestedRegion( inputRegion );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeColumnTable( const OutputImageType * outputPtr )
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int phiDirection = m_PhiDirection;
+  const typename OutputImageType::RegionType & region = outputPtr->GetLargestPossibleRegion();
+  const typename OutputImageType::PointType & origin = outputPtr->GetOrigin();
+  const typename OutputImageType::SpacingType & spacing = outputPtr->GetSpacing();
+  const unsigned long xSize = region.GetSize()[rDirection];
+  const unsigned long zSize = region.GetSize()[phiDirection];
+  const TInterpolatorPrecision phiRadius = m_PhiRadius;
+
+  m_ColumnDistances.resize( xSize * zSize );
+  m_ColumnPhis.resize( xSize * zSize );
+  std::vector< TInterpolatorPrecision > shifted( xSize );
+  std::vector< TInterpolatorPrecision > z( xSize );
+  for( unsigned long i = 0; i < xSize; i++ )
+    {
+    shifted[i] = origin[rDirection] + phiRadius +
+      spacing[rDirection] * ( region.GetIndex()[rDirection] + static_cast< double >( i ) );
+    }
+  for( unsigned long k = 0; k < zSize; k++ )
+    {
+    const TInterpolatorPrecision zk = origin[phiDirection] +
+      spacing[phiDirection] * ( region.GetIndex()[phiDirection] + static_cast< double >( k ) );
+    std::fill( z.begin(), z.end(), zk );
+    TInterpolatorPrecision * distance = &m_ColumnDistances[k * xSize];
+    m_Transform->GetPhiTransform()->TransformRThetaCoordinates( &shifted[0], &z[0],
+      distance, &m_ColumnPhis[k * xSize], xSize );
+    for( unsigned long i = 0; i < xSize; i++ )
+      {
+      // Columns behind the phi axis have no valid angle.
+      distance[i] = ( shifted[i] > 0.0 ) ? distance[i] - phiRadius : -1.0;
+      }
+    }
+
+  m_TableOrigin = origin;
+  m_TableSpacing = spacing;
+  m_TableRegion = region;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::BeforeThreadedGenerateData()
+{
+  m_Interpolator->SetInputImage( this->GetInput() );
+
+  const OutputImageType * outputPtr = this->GetOutput();
+  if( m_ColumnDistances.empty() ||
+      outputPtr->GetOrigin() != m_TableOrigin ||
+      outputPtr->GetSpacing() != m_TableSpacing ||
+      outputPtr->GetLargestPossibleRegion() != m_TableRegion )
+    {
+    this->ComputeColumnTable( outputPtr );
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId )
+{
+  const InputImageType * inputPtr = this->GetInput();
+  OutputImageType * outputPtr = this->GetOutput();
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const unsigned int phiDirection = m_PhiDirection;
+
+  typedef typename InputImageType::PixelType InputPixelType;
+  const InputPixelType * inputBuffer = inputPtr->GetBufferPointer();
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  const typename InputImageType::SizeType & inputSize = bufferedRegion.GetSize();
+  const typename InputImageType::OffsetValueType * inputOffsets = inputPtr->GetOffsetTable();
+  // Neighbors in a direction with a single sample carry zero weight.
+  const long rOffset = inputOffsets[rDirection];
+  const long thetaOffset = inputOffsets[thetaDirection];
+  const long phiOffset = inputOffsets[phiDirection];
+  const long rStep = inputSize[rDirection] > 1 ? rOffset : 0;
+  const long thetaStep = inputSize[thetaDirection] > 1 ? thetaOffset : 0;
+  const long phiStep = inputSize[phiDirection] > 1 ? phiOffset : 0;
+
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  const ContinuousIndexType & startIndex = m_Interpolator->GetStartContinuousIndex();
+  const ContinuousIndexType & endIndex = m_Interpolator->GetEndContinuousIndex();
+  const TInterpolatorPrecision rLow = startIndex[rDirection];
+  const TInterpolatorPrecision rHigh = endIndex[rDirection];
+  const TInterpolatorPrecision thetaLow = startIndex[thetaDirection];
+  const TInterpolatorPrecision thetaHigh = endIndex[thetaDirection];
+  const TInterpolatorPrecision phiLow = startIndex[phiDirection];
+  const TInterpolatorPrecision phiHigh = endIndex[phiDirection];
+  const typename InputImageType::SpacingType & inputSpacing = inputPtr->GetSpacing();
+  const typename InputImageType::PointType & inputOrigin = inputPtr->GetOrigin();
+  const TInterpolatorPrecision rScale = 1.0 / inputSpacing[rDirection];
+  const TInterpolatorPrecision thetaScale = 1.0 / inputSpacing[thetaDirection];
+  const TInterpolatorPrecision phiScale = 1.0 / inputSpacing[phiDirection];
+  const TInterpolatorPrecision rShift = -inputOrigin[rDirection] * rScale;
+  const TInterpolatorPrecision thetaShift = -inputOrigin[thetaDirection] * thetaScale;
+  const TInterpolatorPrecision phiShift = -inputOrigin[phiDirection] * phiScale;
+  const long rStart = bufferedRegion.GetIndex()[rDirection];
+  const long thetaStart = bufferedRegion.GetIndex()[thetaDirection];
+  const long phiStart = bufferedRegion.GetIndex()[phiDirection];
+
+  const unsigned long lineLength = outputRegionForThread.GetSize()[rDirection];
+  const typename OutputImageType::RegionType & largestRegion = outputPtr->GetLargestPossibleRegion();
+  const unsigned long columnStride = largestRegion.GetSize()[rDirection];
+  const double thetaOrigin = outputPtr->GetOrigin()[thetaDirection];
+  const double thetaSpacing = outputPtr->GetSpacing()[thetaDirection];
+  const double Rmax = m_Geometry->GetRmax();
+
+  OutputPixelType * outputBuffer = outputPtr->GetBufferPointer();
+  const long outputStep = outputPtr->GetOffsetTable()[rDirection];
+
+  const double minOutputValue = static_cast< double >( NumericTraits< OutputPixelType >::NonpositiveMin() );
+  const double maxOutputValue = static_cast< double >( NumericTraits< OutputPixelType >::max() );
+
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  const bool axisAligned = ( inputPtr->GetDirection() == identity );
+
+  const typename TransformType::ComponentTransformType * rThetaTransform = m_Transform->GetRThetaTransform();
+  std::vector< TInterpolatorPrecision > y( lineLength );
+  std::vector< TInterpolatorPrecision > rCoordinates( lineLength );
+  std::vector< TInterpolatorPrecision > thetaCoordinates( lineLength );
+
+  ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() );
+
+  typedef ImageLinearIteratorWithIndex< OutputImageType > OutputIteratorType;
+  OutputIteratorType outIt( outputPtr, outputRegionForThread );
+  outIt.SetDirection( rDirection );
+  for( outIt.GoToBegin(); !outIt.IsAtEnd(); outIt.NextLine() )
+    {
+    const typename OutputImageType::IndexType & lineIndex = outIt.GetIndex();
+    OutputPixelType * out = outputBuffer + outputPtr->ComputeOffset( lineIndex );
+    const double lineY = thetaOrigin + thetaSpacing * lineIndex[thetaDirection];
+
+    // A line beyond Rmax from the theta axis misses the volume.
+    if( vnl_math_abs( lineY ) > Rmax )
+      {
+      for( unsigned long i = 0; i < lineLength; i++ )
+        {
+        *out = m_DefaultPixelValue;
+        out += outputStep;
+        progress.CompletedPixel();
+        }
+      continue;
+      }
+
+    const unsigned long column = ( lineIndex[phiDirection] - largestRegion.GetIndex()[phiDirection] ) * columnStride +
+      lineIndex[rDirection] - largestRegion.GetIndex()[rDirection];
+    const TInterpolatorPrecision * distance = &m_ColumnDistances[column];
+    const TInterpolatorPrecision * phi = &m_ColumnPhis[column];
+
+    // The passed through directions map sample for sample.
+    const InputPixelType * slice = inputBuffer;
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( d != rDirection && d != thetaDirection && d != phiDirection )
+        {
+        slice += ( lineIndex[d] - bufferedRegion.GetIndex()[d] ) * inputOffsets[d];
+        }
+      }
+
+    if( axisAligned )
+      {
+      std::fill( y.begin(), y.end(), static_cast< TInterpolatorPrecision >( lineY ) );
+      rThetaTransform->TransformRThetaCoordinates( distance, &y[0],
+        &rCoordinates[0], &thetaCoordinates[0], lineLength );
+      }
+
+    typename OutputImageType::PointType point;
+    ContinuousIndexType inputIndex;
+    for( unsigned long i = 0; i < lineLength; i++ )
+      {
+      bool inside = distance[i] > 0.0;
+      double value = 0.0;
+      if( inside && axisAligned )
+        {
+        const TInterpolatorPrecision rIndex = rCoordinates[i] * rScale + rShift;
+        const TInterpolatorPrecision thetaIndex = thetaCoordinates[i] * thetaScale + thetaShift;
+        const TInterpolatorPrecision phiIndex = phi[i] * phiScale + phiShift;
+        inside = rIndex >= rLow && rIndex < rHigh &&
+          thetaIndex >= thetaLow && thetaIndex < thetaHigh &&
+          phiIndex >= phiLow && phiIndex < phiHigh;
+        if( inside )
+          {
+          int rNeighbor;
+          int thetaNeighbor;
+          int phiNeighbor;
+          TInterpolatorPrecision rWeight;
+          TInterpolatorPrecision thetaWeight;
+          TInterpolatorPrecision phiWeight;
+          RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( rIndex,
+            rStart, inputSize[rDirection], rNeighbor, rWeight );
+          RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( thetaIndex,
+            thetaStart, inputSize[thetaDirection], thetaNeighbor, thetaWeight );
+          RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( phiIndex,
+            phiStart, inputSize[phiDirection], phiNeighbor, phiWeight );
+          const InputPixelType * p = slice + rNeighbor * rOffset +
+            thetaNeighbor * thetaOffset + phiNeighbor * phiOffset;
+          TInterpolatorPrecision frame[2];
+          for( unsigned int j = 0; j < 2; j++ )
+            {
+            const InputPixelType * q = p + j * phiStep;
+            const TInterpolatorPrecision lower = ( 1.0 - rWeight ) * q[0] + rWeight * q[rStep];
+            const TInterpolatorPrecision upper = ( 1.0 - rWeight ) * q[thetaStep] + rWeight * q[thetaStep + rStep];
+            frame[j] = ( 1.0 - thetaWeight ) * lower + thetaWeight * upper;
+            }
+          value = ( 1.0 - phiWeight ) * frame[0] + phiWeight * frame[1];
+          }
+        }
+      else if( inside )
+        {
+        typename OutputImageType::IndexType index = lineIndex;
+        index[rDirection] += i;
+        outputPtr->TransformIndexToPhysicalPoint( index, point );
+        inputPtr->TransformPhysicalPointToContinuousIndex(
+          m_Transform->TransformPoint( point ), inputIndex );
+        inside = m_Interpolator->IsInsideBuffer( inputIndex );
+        value = inside ? static_cast< double >( m_Interpolator->EvaluateAtContinuousIndex( inputIndex ) ) : 0.0;
+        }
+
+      if( !inside )
+        {
+        *out = m_DefaultPixelValue;
+        }
+      else if( value < minOutputValue )
+        {
+        *out = NumericTraits< OutputPixelType >::NonpositiveMin();
+        }
+      else if( value > maxOutputValue )
+        {
+        *out = NumericTraits< OutputPixelType >::max();
+        }
+      else
+        {
+        *out = static_cast< OutputPixelType >( value );
+        }
+      out += outputStep;
+      progress.CompletedPixel();
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaPhiToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PrintSelf( std::ostream& os, Indent indent ) const
+{
+  Superclass::PrintSelf( os, indent );
+
+  os << indent << "RDirection: " << m_RDirection << std::endl;
+  os << indent << "ThetaDirection: " << m_ThetaDirection << std::endl;
+  os << indent << "PhiDirection: " << m_PhiDirection << std::endl;
+  os << indent << "ThetaTolerance: " << m_ThetaTolerance << std::endl;
+  os << indent << "OutputSpacingTheta: " << m_OutputSpacingTheta << std::endl;
+  os << indent << "OutputSpacingPhi: " << m_OutputSpacingPhi << std::endl;
+  os << indent << "DefaultPixelValue: "
+     << static_cast< typename NumericTraits< OutputPixelType >::PrintType >( m_DefaultPixelValue ) << std::endl;
+  os << indent << "PhiRadius: " << m_PhiRadius << std::endl;
+}
+
+} // end namespace itk
+
+#endif // __itkResampleRThetaPhiToCartesianImageFilter_txx
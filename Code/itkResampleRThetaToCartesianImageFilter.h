@@ -3,12 +3,23 @@
 
 #include "itkImageToImageFilter.h"
 
+#include "itkCartesianToRThetaFunctor.h"
 #include "itkCartesianToRThetaTransform.h"
-#include "itkStreamingResampleImageFilter.h"
+#include "itkEventObject.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkLogCompressionFunctor.h"
+#include "itkProgressReporter.h"
+#include "itkRealTimeClock.h"
+#include "itkRThetaScanGeometry.h"
+#include "itkRThetaToCartesianLookupTable.h"
 
 namespace itk
 {
 
+/** Invoked by ResampleRThetaToCartesianImageFilter at the end of every update
+ * with UseInstrumentation enabled. */
+itkEventMacro( RThetaToCartesianInstrumentationEvent, AnyEvent );
+
 /** @brief Transform for an image that was actually acquired in (R, Theta)
  * space.  E.g., scan convert an ultrasound image from a curvilinear array.
  * 
@@ -24,13 +35,36 @@ namespace itk
  *    component.  Use SetThetaDirection() to specify it.
  *
  * The input should have MetaDataDictionary entries for "Radius" or
- * "RadiusString" and "Theta" or "ThetaString".  "Radius" is of type double
- * and contains the distance in the RDirection to the first sample.
- * "RadiusString" is a string representation of the value.  "Theta" is an
- * itk::Array<double> containing the angles for every value in the
- * ThetaDirection in radians.  "ThetaString" is a a string representation of the
- * values containing the floating point value followed by a space for each
- * value.
+ * "RadiusString" and "Theta", "ThetaBinary", or "ThetaString".  "Radius" is
+ * of type double and contains the distance in the RDirection to the first
+ * sample.  "RadiusString" is a string representation of the value.  "Theta"
+ * is an itk::Array<double> containing the angles for every value in the
+ * ThetaDirection in radians.  "ThetaBinary" is a std::string holding the
+ * angles as packed doubles in the host's byte order.  "ThetaString" is a a
+ * string representation of the values containing the floating point value
+ * followed by a space for each value.  The entries are only parsed when
+ * they change; see RThetaScanGeometry.
+ *
+ * UseLookupTable caches the input location and interpolation weights of
+ * every output pixel while the geometry is unchanged, and a
+ * LookupTableDirectory shares the cached tables between processes.
+ * SetInterpolationMode() selects the kernel in the (R, Theta) plane,
+ * UseLogCompression converts envelope data to B-mode inside of the
+ * conversion, and a viewport replaces the sector's grid by a window for
+ * zoom and pan.
+ *
+ * A sequence of frames that share frame 0's geometry is converted in one
+ * update with SetInput( frame, image ).  SetOutputBuffer() writes a frame
+ * into the caller's memory, UseIncrementalUpdate redraws only the Theta
+ * lines passed to MarkThetaLinesModified(), and UseInstrumentation measures
+ * every update.
+ *
+ * The conversion is multithreaded.  Only the span of every output line that
+ * can intersect the imaging sector is interpolated; the rest of the line is
+ * filled with the DefaultPixelValue.  The input requested region is the
+ * back-projection of the output requested region, so a streamed output
+ * reads one slab of the input at a time; with UseLookupTable the whole
+ * (R, Theta) plane is requested.
  */
 
 template < class TInputImage, class TOutputImage, class TInterpolatorPrecision = double >
@@ -51,6 +85,13 @@ public:
   /**Typedefs from the superclass */
   typedef typename Superclass::InputImageType  InputImageType;
   typedef typename Superclass::OutputImageType OutputImageType;
+  typedef typename Superclass::OutputImageRegionType OutputImageRegionType;
+  typedef typename InputImageType::RegionType  InputImageRegionType;
+  typedef typename InputImageType::PixelType   InputPixelType;
+  typedef typename OutputImageType::PixelType  OutputPixelType;
+  typedef typename OutputImageType::PointType  OutputPointType;
+  typedef typename OutputImageType::SpacingType OutputSpacingType;
+  typedef typename OutputImageType::SizeType   OutputSizeType;
 
   /** Run-time type information (and related methods) */
   itkTypeMacro( ResampleRThetaToCartesianImageFilter, ImageToImageFilter );
@@ -61,31 +102,46 @@ public:
   /** Dimension of the image. */
   itkStaticConstMacro( ImageDimension, unsigned int, TInputImage::ImageDimension );
 
-  /** The direction in the input image that corresponds to the radial component.
-   * */
-  virtual void SetRDirection( unsigned int direction )
+  /** Set the input, i.e. frame 0. */
+  virtual void SetInput( const InputImageType * input )
     {
-    m_Transform->SetRDirection( direction );
-    this->Modified();
+    this->SetInput( 0, input );
     }
 
-  virtual unsigned int GetRDirection() const
+  /** Set one frame of a sequence that shares frame 0's geometry.  An output
+   * is created for every frame.  Only frame 0 needs the MetaDataDictionary
+   * entries; the other frames need its size, spacing, origin, and buffered
+   * region.  When there are at least as many frames as threads, every
+   * thread converts whole frames. */
+  virtual void SetInput( unsigned int frame, const InputImageType * input );
+
+  /** Number of frames converted by an update. */
+  unsigned int GetNumberOfFrames() const
     {
-    return m_Transform->GetRDirection();
+    return this->GetNumberOfInputs();
     }
 
+  /** Generate the output of frame into buffer, which holds numberOfPixels
+   * pixels and is owned by the caller, instead of into memory allocated by
+   * the filter.  The output's largest possible region is then generated
+   * whole, so it must fit and must not be streamed.  NULL, the default,
+   * allocates the output. */
+  void SetOutputBuffer( unsigned int frame, OutputPixelType * buffer, unsigned long numberOfPixels );
+
+  /** The direction in the input image that corresponds to the radial component.
+   * */
+  itkSetMacro( RDirection, unsigned int );
+  itkGetConstMacro( RDirection, unsigned int );
+
   /** The direction in the input image that corresponds to the angular (theta)
    * component. */
-  virtual void SetThetaDirection( unsigned int direction )
-    {
-    m_Transform->SetThetaDirection( direction );
-    this->Modified();
-    }
+  itkSetMacro( ThetaDirection, unsigned int );
+  itkGetConstMacro( ThetaDirection, unsigned int );
 
-  virtual unsigned int GetThetaDirection() const
-    {
-    return m_Transform->GetThetaDirection();
-    }
+  /** Tolerated error of the angle, as a fraction of the angular sample
+   * spacing.  See CartesianToRThetaTransform::SetThetaTolerance(). */
+  itkSetMacro( ThetaTolerance, double );
+  itkGetConstMacro( ThetaTolerance, double );
 
   /** SpacingTheta
    *	The output spacing in the ThetaDirection.  If not set, twice the spacing in the
@@ -94,33 +150,684 @@ public:
   itkSetMacro( OutputSpacingTheta, double );
   itkGetConstMacro( OutputSpacingTheta, double );
 
-  virtual void SetDefaultPixelValue( typename TOutputImage::PixelType defaultValue )
+  /** Viewport
+   *	A window of the Cartesian output: its origin, spacing, and size along
+   *	RDirection and ThetaDirection.  The components of the other directions
+   *	are ignored, and those directions follow the input.  When both sizes
+   *	are 0, the default, the output covers the whole sector with the
+   *	spacing described above.
+   *	*/
+  itkSetMacro( ViewportOrigin, OutputPointType );
+  itkGetConstReferenceMacro( ViewportOrigin, OutputPointType );
+  itkSetMacro( ViewportSpacing, OutputSpacingType );
+  itkGetConstReferenceMacro( ViewportSpacing, OutputSpacingType );
+  itkSetMacro( ViewportSize, OutputSizeType );
+  itkGetConstReferenceMacro( ViewportSize, OutputSizeType );
+
+  virtual void SetDefaultPixelValue( OutputPixelType defaultValue )
     {
-    m_ResamplingFilter->SetDefaultPixelValue( defaultValue );
+    m_DefaultPixelValue = defaultValue;
     this->Modified();
     }
+  itkGetConstMacro( DefaultPixelValue, OutputPixelType );
+
+  /** UseLookupTable
+   *	Cache the mapping from output pixels to input samples and weights.  The
+   *	table is recomputed only when the geometry changes.  Defaults to off.
+   *	*/
+  itkSetMacro( UseLookupTable, bool );
+  itkGetConstMacro( UseLookupTable, bool );
+  itkBooleanMacro( UseLookupTable );
+
+  /** LookupTableDirectory
+   *	Directory where the lookup tables are saved, named after their
+   *	geometry, and mapped from by later updates.  The directory must exist.
+   *	The tables of a viewport are kept in memory only.  Defaults to empty,
+   *	which keeps every table in memory only.
+   *	*/
+  itkSetStringMacro( LookupTableDirectory );
+  itkGetStringMacro( LookupTableDirectory );
+
+  /** Interpolation kernels in the (R, Theta) plane. */
+  typedef enum
+    {
+    NearestNeighborInterpolation,
+    LinearInterpolation,
+    CubicInterpolation,
+    WindowedSincInterpolation,
+    AntiAliasedInterpolation
+    } InterpolationModeType;
+
+  /** InterpolationMode
+   *	The kernel that interpolates the input in the (R, Theta) plane.  The
+   *	kernels are separable, replicate the border samples, and read their
+   *	weights from a table over 1024 fractional positions; the pass through
+   *	directions are interpolated linearly.  AntiAliasedInterpolation
+   *	averages the input over the footprint of every output pixel, read
+   *	from a summed area table of doubles that is rebuilt only when the
+   *	input changes.  Defaults to LinearInterpolation.
+   *	*/
+  itkSetMacro( InterpolationMode, InterpolationModeType );
+  itkGetConstMacro( InterpolationMode, InterpolationModeType );
+
+  /** UseFixedPointInterpolation
+   *	Interpolate integer pixels of at most 16 bits linearly in fixed point
+   *	when UseLookupTable is enabled and a single input slice is read.  The
+   *	table then also stores four 15 bit weights for every output pixel.
+   *	Defaults to on.
+   *	*/
+  itkSetMacro( UseFixedPointInterpolation, bool );
+  itkGetConstMacro( UseFixedPointInterpolation, bool );
+  itkBooleanMacro( UseFixedPointInterpolation );
+
+  /** UseLogCompression
+   *	Log compress the input samples with the LogCompressionFunctor before
+   *	they are interpolated, so the output equals compressing the input
+   *	first.  For integer pixels of at most 16 bits the functor is
+   *	tabulated.  Defaults to off.
+   *	*/
+  itkSetMacro( UseLogCompression, bool );
+  itkGetConstMacro( UseLogCompression, bool );
+  itkBooleanMacro( UseLogCompression );
+
+  /** Log compression of the input samples, in the precision of the
+   * interpolation. */
+  typedef Functor::LogCompression< InputPixelType, TInterpolatorPrecision > LogCompressionFunctorType;
+
+  /** The functor of UseLogCompression.  Modify it through
+   * SetLogCompressionFunctor(), so that the filter is marked modified. */
+  const LogCompressionFunctorType & GetLogCompressionFunctor() const
+    {
+    return m_LogCompressionFunctor;
+    }
+  void SetLogCompressionFunctor( const LogCompressionFunctorType & functor )
+    {
+    if( m_LogCompressionFunctor != functor )
+      {
+      m_LogCompressionFunctor = functor;
+      this->Modified();
+      }
+    }
+
+  /** Lookup table type. */
+  typedef itk::RThetaToCartesianLookupTable< InputImageType, TInterpolatorPrecision > LookupTableType;
+
+  /** Scan geometry type. */
+  typedef itk::RThetaScanGeometry< TInterpolatorPrecision, ImageDimension > GeometryType;
+
+  /** The geometry of the last output information update.  Filters whose
+   * inputs have the same geometry share it. */
+  const GeometryType * GetGeometry() const
+    {
+    return m_Geometry.GetPointer();
+    }
+
+  /** The lookup table used by the last update.  Only valid when
+   * UseLookupTable is enabled. */
+  const LookupTableType * GetLookupTable() const
+    {
+    return m_LookupTable.GetPointer();
+    }
+
+  /** UseIncrementalUpdate
+   *	Keep the output of every update, so that the next update only
+   *	recomputes the output pixels of the Theta lines marked by
+   *	MarkThetaLinesModified().  Defaults to off.
+   *	*/
+  itkSetMacro( UseIncrementalUpdate, bool );
+  itkGetConstMacro( UseIncrementalUpdate, bool );
+  itkBooleanMacro( UseIncrementalUpdate );
+
+  /** Mark the Theta lines with input indices in [begin, end) as modified,
+   * e.g. as new A-lines arrive, in every frame.  The marks accumulate until
+   * the next update.  With UseIncrementalUpdate, that update recomputes
+   * only the output pixels whose interpolation neighborhoods read the
+   * marked lines.  The whole output is converted instead when another
+   * property of the filter has changed, the output of the last update was
+   * streamed or replaced, or the input is not axis aligned.  The outputs
+   * are not released before an update, and an output released afterwards
+   * gets the kept pixels back.  With AntiAliasedInterpolation, the pixels
+   * that are kept only match a whole conversion up to rounding for non
+   * integer or log compressed samples. */
+  void MarkThetaLinesModified( long begin, long end );
+
+  /** UseInstrumentation
+   *	Accumulate the measurements of GetInstrumentation() and invoke a
+   *	RThetaToCartesianInstrumentationEvent at the end of every update.
+   *	Defaults to off, which leaves a few additions per output line.
+   *	*/
+  itkSetMacro( UseInstrumentation, bool );
+  itkGetConstMacro( UseInstrumentation, bool );
+  itkBooleanMacro( UseInstrumentation );
+
+  /** Measurements of the updates with UseInstrumentation, accumulated since
+   * ResetInstrumentation().  Times are wall times in seconds. */
+  struct InstrumentationType
+    {
+    /** Calls of GenerateData(), one per streamed piece. */
+    unsigned long NumberOfUpdates;
+
+    /** GenerateOutputInformation(), which resolves the scan geometry from
+     * the MetaDataDictionary and sets up the transform,
+     * BeforeThreadedGenerateData(), which prepares the lookup table and the
+     * other tables, and the threaded conversion. */
+    double OutputInformationTime;
+    double SetupTime;
+    double ConversionTime;
+
+    /** Output pixels converted by every thread, and those of them that
+     * were interpolated inside of the line spans of the imaging sector or
+     * set to the DefaultPixelValue outside of them. */
+    std::vector< unsigned long > ThreadPixels;
+    unsigned long InSectorPixels;
+    unsigned long OutOfSectorPixels;
+
+    /** Updates that reused the geometry of the previous one or found it in
+     * the process-wide cache of GeometryType, and those that parsed the
+     * MetaDataDictionary to create it. */
+    unsigned long GeometryHits;
+    unsigned long GeometryMisses;
+
+    /** Updates with UseLookupTable that reused the table, mapped it from
+     * the LookupTableDirectory, or computed it. */
+    unsigned long LookupTableHits;
+    unsigned long LookupTableFileReads;
+    unsigned long LookupTableMisses;
+
+    /** Frames of AntiAliasedInterpolation that reused or computed their
+     * summed area table. */
+    unsigned long SummedAreaTableHits;
+    unsigned long SummedAreaTableMisses;
+
+    /** Bytes of the interpolation neighborhoods of the input, or of the
+     * summed area tables, and bytes of lookup table entries read by the
+     * conversion. */
+    unsigned long InputBytesRead;
+    unsigned long LookupTableBytesRead;
+    };
+
+  const InstrumentationType & GetInstrumentation() const
+    {
+    return m_Instrumentation;
+    }
+  void ResetInstrumentation();
 
 protected:
   ResampleRThetaToCartesianImageFilter();
   ~ResampleRThetaToCartesianImageFilter() {}
 
   /** Standard process object method. */
-  virtual void GenerateData();
   virtual void GenerateOutputInformation();
   virtual void GenerateInputRequestedRegion();
 
-  /** Component filters. */
-  typedef itk::StreamingResampleImageFilter< InputImageType, OutputImageType, TInterpolatorPrecision > ResampleType;
+  /** Keep the outputs with UseIncrementalUpdate instead of releasing them
+   * before the update. */
+  virtual void PrepareOutputs();
+  virtual void AllocateOutputs();
+  virtual void BeforeThreadedGenerateData();
+  virtual void ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId );
+  virtual void AfterThreadedGenerateData();
+  virtual int SplitRequestedRegion( int i, int num, OutputImageRegionType& splitRegion );
+
+  typedef typename LookupTableType::FixedPointEntryType FixedPointEntryType;
+
+  /** Counters of the InstrumentationType that ThreadedGenerateFrame()
+   * accumulates. */
+  struct ConversionCountersType
+    {
+    unsigned long InSectorPixels;
+    unsigned long OutOfSectorPixels;
+    unsigned long InputBytesRead;
+    unsigned long LookupTableBytesRead;
+
+    ConversionCountersType():
+      InSectorPixels( 0 ),
+      OutOfSectorPixels( 0 ),
+      InputBytesRead( 0 ),
+      LookupTableBytesRead( 0 )
+      {}
+    };
+
+  /** Run of the output pixels [Begin, End) of the output line Line whose
+   * interpolation neighborhoods read a given Theta line.  Lines are
+   * numbered along the higher of RDirection and ThetaDirection, and the
+   * pixels along the lower one, from the start of the largest possible
+   * region. */
+  struct ThetaLineRunType
+    {
+    unsigned long Line;
+    unsigned long Begin;
+    unsigned long End;
+    };
+
+  /** Working storage of ThreadedGenerateFrame().  Reusing it across calls
+   * avoids allocations once it has grown to the size of a line. */
+  struct FrameScratchType
+    {
+    std::vector< typename OutputImageType::IndexType >  SliceIndices;
+    std::vector< unsigned int >                         SliceStarts;
+    std::vector< long >                                 SliceOffsets;
+    std::vector< TInterpolatorPrecision >               SliceWeights;
+    std::vector< TInterpolatorPrecision >               LineCoordinates;
+    std::vector< typename LookupTableType::EntryType >  LineEntries;
+    std::vector< TInterpolatorPrecision >               LineFootprints;
+    ConversionCountersType                              Counters;
+    };
+
+  /** Layout of the input buffer read by InterpolateSpan(), and the summed
+   * area table of AntiAliasedInterpolation with the same layout. */
+  struct InputLayoutType
+    {
+    const InputPixelType * Buffer;
+    const double *         SummedAreas;
+    long                   ROffset;
+    long                   ThetaOffset;
+    long                   RStep;
+    long                   ThetaStep;
+    long                   RSize;
+    long                   ThetaSize;
+    };
+
+  /** Readers of the input samples for the interpolation.  The plain reader
+   * returns the pixel, the others its log compression, evaluated by the
+   * functor or read from the table of every pixel value. */
+  struct PixelSampleReader
+    {
+    const InputPixelType & operator()( const InputPixelType & value ) const
+      {
+      return value;
+      }
+    };
+  struct FunctorSampleReader
+    {
+    const LogCompressionFunctorType * Functor;
+    TInterpolatorPrecision operator()( const InputPixelType & value ) const
+      {
+      return ( *Functor )( value );
+      }
+    };
+  struct TableSampleReader
+    {
+    /** Entry of the pixel value 0. */
+    const TInterpolatorPrecision * Table;
+    TInterpolatorPrecision operator()( const InputPixelType & value ) const
+      {
+      return Table[static_cast< long >( value )];
+      }
+    };
+
+  /** Convert one frame over the given output region.  The region is
+   * walked as lines of the (R, Theta) plane, and every line is converted
+   * in each slice of the pass through directions in turn.  For axis aligned
+   * inputs, the span and interpolation neighborhoods of a line are computed
+   * once and shared by all the slices. */
+  void ThreadedGenerateFrame( unsigned int frame,
+    const OutputImageRegionType& outputRegionForThread,
+    ProgressReporter& progress,
+    FrameScratchType& scratch );
+
+  /** Span of the line of lineLength output pixels starting at lineIndex
+   * that falls inside of the imaging sector, relative to lineIndex, and the
+   * interpolation neighborhood of its first pixel.  The neighborhoods of the
+   * following pixels are entryStep entries apart.  fixedPointEntry points to
+   * the fixed point entry of the first pixel when the interpolation is in
+   * fixed point, and is NULL otherwise.  footprints points to the R and
+   * Theta footprints of the first pixel with AntiAliasedInterpolation, see
+   * ComputeLineFootprints(), and is NULL otherwise. */
+  void ComputeLineInterpolation( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    unsigned long lineLength,
+    FrameScratchType& scratch,
+    unsigned long& spanBegin,
+    unsigned long& spanEnd,
+    const typename LookupTableType::EntryType *& entry,
+    const FixedPointEntryType *& fixedPointEntry,
+    const TInterpolatorPrecision *& footprints,
+    unsigned long& entryStep ) const;
+
+  /** Interpolate length output pixels, outputStep pixels apart, from the
+   * neighborhoods at entry, entryStep entries apart.  Each value sums
+   * numberOfSlices bilinear interpolations at the given buffer offsets and
+   * weights.  VNumberOfSlices fixes the number of slices at compile time so
+   * that the sum is unrolled; 0 reads it from numberOfSlices.  A single
+   * slice always has a weight of 1.  The samples are read through
+   * sample, one of the sample readers above. */
+  template < unsigned int VNumberOfSlices, class TSampleReader >
+  void InterpolateSpan( const InputLayoutType& input,
+    const TSampleReader& sample,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** InterpolateSpan() for a single slice at sliceOffset in fixed point,
+   * from the fixed point entries at fixedPointEntry. */
+  void InterpolateSpanFixedPoint( const InputLayoutType& input,
+    long sliceOffset,
+    const FixedPointEntryType * fixedPointEntry,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** InterpolateSpan() with the nearest neighbor in the (R, Theta) plane. */
+  template < class TSampleReader >
+  void InterpolateSpanNearestNeighbor( const InputLayoutType& input,
+    const TSampleReader& sample,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** InterpolateSpan() with the VNumberOfTaps by VNumberOfTaps separable
+   * kernel of m_KernelWeights in the (R, Theta) plane.  The taps run from
+   * 1 - VNumberOfTaps / 2 to VNumberOfTaps / 2 samples around the entry's
+   * index, clamped to the buffer. */
+  template < unsigned int VNumberOfTaps, class TSampleReader >
+  void InterpolateSpanWithKernel( const InputLayoutType& input,
+    const TSampleReader& sample,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** InterpolateSpan() with the box of AntiAliasedInterpolation, sized by
+   * the R and Theta footprints at footprints, two per output pixel. */
+  void InterpolateSpanAntiAliased( const InputLayoutType& input,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    const TInterpolatorPrecision * footprints,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** Interpolate a span with the InterpolationMode, reading the samples
+   * with the sample reader of UseLogCompression.  See InterpolateSpan(). */
+  void InterpolateSpanWithMode( const InputLayoutType& input,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    const FixedPointEntryType * fixedPointEntry,
+    const TInterpolatorPrecision * footprints,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** InterpolateSpanWithMode() with the given sample reader. */
+  template < class TSampleReader >
+  void InterpolateSpanWithReader( const InputLayoutType& input,
+    const TSampleReader& sample,
+    const long * sliceOffsets,
+    const TInterpolatorPrecision * sliceWeights,
+    unsigned int numberOfSlices,
+    const typename LookupTableType::EntryType * entry,
+    const FixedPointEntryType * fixedPointEntry,
+    const TInterpolatorPrecision * footprints,
+    unsigned long entryStep,
+    OutputPixelType * out,
+    long outputStep,
+    unsigned long length ) const;
+
+  /** Tabulate the LogCompressionFunctor over every value of integer input
+   * pixels of at most 16 bits in m_CompressionTable, when it has changed.
+   * The table is cleared for other inputs or without UseLogCompression. */
+  void ComputeCompressionTable();
+
+  /** value converted to the output pixel type, saturated at its limits. */
+  static OutputPixelType SaturateOutputValue( double value );
+
+  /** Tabulate the weights of the cubic or windowed sinc kernel over
+   * NumberOfKernelPhases + 1 fractional positions in m_KernelWeights. */
+  void ComputeKernelTable();
+
+  /** Number of intervals of the fractional position in the kernel table. */
+  itkStaticConstMacro( NumberOfKernelPhases, unsigned int, 1024 );
+
+  /** Reciprocals of the input's R spacing and of the mean angle between
+   * two Theta samples, which convert the physical extent of an output pixel
+   * into its footprint.  thetaScale is 0 for a single Theta sample. */
+  void ComputeFootprintScales( const InputImageType * inputPtr,
+    double& rScale,
+    double& thetaScale ) const;
+
+  /** Footprints of the lineLength output pixels starting at lineIndex along
+   * the lower of RDirection and ThetaDirection: the number of R and Theta
+   * samples that each pixel covers, at least 1, stored in pairs. */
+  void ComputeLineFootprints( const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    unsigned long lineLength,
+    std::vector< TInterpolatorPrecision >& footprints ) const;
+
+  /** Indices and weights in one direction of the summed area table that
+   * average a box of width footprint centered at the continuous index
+   * center, cropped to the size samples of the direction.  Sample k covers
+   * [k - 0.5, k + 0.5), and entry k of the table sums the samples up to
+   * and including k.  An index of -1 stands for the empty sum.  The
+   * weights are in increasing order of the indices and sum to 0. */
+  static void ComputeBoxTaps( double center,
+    double footprint,
+    long size,
+    long indices[4],
+    double weights[4] );
+
+  /** ComputeSummedAreaTable() of every frame whose buffer, modification
+   * time, or log compression has changed since its table was computed.
+   * The tables are cleared without AntiAliasedInterpolation. */
+  void ComputeSummedAreaTables();
+
+  /** Sum the samples of frame's buffer along RDirection and ThetaDirection
+   * into its summed area table, log compressed with UseLogCompression.
+   * The tables must have been sized by ComputeSummedAreaTables(). */
+  void ComputeSummedAreaTable( unsigned int frame );
+
+  /** Tabulate the ThetaLineRunType of every Theta line of the input buffer
+   * in m_ThetaLineRuns, from the interpolation neighborhoods of the whole
+   * output plane. */
+  void ComputeThetaLineRuns( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr );
+
+  /** First and last Theta sample, clamped to the thetaSize samples of the
+   * buffer, that the InterpolationMode reads for entry.  thetaFootprint is
+   * the Theta footprint of AntiAliasedInterpolation. */
+  void ComputeThetaNeighborhood( const typename LookupTableType::EntryType& entry,
+    TInterpolatorPrecision thetaFootprint,
+    long thetaSize,
+    long& first,
+    long& last ) const;
+
+  /** Whether this update can be incremental, and if so, set the range of
+   * the modified pixels of every output line in m_ModifiedLineBegins and
+   * m_ModifiedLineEnds. */
+  bool PrepareIncrementalUpdate( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr );
+
+  /** Split region into num pieces along the outermost pass through
+   * direction with at least num slices, or else across the ThetaDirection.
+   * Returns the number of pieces used. */
+  int SplitRegion( const OutputImageRegionType& region, int i, int num,
+    OutputImageRegionType& splitRegion ) const;
+
+  /** Component types. */
   typedef itk::CartesianToRThetaTransform< TInterpolatorPrecision, ImageDimension > TransformType;
+  typedef itk::LinearInterpolateImageFunction< InputImageType, TInterpolatorPrecision > InterpolatorType;
+  typedef Functor::CartesianToRTheta< TInterpolatorPrecision, ImageDimension > CartesianToRThetaFunctorType;
+
+  /** Input buffer offsets and weights of the slices that an output line in
+   * the directions other than RDirection and ThetaDirection interpolates
+   * from, appended to offsets and weights.  Nothing is appended if the line
+   * falls outside the input. */
+  void ComputeSliceNeighbors( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    std::vector< long >& offsets,
+    std::vector< TInterpolatorPrecision >& weights ) const;
+
+  /** Interpolation neighborhoods in the (R, Theta) plane of lineLength output
+   * pixels starting at lineIndex along the lower of RDirection and
+   * ThetaDirection.  coordinates is scratch space.  The transform is
+   * evaluated through m_CartesianToRTheta, and for axis aligned inputs the
+   * continuous index and the buffer test are computed inline. */
+  void ComputeLineEntries( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    unsigned long lineLength,
+    std::vector< TInterpolatorPrecision >& coordinates,
+    std::vector< typename LookupTableType::EntryType >& entries ) const;
+
+  /** Smallest region of the input that the conversion of outputRegion
+   * reads: the bounding box of the region's back-projection through the
+   * transform in radius, angle, and the passed through directions, widened
+   * by one sample on each side and cropped to the largest possible region.
+   * Images that are not axis aligned get the largest possible region. */
+  InputImageRegionType ComputeInputRegion( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const OutputImageRegionType& outputRegion ) const;
+
+  /** Prepare the separable evaluation of the transform used by
+   * ComputeLineEntries() when the Theta array is uniform.  Sets
+   * m_UseSeparableTransform. */
+  void ComputeSeparableTransform( const OutputImageType * outputPtr );
+
+  /** Conservative [begin, end) range of the pixels of a line of lineLength
+   * output pixels starting at lineIndex that can fall inside of the input's
+   * imaging sector.  The range is derived from Rmin, Rmax, and the angular
+   * extent of the input buffer. */
+  void ComputeLineSpan( const InputImageType * inputPtr,
+    const OutputImageType * outputPtr,
+    const typename OutputImageType::IndexType& lineIndex,
+    unsigned long lineLength,
+    unsigned long& begin,
+    unsigned long& end ) const;
 
 private:
   ResampleRThetaToCartesianImageFilter( const Self& ); // purposely not implemented
   void operator=( const Self& ); // purposely not implemented
 
-  typename ResampleType::Pointer  m_ResamplingFilter;
-  typename TransformType::Pointer m_Transform;
+  unsigned int m_RDirection;
+  unsigned int m_ThetaDirection;
+  double       m_ThetaTolerance;
+
+  /** Shared geometry and its transform, set in GenerateOutputInformation(). */
+  typename GeometryType::ConstPointer  m_Geometry;
+  typename TransformType::ConstPointer m_Transform;
+
+  /** Constants of m_Transform and the ThetaTolerance for the inner loops,
+   * set in BeforeThreadedGenerateData(). */
+  CartesianToRThetaFunctorType m_CartesianToRTheta;
 
   double m_OutputSpacingTheta;
+
+  OutputPointType   m_ViewportOrigin;
+  OutputSpacingType m_ViewportSpacing;
+  OutputSizeType    m_ViewportSize;
+
+  OutputPixelType m_DefaultPixelValue;
+
+  /** SetOutputBuffer() of every frame, NULL where the output is
+   * allocated. */
+  std::vector< OutputPixelType * > m_OutputBuffers;
+  std::vector< unsigned long >     m_OutputBufferSizes;
+
+  bool                               m_UseLookupTable;
+  typename LookupTableType::Pointer  m_LookupTable;
+  std::string                        m_LookupTableDirectory;
+  typename InterpolatorType::Pointer m_Interpolator;
+
+  InterpolationModeType m_InterpolationMode;
+  bool                  m_UseFixedPointInterpolation;
+
+  /** Whether the update interpolates in fixed point, and the kernel weights
+   * of the cubic and windowed sinc modes, set in
+   * BeforeThreadedGenerateData(). */
+  bool                                  m_FixedPointInterpolation;
+  std::vector< TInterpolatorPrecision > m_KernelWeights;
+
+  bool                      m_UseLogCompression;
+  LogCompressionFunctorType m_LogCompressionFunctor;
+
+  /** LogCompressionFunctor of every pixel value, from NonpositiveMin() up,
+   * and the functor that it was computed with. */
+  std::vector< TInterpolatorPrecision > m_CompressionTable;
+  LogCompressionFunctorType             m_CompressionTableFunctor;
+
+  /** ComputeFootprintScales() of the input, set in
+   * BeforeThreadedGenerateData(). */
+  double m_FootprintRScale;
+  double m_FootprintThetaScale;
+
+  /** Summed area table of every frame for AntiAliasedInterpolation, and
+   * the buffer, buffered region, and modification time of the input that
+   * it was computed from. */
+  std::vector< std::vector< double > > m_SummedAreaTables;
+  std::vector< const InputPixelType * > m_SummedAreaBuffers;
+  std::vector< InputImageRegionType >   m_SummedAreaRegions;
+  std::vector< unsigned long >          m_SummedAreaTimes;
+
+  /** UseLogCompression and the functor of the summed area tables. */
+  bool                      m_SummedAreaLogCompression;
+  LogCompressionFunctorType m_SummedAreaFunctor;
+
+  /** Separable transform: the squared coordinate and the factor of y / x of
+   * every position along the output lines, and theta sampled over y / x. */
+  bool                                  m_UseSeparableTransform;
+  std::vector< TInterpolatorPrecision > m_LineSquares;
+  std::vector< TInterpolatorPrecision > m_LineFactors;
+  std::vector< TInterpolatorPrecision > m_AngleTable;
+  double                                m_AngleTableOrigin;
+  double                                m_AngleTableScale;
+
+  /** UseIncrementalUpdate: the Theta lines marked since the last update,
+   * as input indices, and the modification time of the filter after the
+   * last mark.  An empty range marks nothing. */
+  bool          m_UseIncrementalUpdate;
+  long          m_ModifiedThetaBegin;
+  long          m_ModifiedThetaEnd;
+  unsigned long m_ModifiedThetaTime;
+
+  /** Runs of every Theta line of the input buffer, and the geometry key
+   * and InterpolationMode that they were computed for. */
+  std::vector< std::vector< ThetaLineRunType > > m_ThetaLineRuns;
+  typename LookupTableType::GeometryKeyType      m_ThetaLineRunsKey;
+  InterpolationModeType                          m_ThetaLineRunsMode;
+
+  /** Pixel containers and buffers of the outputs of the last update.  They
+   * are held so that a released output can be given its pixels back, and so
+   * that a newly allocated buffer cannot be mistaken for them.  Whether this
+   * update is incremental, and the modified pixels of every output line. */
+  std::vector< typename OutputImageType::PixelContainerPointer > m_IncrementalContainers;
+  std::vector< const OutputPixelType * >                         m_IncrementalBuffers;
+  bool                                                           m_IncrementalUpdate;
+  std::vector< unsigned long >                                   m_ModifiedLineBegins;
+  std::vector< unsigned long >                                   m_ModifiedLineEnds;
+
+  /** Measurements of UseInstrumentation.  The counters of every thread are
+   * summed by AfterThreadedGenerateData(), and m_NeighborhoodBytes is the
+   * size of the input read for one output pixel and slice, set in
+   * BeforeThreadedGenerateData(). */
+  bool                                  m_UseInstrumentation;
+  InstrumentationType                   m_Instrumentation;
+  RealTimeClock::Pointer                m_InstrumentationClock;
+  double                                m_ConversionStartTime;
+  std::vector< ConversionCountersType > m_ThreadCounters;
+  unsigned long                         m_NeighborhoodBytes;
 };
 } // end namesplace itk
 
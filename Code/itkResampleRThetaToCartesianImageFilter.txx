@@ -3,21 +3,198 @@
 
 #include "itkResampleRThetaToCartesianImageFilter.h"
 
+#include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkMetaDataObject.h"
+#include "itkNumericTraits.h"
 
 #include "vnl/vnl_math.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
 template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
 ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
 ::ResampleRThetaToCartesianImageFilter():
-  m_OutputSpacingTheta( 0.0 )
+  m_RDirection( 0 ),
+  m_ThetaDirection( 1 ),
+  m_ThetaTolerance( 0.0 ),
+  m_OutputSpacingTheta( 0.0 ),
+  m_DefaultPixelValue( NumericTraits< OutputPixelType >::Zero ),
+  m_UseLookupTable( false ),
+  m_InterpolationMode( LinearInterpolation ),
+  m_UseFixedPointInterpolation( true ),
+  m_FixedPointInterpolation( false ),
+  m_UseLogCompression( false ),
+  m_FootprintRScale( 0.0 ),
+  m_FootprintThetaScale( 0.0 ),
+  m_SummedAreaLogCompression( false ),
+  m_UseSeparableTransform( false ),
+  m_AngleTableOrigin( 0.0 ),
+  m_AngleTableScale( 0.0 ),
+  m_UseIncrementalUpdate( false ),
+  m_ModifiedThetaBegin( 0 ),
+  m_ModifiedThetaEnd( 0 ),
+  m_ModifiedThetaTime( 0 ),
+  m_ThetaLineRunsMode( LinearInterpolation ),
+  m_IncrementalUpdate( false ),
+  m_UseInstrumentation( false ),
+  m_ConversionStartTime( 0.0 ),
+  m_NeighborhoodBytes( 0 )
+{
+  m_ViewportOrigin.Fill( 0.0 );
+  m_ViewportSpacing.Fill( 1.0 );
+  m_ViewportSize.Fill( 0 );
+  m_LookupTable = LookupTableType::New();
+  m_Interpolator = InterpolatorType::New();
+  m_InstrumentationClock = RealTimeClock::New();
+  this->ResetInstrumentation();
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ResetInstrumentation()
+{
+  m_Instrumentation.NumberOfUpdates = 0;
+  m_Instrumentation.OutputInformationTime = 0.0;
+  m_Instrumentation.SetupTime = 0.0;
+  m_Instrumentation.ConversionTime = 0.0;
+  m_Instrumentation.ThreadPixels.clear();
+  m_Instrumentation.InSectorPixels = 0;
+  m_Instrumentation.OutOfSectorPixels = 0;
+  m_Instrumentation.GeometryHits = 0;
+  m_Instrumentation.GeometryMisses = 0;
+  m_Instrumentation.LookupTableHits = 0;
+  m_Instrumentation.LookupTableFileReads = 0;
+  m_Instrumentation.LookupTableMisses = 0;
+  m_Instrumentation.SummedAreaTableHits = 0;
+  m_Instrumentation.SummedAreaTableMisses = 0;
+  m_Instrumentation.InputBytesRead = 0;
+  m_Instrumentation.LookupTableBytesRead = 0;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SetInput( unsigned int frame, const InputImageType * input )
+{
+  this->SetNthInput( frame, const_cast< InputImageType * >( input ) );
+
+  if( frame >= this->GetNumberOfOutputs() )
+    {
+    const unsigned int previousNumberOfOutputs = this->GetNumberOfOutputs();
+    this->SetNumberOfOutputs( frame + 1 );
+    for( unsigned int i = previousNumberOfOutputs; i <= frame; i++ )
+      {
+      typename OutputImageType::Pointer output =
+        static_cast< OutputImageType * >( this->MakeOutput( i ).GetPointer() );
+      this->SetNthOutput( i, output.GetPointer() );
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SetOutputBuffer( unsigned int frame, OutputPixelType * buffer, unsigned long numberOfPixels )
+{
+  if( frame >= m_OutputBuffers.size() )
+    {
+    m_OutputBuffers.resize( frame + 1, NULL );
+    m_OutputBufferSizes.resize( frame + 1, 0 );
+    }
+  m_OutputBuffers[frame] = buffer;
+  m_OutputBufferSizes[frame] = buffer == NULL ? 0 : numberOfPixels;
+  this->Modified();
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::MarkThetaLinesModified( long begin, long end )
 {
-  m_ResamplingFilter = ResampleType::New();
-  m_Transform = TransformType::New();
-  m_ResamplingFilter->SetTransform( m_Transform );
+  if( end <= begin )
+    {
+    return;
+    }
+  if( m_ModifiedThetaEnd > m_ModifiedThetaBegin )
+    {
+    m_ModifiedThetaBegin = vnl_math_min( m_ModifiedThetaBegin, begin );
+    m_ModifiedThetaEnd = vnl_math_max( m_ModifiedThetaEnd, end );
+    }
+  else
+    {
+    m_ModifiedThetaBegin = begin;
+    m_ModifiedThetaEnd = end;
+    }
+
+  // Any later change of the filter makes the next update a whole one.
+  this->Modified();
+  m_ModifiedThetaTime = this->GetMTime();
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PrepareOutputs()
+{
+  // Releasing the outputs would discard the pixels that an incremental
+  // update keeps.
+  if( !m_UseIncrementalUpdate )
+    {
+    Superclass::PrepareOutputs();
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::AllocateOutputs()
+{
+  for( unsigned int frame = 0; frame < this->GetNumberOfOutputs(); frame++ )
+    {
+    OutputImageType * outputPtr = this->GetOutput( frame );
+    if( !outputPtr )
+      {
+      continue;
+      }
+    outputPtr->SetBufferedRegion( outputPtr->GetRequestedRegion() );
+    typename OutputImageType::PixelContainer * container = outputPtr->GetPixelContainer();
+    if( frame < m_OutputBuffers.size() && m_OutputBuffers[frame] != NULL )
+      {
+      const unsigned long numberOfPixels = outputPtr->GetLargestPossibleRegion().GetNumberOfPixels();
+      if( outputPtr->GetRequestedRegion() != outputPtr->GetLargestPossibleRegion() )
+        {
+        itkExceptionMacro( "The output of frame " << frame << " has an output buffer and cannot be streamed." );
+        }
+      if( numberOfPixels > m_OutputBufferSizes[frame] )
+        {
+        itkExceptionMacro( "The output of frame " << frame << " has " << numberOfPixels
+          << " pixels, but its output buffer only " << m_OutputBufferSizes[frame] << "." );
+        }
+      container->SetImportPointer( m_OutputBuffers[frame], numberOfPixels, false );
+      }
+    else if( m_UseIncrementalUpdate &&
+             frame < m_IncrementalContainers.size() &&
+             m_IncrementalContainers[frame]->Size() == outputPtr->GetBufferedRegion().GetNumberOfPixels() )
+      {
+      // The pixels of the last update are kept for an incremental update,
+      // even if the output was released in the meantime.
+      outputPtr->SetPixelContainer( m_IncrementalContainers[frame] );
+      }
+    else
+      {
+      // A container that still refers to a caller's buffer would keep it.
+      if( !container->GetContainerManageMemory() )
+        {
+        outputPtr->SetPixelContainer( OutputImageType::PixelContainer::New() );
+        }
+      outputPtr->Allocate();
+      }
+    }
 }
 
 template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
@@ -28,127 +205,2255 @@ ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPr
   typename InputImageType::ConstPointer  inputPtr  = this->GetInput();
   typename OutputImageType::Pointer      outputPtr = this->GetOutput();
 
-  const unsigned int rDirection = m_Transform->GetRDirection();
-  const unsigned int thetaDirection = m_Transform->GetThetaDirection();
-
   if ( !inputPtr || !outputPtr )
     {
     return;
     }
+  const double startTime = m_UseInstrumentation ? m_InstrumentationClock->GetTimeStamp() : 0.0;
+
+  // Only a new geometry takes the lock of the geometry cache.
+  const MetaDataDictionary & dict = inputPtr->GetMetaDataDictionary();
+  const typename InputImageType::SpacingType & spacing = inputPtr->GetSpacing();
+  const typename InputImageType::SizeType & size = inputPtr->GetLargestPossibleRegion().GetSize();
+  if( m_Geometry.IsNull() ||
+      !m_Geometry->Matches( dict, spacing, size, m_RDirection, m_ThetaDirection, m_OutputSpacingTheta ) )
+    {
+    bool created;
+    m_Geometry = GeometryType::GetGeometry( dict, spacing, size,
+      m_RDirection, m_ThetaDirection, m_OutputSpacingTheta, &created );
+    if( m_UseInstrumentation )
+      {
+      if( created )
+        {
+        m_Instrumentation.GeometryMisses++;
+        }
+      else
+        {
+        m_Instrumentation.GeometryHits++;
+        }
+      }
+    }
+  else if( m_UseInstrumentation )
+    {
+    m_Instrumentation.GeometryHits++;
+    }
+  m_Transform = m_Geometry->GetTransform();
+
+  // A viewport replaces the sector's grid in the (R, Theta) plane.
+  OutputSizeType outputSize = m_Geometry->GetOutputSize();
+  OutputSpacingType outputSpacing = m_Geometry->GetOutputSpacing();
+  OutputPointType outputOrigin = m_Geometry->GetOutputOrigin();
+  if( m_ViewportSize[m_RDirection] > 0 || m_ViewportSize[m_ThetaDirection] > 0 )
+    {
+    const unsigned int planeDirections[2] = { m_RDirection, m_ThetaDirection };
+    for( unsigned int i = 0; i < 2; i++ )
+      {
+      const unsigned int direction = planeDirections[i];
+      if( m_ViewportSize[direction] == 0 || !( m_ViewportSpacing[direction] > 0.0 ) )
+        {
+        itkExceptionMacro( "The viewport needs a size and a positive spacing in direction " << direction << "." );
+        }
+      outputSize[direction] = m_ViewportSize[direction];
+      outputSpacing[direction] = m_ViewportSpacing[direction];
+      outputOrigin[direction] = m_ViewportOrigin[direction];
+      }
+    }
 
-  typename InputImageType::SizeType size = inputPtr->GetLargestPossibleRegion().GetSize();
-  typename InputImageType::SpacingType spacing = inputPtr->GetSpacing();
+  typename OutputImageType::RegionType outputRegion;
+  outputRegion.SetSize( outputSize );
+  outputPtr->SetLargestPossibleRegion( outputRegion );
+  outputPtr->SetSpacing( outputSpacing );
+  outputPtr->SetOrigin( outputOrigin );
+  typename OutputImageType::DirectionType identity;
+  identity.SetIdentity();
+  outputPtr->SetDirection( identity );
+
+  // The other frames share the geometry of frame 0.
+  for( unsigned int frame = 1; frame < this->GetNumberOfFrames(); frame++ )
+    {
+    const InputImageType * frameInput = this->GetInput( frame );
+    if( frameInput == NULL )
+      {
+      itkExceptionMacro( "Input frame " << frame << " has not been set." );
+      }
+    if( frameInput->GetLargestPossibleRegion() != inputPtr->GetLargestPossibleRegion() ||
+        frameInput->GetSpacing() != inputPtr->GetSpacing() ||
+        frameInput->GetOrigin() != inputPtr->GetOrigin() )
+      {
+      itkExceptionMacro( "Input frame " << frame << " does not have the same geometry as frame 0." );
+      }
+    this->GetOutput( frame )->CopyInformation( outputPtr );
+    }
 
-  // Rmin.
-  const itk::MetaDataDictionary& dict = inputPtr->GetMetaDataDictionary();
-  typedef const itk::MetaDataObject< std::string >* MetaStringType;
-  typedef const itk::MetaDataObject< double >* MetaDoubleType;
-  double Rmin;
-  MetaDoubleType r = dynamic_cast< MetaDoubleType >( dict["Radius"] );
-  MetaStringType rString = dynamic_cast< MetaStringType >( dict["RadiusString"] );
-  if( r != NULL )
+  if( m_UseInstrumentation )
     {
-    Rmin = r->GetMetaDataObjectValue();
-    m_Transform->SetRmin( Rmin );
+    m_Instrumentation.OutputInformationTime += m_InstrumentationClock->GetTimeStamp() - startTime;
     }
-  else if( rString != NULL )
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::GenerateInputRequestedRegion()
+{
+  InputImageType * inputPtr = const_cast< InputImageType * >( this->GetInput() );
+  if( !inputPtr )
     {
-    istringstream iss( rString->GetMetaDataObjectValue() );
-    iss >> Rmin;
-    m_Transform->SetRmin( Rmin );
+    return;
     }
-  else
+
+  const OutputImageType * outputPtr = this->GetOutput();
+  InputImageRegionType inputRegion =
+    this->ComputeInputRegion( inputPtr, outputPtr, outputPtr->GetRequestedRegion() );
+  if( m_UseLookupTable )
+    {
+    // The table indexes the whole input plane, so only the pass through
+    // directions are cropped.
+    const InputImageRegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+    typename InputImageType::IndexType index = inputRegion.GetIndex();
+    typename InputImageType::SizeType size = inputRegion.GetSize();
+    const unsigned int planeDirections[2] = { m_RDirection, m_ThetaDirection };
+    for( unsigned int i = 0; i < 2; i++ )
+      {
+      index[planeDirections[i]] = largestRegion.GetIndex()[planeDirections[i]];
+      size[planeDirections[i]] = largestRegion.GetSize()[planeDirections[i]];
+      }
+    inputRegion.SetIndex( index );
+    inputRegion.SetSize( size );
+    }
+  inputPtr->SetRequestedRegion( inputRegion );
+
+  for( unsigned int frame = 1; frame < this->GetNumberOfFrames(); frame++ )
+    {
+    InputImageType * frameInput = const_cast< InputImageType * >( this->GetInput( frame ) );
+    if( frameInput )
+      {
+      frameInput->SetRequestedRegion( inputPtr->GetRequestedRegion() );
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+typename ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >::InputImageRegionType
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeInputRegion( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const OutputImageRegionType& outputRegion ) const
+{
+  const InputImageRegionType & largestRegion = inputPtr->GetLargestPossibleRegion();
+  if( outputRegion.GetNumberOfPixels() == 0 )
+    {
+    return largestRegion;
+    }
+
+  // The bounds below assume axis aligned images.
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( inputPtr->GetDirection() != identity || outputPtr->GetDirection() != identity )
     {
-    itkExceptionMacro( "Could not find Radius MetaDataDictionary value to perform RTheta transform." );
+    return largestRegion;
     }
 
-  // Rmax.
-  const double Rmax = Rmin + size[rDirection] * spacing[rDirection]; 
-  m_Transform->SetRmax( Rmax );
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const typename OutputImageType::PointType & outputOrigin = outputPtr->GetOrigin();
+  const typename OutputImageType::SpacingType & outputSpacing = outputPtr->GetSpacing();
+  const typename InputImageType::PointType & inputOrigin = inputPtr->GetOrigin();
+  const typename InputImageType::SpacingType & inputSpacing = inputPtr->GetSpacing();
 
-  m_Transform->SetSpacingTheta( spacing[thetaDirection] );
-  if( m_OutputSpacingTheta == 0.0 ) // has not been initialized
+  // Physical extent of the output region.
+  double lower[ImageDimension];
+  double upper[ImageDimension];
+  for( unsigned int d = 0; d < ImageDimension; d++ )
     {
-    spacing[thetaDirection] = spacing[thetaDirection] / 2.;
+    const double first = outputOrigin[d] + outputSpacing[d] * outputRegion.GetIndex()[d];
+    const double last = first + outputSpacing[d] *
+      ( static_cast< double >( outputRegion.GetSize()[d] ) - 1.0 );
+    lower[d] = vnl_math_min( first, last );
+    upper[d] = vnl_math_max( first, last );
+    }
+
+  // Coordinates of the back-projection in the input.  The other directions
+  // are passed through by the transform.
+  bool bounded[ImageDimension];
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    bounded[d] = true;
+    }
+
+  // The radius is bounded by the nearest point of the box and its farthest
+  // corner.
+  const double xNear = vnl_math_max( lower[rDirection], vnl_math_min( 0.0, upper[rDirection] ) );
+  const double yNear = vnl_math_max( lower[thetaDirection], vnl_math_min( 0.0, upper[thetaDirection] ) );
+  const double xFar = vnl_math_max( vnl_math_abs( lower[rDirection] ), vnl_math_abs( upper[rDirection] ) );
+  const double yFar = vnl_math_max( vnl_math_abs( lower[thetaDirection] ), vnl_math_abs( upper[thetaDirection] ) );
+  const double Rmin = m_Transform->GetParameters()[0];
+  const double rNear = vcl_sqrt( xNear * xNear + yNear * yNear ) - Rmin;
+  const double rFar = vcl_sqrt( xFar * xFar + yFar * yFar ) - Rmin;
+
+  // For x > 0, atan( y / x ) is monotonic in x and in y, so its extremes are
+  // at the corners.  Boxes that reach x <= 0 are not bounded in theta.
+  const double spacingThetaOverDeltaTheta = m_Transform->GetParameters()[4];
+  double thetaLow = 0.0;
+  double thetaHigh = 0.0;
+  if( lower[rDirection] > 0.0 && spacingThetaOverDeltaTheta != 0.0 )
+    {
+    for( unsigned int corner = 0; corner < 4; corner++ )
+      {
+      const double x = ( corner & 1 ) ? upper[rDirection] : lower[rDirection];
+      const double y = ( corner & 2 ) ? upper[thetaDirection] : lower[thetaDirection];
+      const double theta = vcl_atan( y / x );
+      double thetaCoordinate;
+      if( m_Transform->GetUseThetaIndexTable() )
+        {
+        thetaCoordinate = m_Transform->ThetaToContinuousIndex( theta ) * m_Transform->GetSpacingTheta();
+        }
+      else
+        {
+        thetaCoordinate = ( theta - m_Transform->GetParameters()[3] ) * spacingThetaOverDeltaTheta;
+        }
+      thetaLow = corner ? vnl_math_min( thetaLow, thetaCoordinate ) : thetaCoordinate;
+      thetaHigh = corner ? vnl_math_max( thetaHigh, thetaCoordinate ) : thetaCoordinate;
+      }
+    lower[thetaDirection] = thetaLow;
+    upper[thetaDirection] = thetaHigh;
     }
   else
     {
-    spacing[thetaDirection] = m_OutputSpacingTheta;
+    bounded[thetaDirection] = false;
+    }
+  lower[rDirection] = rNear;
+  upper[rDirection] = rFar;
+
+  // Continuous index bounds, widened by the radius of the kernel so that
+  // every output pixel in the region interpolates from inside of the
+  // requested region exactly as it would from the whole input, and cropped.
+  double margins[ImageDimension];
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    margins[d] = 1.0;
+    if( m_InterpolationMode == CubicInterpolation )
+      {
+      margins[d] = 2.0;
+      }
+    else if( m_InterpolationMode == WindowedSincInterpolation )
+      {
+      margins[d] = 3.0;
+      }
+    }
+  if( m_InterpolationMode == AntiAliasedInterpolation )
+    {
+    // The footprint of a pixel is largest along R when the pixel's diagonal
+    // points at the apex, and along Theta at the nearest radius.
+    double rScale;
+    double thetaScale;
+    this->ComputeFootprintScales( inputPtr, rScale, thetaScale );
+    const double diagonal = vcl_sqrt( outputSpacing[rDirection] * outputSpacing[rDirection] +
+      outputSpacing[thetaDirection] * outputSpacing[thetaDirection] );
+    const double nearestRadius = vcl_sqrt( xNear * xNear + yNear * yNear );
+    const double thetaSize = static_cast< double >( largestRegion.GetSize()[thetaDirection] );
+    margins[rDirection] = vnl_math_max( vcl_ceil( 0.5 * diagonal * rScale ), 1.0 );
+    margins[thetaDirection] = thetaSize;
+    if( diagonal * thetaScale < thetaSize * nearestRadius )
+      {
+      margins[thetaDirection] = vnl_math_max( vcl_ceil( 0.5 * diagonal * thetaScale / nearestRadius ), 1.0 );
+      }
+    }
+  typename InputImageType::IndexType index = largestRegion.GetIndex();
+  typename InputImageType::SizeType size = largestRegion.GetSize();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( !bounded[d] )
+      {
+      continue;
+      }
+    const double a = ( lower[d] - inputOrigin[d] ) / inputSpacing[d];
+    const double b = ( upper[d] - inputOrigin[d] ) / inputSpacing[d];
+    const double start = largestRegion.GetIndex()[d];
+    const double last = start + static_cast< double >( largestRegion.GetSize()[d] ) - 1.0;
+    const double first = vnl_math_min( vnl_math_max( vcl_floor( vnl_math_min( a, b ) ) - margins[d], start ), last );
+    const double end = vnl_math_min( vnl_math_max( vcl_ceil( vnl_math_max( a, b ) ) + margins[d], start ), last );
+    if( !( first <= end ) )
+      {
+      continue;
+      }
+    index[d] = static_cast< long >( first );
+    size[d] = static_cast< unsigned long >( end - first ) + 1;
     }
 
-  // Theta.
-  typedef const itk::MetaDataObject< itk::Array< double > >* MetaArrayType;
-  MetaArrayType thetaArray = dynamic_cast< MetaArrayType >( dict["Theta"] );
-  MetaStringType thetaArrayString = dynamic_cast< MetaStringType >( dict["ThetaString"] );
-  if( thetaArray != NULL )
+  InputImageRegionType inputRegion;
+  inputRegion.SetIndex( index );
+  inputRegion.SetSize( size );
+  return inputRegion;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::BeforeThreadedGenerateData()
+{
+  const InputImageType * inputPtr = this->GetInput();
+  const OutputImageType * outputPtr = this->GetOutput();
+  const double startTime = m_UseInstrumentation ? m_InstrumentationClock->GetTimeStamp() : 0.0;
+
+  // The interpolation neighborhoods are computed from frame 0's buffer and
+  // applied to every frame.
+  for( unsigned int frame = 1; frame < this->GetNumberOfFrames(); frame++ )
     {
-    m_Transform->SetThetaArray( thetaArray->GetMetaDataObjectValue() );
+    if( this->GetInput( frame )->GetBufferedRegion() != inputPtr->GetBufferedRegion() )
+      {
+      itkExceptionMacro( "Input frame " << frame << " does not have the same buffered region as frame 0." );
+      }
     }
-  else if( thetaArrayString != NULL ) 
+
+  m_Interpolator->SetInputImage( inputPtr );
+  m_CartesianToRTheta.SetTransform( m_Transform, m_ThetaTolerance );
+
+  // The fixed point entries are precomputed in the lookup table, and the
+  // products of 16 bit pixels and their weights fit in an int.
+  m_FixedPointInterpolation = m_UseFixedPointInterpolation &&
+    m_UseLookupTable &&
+    m_InterpolationMode == LinearInterpolation &&
+    !m_UseLogCompression &&
+    NumericTraits< InputPixelType >::is_integer &&
+    NumericTraits< OutputPixelType >::is_integer &&
+    sizeof( InputPixelType ) <= 2;
+  this->ComputeKernelTable();
+  this->ComputeFootprintScales( inputPtr, m_FootprintRScale, m_FootprintThetaScale );
+  this->ComputeCompressionTable();
+  this->ComputeSummedAreaTables();
+
+  if( m_UseLookupTable )
     {
-    std::string thetaString = thetaArrayString->GetMetaDataObjectValue() ;
-    unsigned int alines = std::count( thetaString.begin(), thetaString.end(), ' ' );
-    typedef itk::Array< double > ArrayType;
-    double theta;
-    ArrayType thetaArray( alines );
-    istringstream iss;
-    iss.str( thetaString );
-    for( unsigned int i = 0; i < alines; i++ )
+    const typename LookupTableType::GeometryKeyType key =
+      LookupTableType::ComputeGeometryKey( m_Transform, outputPtr, inputPtr );
+    if( key != m_LookupTable->GetGeometryKey() ||
+        ( m_FixedPointInterpolation && !m_LookupTable->HasFixedPointEntries( inputPtr ) ) )
+      {
+      // Every pan or zoom of a viewport is a new grid, so saving them would
+      // fill the directory with tables that are rarely mapped again.
+      const bool viewport = m_ViewportSize[m_RDirection] > 0 || m_ViewportSize[m_ThetaDirection] > 0;
+      const std::string fileName = ( m_LookupTableDirectory.empty() || viewport ) ? std::string() :
+        m_LookupTableDirectory + "/" + LookupTableType::ComputeFileName( key );
+      if( fileName.empty() ||
+          !m_LookupTable->ReadFile( fileName, key, outputPtr ) ||
+          ( m_FixedPointInterpolation && !m_LookupTable->HasFixedPointEntries( inputPtr ) ) )
+        {
+        m_LookupTable->SetUseFixedPointEntries( m_FixedPointInterpolation );
+        m_LookupTable->Compute( m_Transform, outputPtr, m_Interpolator );
+        if( !fileName.empty() && !m_LookupTable->WriteFile( fileName ) )
+          {
+          itkWarningMacro( << "Could not save the lookup table to " << fileName );
+          }
+        if( m_UseInstrumentation )
+          {
+          m_Instrumentation.LookupTableMisses++;
+          }
+        }
+      else if( m_UseInstrumentation )
+        {
+        m_Instrumentation.LookupTableFileReads++;
+        }
+      }
+    else if( m_UseInstrumentation )
       {
-      iss >> theta;
-      thetaArray[i] = theta;
+      m_Instrumentation.LookupTableHits++;
       }
-    m_Transform->SetThetaArray( thetaArray );
     }
   else
     {
-    itkExceptionMacro( "Could not find 'Theta' MetaDataDictionary entry to perform RTheta transform." );
+    this->ComputeSeparableTransform( outputPtr );
+    }
+
+  m_IncrementalUpdate = this->PrepareIncrementalUpdate( inputPtr, outputPtr );
+
+  if( m_UseInstrumentation )
+    {
+    // Samples of the neighborhood of an output pixel in one slice.
+    switch( m_InterpolationMode )
+      {
+    case NearestNeighborInterpolation:
+      m_NeighborhoodBytes = sizeof( InputPixelType );
+      break;
+    case CubicInterpolation:
+      m_NeighborhoodBytes = 4 * 4 * sizeof( InputPixelType );
+      break;
+    case WindowedSincInterpolation:
+      m_NeighborhoodBytes = 6 * 6 * sizeof( InputPixelType );
+      break;
+    case AntiAliasedInterpolation:
+      m_NeighborhoodBytes = 4 * 4 * sizeof( double );
+      break;
+    default:
+      m_NeighborhoodBytes = 2 * 2 * sizeof( InputPixelType );
+      }
+    m_ThreadCounters.assign( this->GetNumberOfThreads(), ConversionCountersType() );
+    if( m_Instrumentation.ThreadPixels.size() < m_ThreadCounters.size() )
+      {
+      m_Instrumentation.ThreadPixels.resize( m_ThreadCounters.size(), 0 );
+      }
+    m_ConversionStartTime = m_InstrumentationClock->GetTimeStamp();
+    m_Instrumentation.SetupTime += m_ConversionStartTime - startTime;
     }
+}
 
-  typename OutputImageType::PointType origin;
-  origin.Fill( 0.0 );
-  origin[rDirection] = m_Transform->GetRmincosMaxAbsTheta();
-  origin[thetaDirection] =  m_Transform->GetRmaxsinThetamin();
-  m_ResamplingFilter->SetOutputOrigin( origin );
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::AfterThreadedGenerateData()
+{
+  // The outputs are kept for the next incremental update.
+  m_ModifiedThetaBegin = 0;
+  m_ModifiedThetaEnd = 0;
+  if( m_UseIncrementalUpdate )
+    {
+    for( unsigned int frame = 0; frame < this->GetNumberOfOutputs(); frame++ )
+      {
+      OutputImageType * outputPtr = this->GetOutput( frame );
+      m_IncrementalContainers.push_back( outputPtr->GetPixelContainer() );
+      m_IncrementalBuffers.push_back( outputPtr->GetBufferPointer() );
+      }
+    }
 
-  m_ResamplingFilter->SetOutputSpacing( spacing );
+  if( !m_UseInstrumentation )
+    {
+    return;
+    }
 
-  size[rDirection] = static_cast< unsigned int >( vcl_ceil ( ( Rmax - m_Transform->GetRmincosMaxAbsTheta() ) / spacing[rDirection] ) );
-  size[thetaDirection] = static_cast< unsigned int >( vcl_ceil( vcl_abs(2.0 * m_Transform->GetRmaxsinThetamin() / spacing[thetaDirection]) ) );
-  m_ResamplingFilter->SetSize( size );
+  m_Instrumentation.ConversionTime += m_InstrumentationClock->GetTimeStamp() - m_ConversionStartTime;
+  for( unsigned int thread = 0; thread < m_ThreadCounters.size(); thread++ )
+    {
+    const ConversionCountersType & counters = m_ThreadCounters[thread];
+    m_Instrumentation.ThreadPixels[thread] += counters.InSectorPixels + counters.OutOfSectorPixels;
+    m_Instrumentation.InSectorPixels += counters.InSectorPixels;
+    m_Instrumentation.OutOfSectorPixels += counters.OutOfSectorPixels;
+    m_Instrumentation.InputBytesRead += counters.InputBytesRead;
+    m_Instrumentation.LookupTableBytesRead += counters.LookupTableBytesRead;
+    }
+  m_Instrumentation.NumberOfUpdates++;
 
-  m_ResamplingFilter->SetInput( inputPtr );
-  m_ResamplingFilter->UpdateOutputInformation();
-  outputPtr->CopyInformation( m_ResamplingFilter->GetOutput() );
+  this->InvokeEvent( RThetaToCartesianInstrumentationEvent() );
 }
 
 template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
 void
 ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
-::GenerateInputRequestedRegion()
+::ComputeKernelTable()
+{
+  unsigned int numberOfTaps = 0;
+  if( m_InterpolationMode == CubicInterpolation )
+    {
+    numberOfTaps = 4;
+    }
+  else if( m_InterpolationMode == WindowedSincInterpolation )
+    {
+    numberOfTaps = 6;
+    }
+  if( numberOfTaps == 0 )
+    {
+    m_KernelWeights.clear();
+    return;
+    }
+  // The two kernels have different numbers of taps.
+  if( m_KernelWeights.size() == ( NumberOfKernelPhases + 1 ) * numberOfTaps )
+    {
+    return;
+    }
+
+  // Row p holds the weights of the taps at 1 - numberOfTaps / 2, ...,
+  // numberOfTaps / 2 samples from the lower neighbor for a fractional
+  // position of p / NumberOfKernelPhases.
+  m_KernelWeights.resize( ( NumberOfKernelPhases + 1 ) * numberOfTaps );
+  const long firstTap = 1 - static_cast< long >( numberOfTaps / 2 );
+  for( unsigned int phase = 0; phase <= NumberOfKernelPhases; phase++ )
+    {
+    const double t = phase / static_cast< double >( NumberOfKernelPhases );
+    TInterpolatorPrecision * weights = &m_KernelWeights[phase * numberOfTaps];
+    if( numberOfTaps == 4 )
+      {
+      // Catmull-Rom spline.
+      const double t2 = t * t;
+      const double t3 = t2 * t;
+      weights[0] = static_cast< TInterpolatorPrecision >( 0.5 * ( -t3 + 2.0 * t2 - t ) );
+      weights[1] = static_cast< TInterpolatorPrecision >( 0.5 * ( 3.0 * t3 - 5.0 * t2 + 2.0 ) );
+      weights[2] = static_cast< TInterpolatorPrecision >( 0.5 * ( -3.0 * t3 + 4.0 * t2 + t ) );
+      weights[3] = static_cast< TInterpolatorPrecision >( 0.5 * ( t3 - t2 ) );
+      }
+    else
+      {
+      // Lanczos window of radius 3, normalized so that a constant input is
+      // reproduced.
+      const double radius = numberOfTaps / 2;
+      double lanczos[6];
+      double sum = 0.0;
+      for( unsigned int k = 0; k < numberOfTaps; k++ )
+        {
+        const double x = vnl_math_abs( ( firstTap + static_cast< long >( k ) ) - t );
+        if( x < 1.0e-12 )
+          {
+          lanczos[k] = 1.0;
+          }
+        else if( x >= radius )
+          {
+          lanczos[k] = 0.0;
+          }
+        else
+          {
+          const double px = vnl_math::pi * x;
+          lanczos[k] = radius * vcl_sin( px ) * vcl_sin( px / radius ) / ( px * px );
+          }
+        sum += lanczos[k];
+        }
+      for( unsigned int k = 0; k < numberOfTaps; k++ )
+        {
+        weights[k] = static_cast< TInterpolatorPrecision >( lanczos[k] / sum );
+        }
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeFootprintScales( const InputImageType * inputPtr,
+  double& rScale,
+  double& thetaScale ) const
 {
-  this->m_ResamplingFilter->SetInput( this->GetInput() );
-  this->m_ResamplingFilter->GetOutput()->SetRequestedRegion( this->GetOutput()->GetRequestedRegion() );
-  this->m_ResamplingFilter->GenerateInputRequestedRegion();
+  rScale = 1.0 / inputPtr->GetSpacing()[m_RDirection];
+  thetaScale = 0.0;
+  const Array< double > & thetaArray = m_Transform->GetThetaArray();
+  if( thetaArray.size() > 1 )
+    {
+    const double angle = ( thetaArray.max_value() - thetaArray.min_value() ) / ( thetaArray.size() - 1 );
+    if( angle > 0.0 )
+      {
+      thetaScale = 1.0 / angle;
+      }
+    }
 }
 
 template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
 void
 ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
-::GenerateData()
+::ComputeLineFootprints( const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  unsigned long lineLength,
+  std::vector< TInterpolatorPrecision >& footprints ) const
 {
-  typename InputImageType::ConstPointer  inputPtr  = this->GetInput();
-  typename OutputImageType::Pointer      outputPtr = this->GetOutput();
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
 
-  if ( !inputPtr || !outputPtr )
+  typename OutputImageType::PointType lineStart;
+  outputPtr->TransformIndexToPhysicalPoint( lineIndex, lineStart );
+  const typename OutputImageType::SpacingType & spacing = outputPtr->GetSpacing();
+  const double xStep = ( lineDirection == rDirection ) ? spacing[rDirection] : 0.0;
+  const double yStep = ( lineDirection == thetaDirection ) ? spacing[thetaDirection] : 0.0;
+  const double xExtent = spacing[rDirection];
+  const double yExtent = spacing[thetaDirection];
+  // The pixel at the apex covers every sample.
+  const double apexFootprint = NumericTraits< TInterpolatorPrecision >::max();
+
+  // A pixel at angle theta from the apex extends |cos theta| xExtent +
+  // |sin theta| yExtent along the radius, and |sin theta| xExtent +
+  // |cos theta| yExtent across it, which spans an angle of that over the
+  // radius.
+  footprints.resize( 2 * lineLength );
+  for( unsigned long i = 0; i < lineLength; i++ )
+    {
+    const double x = vnl_math_abs( lineStart[rDirection] + i * xStep );
+    const double y = vnl_math_abs( lineStart[thetaDirection] + i * yStep );
+    const double radius = vcl_sqrt( x * x + y * y );
+    double rFootprint = apexFootprint;
+    double thetaFootprint = apexFootprint;
+    if( radius > 0.0 )
+      {
+      rFootprint = ( x * xExtent + y * yExtent ) / radius * m_FootprintRScale;
+      thetaFootprint = ( y * xExtent + x * yExtent ) / ( radius * radius ) * m_FootprintThetaScale;
+      }
+    footprints[2 * i] = static_cast< TInterpolatorPrecision >(
+      vnl_math_min( vnl_math_max( rFootprint, 1.0 ), apexFootprint ) );
+    footprints[2 * i + 1] = static_cast< TInterpolatorPrecision >(
+      vnl_math_min( vnl_math_max( thetaFootprint, 1.0 ), apexFootprint ) );
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeSeparableTransform( const OutputImageType * outputPtr )
+{
+  m_UseSeparableTransform = false;
+  m_LineSquares.clear();
+  m_LineFactors.clear();
+  m_AngleTable.clear();
+
+  // The angle table replaces the linear mapping of theta, so the array must
+  // be uniform.  The grid must be axis aligned and lie in x > 0, where the
+  // angle is a monotonic function of y / x.
+  typename OutputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( !m_Transform->GetThetaArrayIsUniform() || outputPtr->GetDirection() != identity )
+    {
+    return;
+    }
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
+  const typename OutputImageType::RegionType & region = outputPtr->GetLargestPossibleRegion();
+  const typename OutputImageType::PointType & origin = outputPtr->GetOrigin();
+  const typename OutputImageType::SpacingType & spacing = outputPtr->GetSpacing();
+
+  double xLimits[2];
+  double yLimits[2];
+  xLimits[0] = origin[rDirection] + spacing[rDirection] * region.GetIndex()[rDirection];
+  xLimits[1] = xLimits[0] + spacing[rDirection] * ( static_cast< double >( region.GetSize()[rDirection] ) - 1.0 );
+  yLimits[0] = origin[thetaDirection] + spacing[thetaDirection] * region.GetIndex()[thetaDirection];
+  yLimits[1] = yLimits[0] + spacing[thetaDirection] * ( static_cast< double >( region.GetSize()[thetaDirection] ) - 1.0 );
+  if( vnl_math_min( xLimits[0], xLimits[1] ) <= 0.0 )
+    {
+    return;
+    }
+
+  // Linear interpolation of the arc tangent on a grid of step h is off by at
+  // most h^2 / 8 * max | atan'' | = h^2 * 3 sqrt( 3 ) / 64.  Without a
+  // ThetaTolerance the table is accurate to 1e-5 of a line.
+  const typename TransformType::ParametersType & parameters = m_Transform->GetParameters();
+  const double spacingTheta = m_Transform->GetSpacingTheta();
+  if( parameters[4] == 0.0 )
+    {
+    return;
+    }
+  const double deltaTheta = vnl_math_abs( spacingTheta / parameters[4] );
+  const double tolerance = m_ThetaTolerance > 0.0 ? m_ThetaTolerance : 1.0e-5;
+  const double step = vcl_sqrt( tolerance * deltaTheta * 64.0 / ( 3.0 * vcl_sqrt( 3.0 ) ) );
+
+  double uMin = yLimits[0] / xLimits[0];
+  double uMax = uMin;
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    for( unsigned int j = 0; j < 2; j++ )
+      {
+      uMin = vnl_math_min( uMin, yLimits[j] / xLimits[i] );
+      uMax = vnl_math_max( uMax, yLimits[j] / xLimits[i] );
+      }
+    }
+  const double maximumTableSize = 1 << 20;
+  const double tableSize = vcl_ceil( ( uMax - uMin ) / step ) + 2.0;
+  if( tableSize > maximumTableSize )
     {
     return;
     }
 
-  m_ResamplingFilter->SetInput( inputPtr );
-  m_ResamplingFilter->GraftOutput( outputPtr );
-  m_ResamplingFilter->GetOutput()->UpdateOutputData();
-  this->GraftOutput( m_ResamplingFilter->GetOutput() );
+  // The table stores the ThetaDirection coordinate of the transform.
+  const unsigned long numberOfAngles = static_cast< unsigned long >( tableSize );
+  const double tableStep = ( uMax - uMin ) / ( numberOfAngles - 1 );
+  m_AngleTable.resize( numberOfAngles );
+  for( unsigned long i = 0; i < numberOfAngles; i++ )
+    {
+    m_AngleTable[i] = static_cast< TInterpolatorPrecision >(
+      ( vcl_atan( uMin + i * tableStep ) - parameters[3] ) * parameters[4] );
+    }
+  m_AngleTableOrigin = uMin;
+  m_AngleTableScale = tableStep > 0.0 ? 1.0 / tableStep : 0.0;
+
+  // Along lines in the RDirection, u = y * ( 1 / x ); along lines in the
+  // ThetaDirection, u = ( 1 / x ) * y.
+  const unsigned long lineLength = region.GetSize()[lineDirection];
+  m_LineSquares.resize( lineLength );
+  m_LineFactors.resize( lineLength );
+  for( unsigned long i = 0; i < lineLength; i++ )
+    {
+    const double coordinate = origin[lineDirection] + spacing[lineDirection] *
+      ( region.GetIndex()[lineDirection] + static_cast< double >( i ) );
+    m_LineSquares[i] = static_cast< TInterpolatorPrecision >( coordinate * coordinate );
+    m_LineFactors[i] = static_cast< TInterpolatorPrecision >(
+      lineDirection == rDirection ? 1.0 / coordinate : coordinate );
+    }
+
+  m_UseSeparableTransform = true;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeLineEntries( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  unsigned long lineLength,
+  std::vector< TInterpolatorPrecision >& coordinates,
+  std::vector< typename LookupTableType::EntryType >& entries ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
+
+  entries.resize( lineLength );
+  coordinates.resize( 4 * lineLength );
+  TInterpolatorPrecision * rCoordinates = &coordinates[0];
+  TInterpolatorPrecision * thetaCoordinates = rCoordinates + lineLength;
+  TInterpolatorPrecision * rInput = thetaCoordinates + lineLength;
+  TInterpolatorPrecision * thetaInput = rInput + lineLength;
+
+  typedef Point< double, ImageDimension > LinePointType;
+  LinePointType lineStart;
+  outputPtr->TransformIndexToPhysicalPoint( lineIndex, lineStart );
+
+  if( m_UseSeparableTransform )
+    {
+    // r = sqrt( x^2 + y^2 ) and theta = atan( y / x ) from the per position
+    // terms computed in ComputeSeparableTransform() and one term per line.
+    const unsigned long first = lineIndex[lineDirection] -
+      outputPtr->GetLargestPossibleRegion().GetIndex()[lineDirection];
+    const TInterpolatorPrecision * squares = &m_LineSquares[first];
+    const TInterpolatorPrecision * factors = &m_LineFactors[first];
+    const double lineCoordinate = ( lineDirection == rDirection ) ?
+      lineStart[thetaDirection] : lineStart[rDirection];
+    const TInterpolatorPrecision lineSquare = static_cast< TInterpolatorPrecision >( lineCoordinate * lineCoordinate );
+    const TInterpolatorPrecision lineFactor = static_cast< TInterpolatorPrecision >(
+      lineDirection == rDirection ? lineCoordinate : 1.0 / lineCoordinate );
+    const TInterpolatorPrecision Rmin = static_cast< TInterpolatorPrecision >( m_CartesianToRTheta.GetRmin() );
+    const TInterpolatorPrecision angleOrigin = static_cast< TInterpolatorPrecision >( m_AngleTableOrigin );
+    const TInterpolatorPrecision angleScale = static_cast< TInterpolatorPrecision >( m_AngleTableScale );
+    const TInterpolatorPrecision lastAngle = static_cast< TInterpolatorPrecision >( m_AngleTable.size() - 1 );
+    const TInterpolatorPrecision * angles = &m_AngleTable[0];
+    for( unsigned long i = 0; i < lineLength; i++ )
+      {
+      rInput[i] = vcl_sqrt( squares[i] + lineSquare ) - Rmin;
+      TInterpolatorPrecision position = ( factors[i] * lineFactor - angleOrigin ) * angleScale;
+      position = vnl_math_min( vnl_math_max( position, static_cast< TInterpolatorPrecision >( 0.0 ) ), lastAngle );
+      unsigned long k = static_cast< unsigned long >( position );
+      if( k + 1 >= m_AngleTable.size() )
+        {
+        k = m_AngleTable.size() - 2;
+        }
+      const TInterpolatorPrecision fraction = position - k;
+      thetaInput[i] = angles[k] + fraction * ( angles[k + 1] - angles[k] );
+      }
+    }
+  else
+    {
+    // The output is a regular grid, so the points along the line are an
+    // arithmetic sequence.  It is generated in double precision so that the
+    // error does not grow along the line.
+    LinePointType nextPoint;
+    typename OutputImageType::IndexType index = lineIndex;
+    index[lineDirection] += 1;
+    outputPtr->TransformIndexToPhysicalPoint( index, nextPoint );
+    const double rStep = nextPoint[rDirection] - lineStart[rDirection];
+    const double thetaStep = nextPoint[thetaDirection] - lineStart[thetaDirection];
+    for( unsigned long i = 0; i < lineLength; i++ )
+      {
+      rCoordinates[i] = static_cast< TInterpolatorPrecision >( lineStart[rDirection] + i * rStep );
+      thetaCoordinates[i] = static_cast< TInterpolatorPrecision >( lineStart[thetaDirection] + i * thetaStep );
+      }
+
+    m_CartesianToRTheta.TransformLine( rCoordinates, thetaCoordinates,
+      rInput, thetaInput, lineLength );
+    }
+
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  const long inputRStart = bufferedRegion.GetIndex()[rDirection];
+  const long inputThetaStart = bufferedRegion.GetIndex()[thetaDirection];
+  const unsigned long inputRSize = bufferedRegion.GetSize()[rDirection];
+  const unsigned long inputThetaSize = bufferedRegion.GetSize()[thetaDirection];
+
+  typedef typename LookupTableType::EntryType EntryType;
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( inputPtr->GetDirection() == identity )
+    {
+    // Axis aligned input: the continuous index along each direction only
+    // depends on the coordinate along that direction, and the other
+    // directions always pass the buffer test.
+    const ContinuousIndexType & startIndex = m_Interpolator->GetStartContinuousIndex();
+    const ContinuousIndexType & endIndex = m_Interpolator->GetEndContinuousIndex();
+    const TInterpolatorPrecision rLow = startIndex[rDirection];
+    const TInterpolatorPrecision rHigh = endIndex[rDirection];
+    const TInterpolatorPrecision thetaLow = startIndex[thetaDirection];
+    const TInterpolatorPrecision thetaHigh = endIndex[thetaDirection];
+    const TInterpolatorPrecision rOrigin = inputPtr->GetOrigin()[rDirection];
+    const TInterpolatorPrecision thetaOrigin = inputPtr->GetOrigin()[thetaDirection];
+    const TInterpolatorPrecision rScale = 1.0 / inputPtr->GetSpacing()[rDirection];
+    const TInterpolatorPrecision thetaScale = 1.0 / inputPtr->GetSpacing()[thetaDirection];
+    for( unsigned long i = 0; i < lineLength; i++ )
+      {
+      const TInterpolatorPrecision rIndex = ( rInput[i] - rOrigin ) * rScale;
+      const TInterpolatorPrecision thetaIndex = ( thetaInput[i] - thetaOrigin ) * thetaScale;
+      EntryType & entry = entries[i];
+      if( rIndex >= rLow && rIndex < rHigh && thetaIndex >= thetaLow && thetaIndex < thetaHigh )
+        {
+        RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( rIndex,
+          inputRStart, inputRSize, entry.RIndex, entry.RWeight );
+        RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( thetaIndex,
+          inputThetaStart, inputThetaSize, entry.ThetaIndex, entry.ThetaWeight );
+        }
+      else
+        {
+        entry.RIndex = -1;
+        entry.ThetaIndex = -1;
+        entry.RWeight = 0.0;
+        entry.ThetaWeight = 0.0;
+        }
+      }
+    return;
+    }
+
+  typedef typename TransformType::InputPointType PointType;
+  PointType point;
+  point.CastFrom( lineStart );
+  ContinuousIndexType inputIndex;
+  for( unsigned long i = 0; i < lineLength; i++ )
+    {
+    point[rDirection] = rInput[i];
+    point[thetaDirection] = thetaInput[i];
+    inputPtr->TransformPhysicalPointToContinuousIndex( point, inputIndex );
+    // As in the lookup table, only the (R, Theta) plane is tested here.
+    for( unsigned int d = 0; d < ImageDimension; d++ )
+      {
+      if( d != rDirection && d != thetaDirection )
+        {
+        inputIndex[d] = bufferedRegion.GetIndex()[d];
+        }
+      }
+
+    EntryType & entry = entries[i];
+    if( m_Interpolator->IsInsideBuffer( inputIndex ) )
+      {
+      RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( inputIndex[rDirection],
+        inputRStart, inputRSize, entry.RIndex, entry.RWeight );
+      RThetaToCartesianLookupTableNeighbor< TInterpolatorPrecision >( inputIndex[thetaDirection],
+        inputThetaStart, inputThetaSize, entry.ThetaIndex, entry.ThetaWeight );
+      }
+    else
+      {
+      entry.RIndex = -1;
+      entry.ThetaIndex = -1;
+      entry.RWeight = 0.0;
+      entry.ThetaWeight = 0.0;
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeSliceNeighbors( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  std::vector< long >& offsets,
+  std::vector< TInterpolatorPrecision >& weights ) const
+{
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+
+  // The transform passes the other directions through unchanged.
+  typedef typename TransformType::InputPointType PointType;
+  typedef typename InterpolatorType::ContinuousIndexType ContinuousIndexType;
+  PointType point;
+  outputPtr->TransformIndexToPhysicalPoint( lineIndex, point );
+  ContinuousIndexType inputIndex;
+  inputPtr->TransformPhysicalPointToContinuousIndex( point, inputIndex );
+
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  inputIndex[rDirection] = bufferedRegion.GetIndex()[rDirection];
+  inputIndex[thetaDirection] = bufferedRegion.GetIndex()[thetaDirection];
+  if( !m_Interpolator->IsInsideBuffer( inputIndex ) )
+    {
+    return;
+    }
+
+  // Linear interpolation between the neighboring slices, clamped to the
+  // buffer the same way as LinearInterpolateImageFunction.
+  const typename InputImageType::IndexType & startIndex = m_Interpolator->GetStartIndex();
+  const typename InputImageType::IndexType & endIndex = m_Interpolator->GetEndIndex();
+  typename InputImageType::IndexType baseIndex;
+  TInterpolatorPrecision distance[ImageDimension];
+  unsigned int passThroughDirections[ImageDimension];
+  unsigned int numberOfPassThrough = 0;
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d == rDirection || d == thetaDirection )
+      {
+      baseIndex[d] = bufferedRegion.GetIndex()[d];
+      distance[d] = 0.0;
+      continue;
+      }
+    baseIndex[d] = static_cast< long >( vcl_floor( inputIndex[d] ) );
+    distance[d] = inputIndex[d] - static_cast< TInterpolatorPrecision >( baseIndex[d] );
+    passThroughDirections[numberOfPassThrough++] = d;
+    }
+
+  const unsigned int numberOfNeighbors = 1 << numberOfPassThrough;
+  typename InputImageType::IndexType neighborIndex;
+  for( unsigned int counter = 0; counter < numberOfNeighbors; counter++ )
+    {
+    neighborIndex = baseIndex;
+    TInterpolatorPrecision overlap = 1.0;
+    for( unsigned int j = 0; j < numberOfPassThrough; j++ )
+      {
+      const unsigned int d = passThroughDirections[j];
+      if( counter & ( 1 << j ) )
+        {
+        neighborIndex[d] = vnl_math_min( baseIndex[d] + 1, endIndex[d] );
+        overlap *= distance[d];
+        }
+      else
+        {
+        neighborIndex[d] = vnl_math_max( baseIndex[d], startIndex[d] );
+        overlap *= 1.0 - distance[d];
+        }
+      }
+    if( overlap != 0.0 )
+      {
+      offsets.push_back( inputPtr->ComputeOffset( neighborIndex ) );
+      weights.push_back( overlap );
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+bool
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::PrepareIncrementalUpdate( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr )
+{
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( !m_UseIncrementalUpdate || inputPtr->GetDirection() != identity )
+    {
+    m_ThetaLineRuns.clear();
+    m_ThetaLineRunsKey.SetSize( 0 );
+    m_IncrementalContainers.clear();
+    m_IncrementalBuffers.clear();
+    return false;
+    }
+
+  // The runs only change with the geometry and the interpolation kernel.
+  const typename LookupTableType::GeometryKeyType key =
+    LookupTableType::ComputeGeometryKey( m_Transform, outputPtr, inputPtr );
+  bool incremental = ( key == m_ThetaLineRunsKey && m_InterpolationMode == m_ThetaLineRunsMode );
+  if( !incremental )
+    {
+    this->ComputeThetaLineRuns( inputPtr, outputPtr );
+    m_ThetaLineRunsKey = key;
+    m_ThetaLineRunsMode = m_InterpolationMode;
+    }
+
+  // Nothing but the marks may have changed since the last update, and its
+  // outputs must still be in place.
+  incremental = incremental &&
+    m_ModifiedThetaEnd > m_ModifiedThetaBegin &&
+    this->GetMTime() == m_ModifiedThetaTime &&
+    m_IncrementalBuffers.size() == this->GetNumberOfOutputs();
+  for( unsigned int frame = 0; incremental && frame < this->GetNumberOfOutputs(); frame++ )
+    {
+    const OutputImageType * frameOutput = this->GetOutput( frame );
+    incremental = frameOutput->GetBufferedRegion() == frameOutput->GetLargestPossibleRegion() &&
+      frameOutput->GetPixelContainer() == m_IncrementalContainers[frame].GetPointer() &&
+      frameOutput->GetBufferPointer() == m_IncrementalBuffers[frame];
+    }
+  m_IncrementalContainers.clear();
+  m_IncrementalBuffers.clear();
+  if( !incremental )
+    {
+    return false;
+    }
+
+  const unsigned int lineDirection = vnl_math_min( m_RDirection, m_ThetaDirection );
+  const unsigned int otherDirection = vnl_math_max( m_RDirection, m_ThetaDirection );
+  const OutputSizeType & outputSize = outputPtr->GetLargestPossibleRegion().GetSize();
+  m_ModifiedLineBegins.assign( outputSize[otherDirection], outputSize[lineDirection] );
+  m_ModifiedLineEnds.assign( outputSize[otherDirection], 0 );
+  const long bufferStart = inputPtr->GetBufferedRegion().GetIndex()[m_ThetaDirection];
+  const long begin = vnl_math_max( m_ModifiedThetaBegin - bufferStart, 0l );
+  const long end = vnl_math_min( m_ModifiedThetaEnd - bufferStart, static_cast< long >( m_ThetaLineRuns.size() ) );
+  for( long theta = begin; theta < end; theta++ )
+    {
+    const std::vector< ThetaLineRunType > & runs = m_ThetaLineRuns[theta];
+    for( typename std::vector< ThetaLineRunType >::const_iterator run = runs.begin(); run != runs.end(); ++run )
+      {
+      m_ModifiedLineBegins[run->Line] = vnl_math_min( m_ModifiedLineBegins[run->Line], run->Begin );
+      m_ModifiedLineEnds[run->Line] = vnl_math_max( m_ModifiedLineEnds[run->Line], run->End );
+      }
+    }
+  return true;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeThetaLineRuns( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr )
+{
+  const unsigned int lineDirection = vnl_math_min( m_RDirection, m_ThetaDirection );
+  const unsigned int otherDirection = vnl_math_max( m_RDirection, m_ThetaDirection );
+  const long thetaSize = inputPtr->GetBufferedRegion().GetSize()[m_ThetaDirection];
+  m_ThetaLineRuns.assign( thetaSize, std::vector< ThetaLineRunType >() );
+
+  // The (R, Theta) plane is the same in every slice of an axis aligned
+  // input.
+  const OutputImageRegionType & largestRegion = outputPtr->GetLargestPossibleRegion();
+  OutputImageRegionType planeRegion = largestRegion;
+  typename OutputImageRegionType::SizeType planeSize = planeRegion.GetSize();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d != m_RDirection && d != m_ThetaDirection )
+      {
+      planeSize[d] = 1;
+      }
+    }
+  planeRegion.SetSize( planeSize );
+  const unsigned long lineLength = planeSize[lineDirection];
+
+  typedef typename LookupTableType::EntryType EntryType;
+  FrameScratchType scratch;
+  typedef ImageLinearConstIteratorWithIndex< OutputImageType > PlaneIteratorType;
+  PlaneIteratorType planeIt( outputPtr, planeRegion );
+  planeIt.SetDirection( lineDirection );
+  for( planeIt.GoToBegin(); !planeIt.IsAtEnd(); planeIt.NextLine() )
+    {
+    const typename OutputImageType::IndexType lineIndex = planeIt.GetIndex();
+    const unsigned long line = lineIndex[otherDirection] - largestRegion.GetIndex()[otherDirection];
+
+    unsigned long spanBegin = 0;
+    unsigned long spanEnd = 0;
+    const EntryType * entry = NULL;
+    const FixedPointEntryType * fixedPointEntry = NULL;
+    const TInterpolatorPrecision * footprints = NULL;
+    unsigned long entryStep = 1;
+    this->ComputeLineInterpolation( inputPtr, outputPtr, lineIndex, lineLength, scratch,
+      spanBegin, spanEnd, entry, fixedPointEntry, footprints, entryStep );
+
+    for( unsigned long i = spanBegin; i < spanEnd; i++ )
+      {
+      const EntryType & pixelEntry = entry[( i - spanBegin ) * entryStep];
+      if( pixelEntry.ThetaIndex < 0 )
+        {
+        continue;
+        }
+      long first;
+      long last;
+      this->ComputeThetaNeighborhood( pixelEntry,
+        footprints == NULL ? 0 : footprints[2 * ( i - spanBegin ) + 1], thetaSize, first, last );
+      for( long theta = first; theta <= last; theta++ )
+        {
+        std::vector< ThetaLineRunType > & runs = m_ThetaLineRuns[theta];
+        if( !runs.empty() && runs.back().Line == line && runs.back().End == i )
+          {
+          runs.back().End = i + 1;
+          }
+        else
+          {
+          ThetaLineRunType run;
+          run.Line = line;
+          run.Begin = i;
+          run.End = i + 1;
+          runs.push_back( run );
+          }
+        }
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeThetaNeighborhood( const typename LookupTableType::EntryType& entry,
+  TInterpolatorPrecision thetaFootprint,
+  long thetaSize,
+  long& first,
+  long& last ) const
+{
+  const long index = entry.ThetaIndex;
+  switch( m_InterpolationMode )
+    {
+  case CubicInterpolation:
+    first = index - 1;
+    last = index + 2;
+    break;
+  case WindowedSincInterpolation:
+    first = index - 2;
+    last = index + 3;
+    break;
+  case AntiAliasedInterpolation:
+    {
+    // The samples that overlap the box, and one more on each side for the
+    // rounding of its edges.
+    const double center = index + entry.ThetaWeight;
+    first = static_cast< long >( vcl_floor( center - 0.5 * thetaFootprint - 0.5 ) );
+    last = static_cast< long >( vcl_ceil( center + 0.5 * thetaFootprint + 0.5 ) );
+    break;
+    }
+  default:
+    // The nearest neighbor is one of the two linear neighbors.
+    first = index;
+    last = index + 1;
+    }
+  first = vnl_math_max( first, 0l );
+  last = vnl_math_min( last, thetaSize - 1 );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+int
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SplitRequestedRegion( int i, int num, OutputImageRegionType& splitRegion )
+{
+  const OutputImageRegionType & requestedRegion = this->GetOutput()->GetRequestedRegion();
+
+  // With enough frames, every thread converts whole frames.
+  const unsigned int numberOfFrames = this->GetNumberOfFrames();
+  if( numberOfFrames > 1 && numberOfFrames >= static_cast< unsigned int >( num ) )
+    {
+    splitRegion = requestedRegion;
+    return num;
+    }
+
+  return this->SplitRegion( requestedRegion, i, num, splitRegion );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+int
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SplitRegion( const OutputImageRegionType& requestedRegion, int i, int num,
+  OutputImageRegionType& splitRegion ) const
+{
+  // Split into whole slices of the outermost pass through direction that
+  // has enough of them.  If there is none, split into bands across the
+  // ThetaDirection so that each thread reads a contiguous range of A-lines.
+  // The lines in the RDirection are never split.
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const typename OutputImageRegionType::SizeType & requestedRegionSize = requestedRegion.GetSize();
+  int splitAxis = -1;
+  for( int d = ImageDimension - 1; d >= 0; d-- )
+    {
+    if( static_cast< unsigned int >( d ) != rDirection &&
+        static_cast< unsigned int >( d ) != thetaDirection &&
+        requestedRegionSize[d] >= static_cast< unsigned long >( num ) )
+      {
+      splitAxis = d;
+      break;
+      }
+    }
+  if( splitAxis < 0 )
+    {
+    splitAxis = requestedRegionSize[thetaDirection] > 1 ? thetaDirection : rDirection;
+    }
+
+  typename OutputImageRegionType::IndexType splitIndex = requestedRegion.GetIndex();
+  typename OutputImageRegionType::SizeType splitSize = requestedRegionSize;
+  const unsigned long range = requestedRegionSize[splitAxis];
+  const unsigned int valuesPerThread = static_cast< unsigned int >( vcl_ceil( range / static_cast< double >( num ) ) );
+  const unsigned int maxThreadIdUsed = static_cast< unsigned int >( vcl_ceil( range / static_cast< double >( valuesPerThread ) ) ) - 1;
+
+  if( static_cast< unsigned int >( i ) < maxThreadIdUsed )
+    {
+    splitIndex[splitAxis] += i * valuesPerThread;
+    splitSize[splitAxis] = valuesPerThread;
+    }
+  if( static_cast< unsigned int >( i ) == maxThreadIdUsed )
+    {
+    splitIndex[splitAxis] += i * valuesPerThread;
+    splitSize[splitAxis] = splitSize[splitAxis] - i * valuesPerThread;
+    }
+
+  splitRegion.SetIndex( splitIndex );
+  splitRegion.SetSize( splitSize );
+
+  return maxThreadIdUsed + 1;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ThreadedGenerateData( const OutputImageRegionType& outputRegionForThread, int threadId )
+{
+  const unsigned int numberOfFrames = this->GetNumberOfFrames();
+  const unsigned int numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+  FrameScratchType scratch;
+
+  if( numberOfFrames > 1 && numberOfFrames >= numberOfThreads )
+    {
+    const unsigned int threadFrames = ( numberOfFrames - threadId + numberOfThreads - 1 ) / numberOfThreads;
+    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() * threadFrames );
+    for( unsigned int frame = threadId; frame < numberOfFrames; frame += numberOfThreads )
+      {
+      this->ThreadedGenerateFrame( frame, outputRegionForThread, progress, scratch );
+      }
+    }
+  else
+    {
+    ProgressReporter progress( this, threadId, outputRegionForThread.GetNumberOfPixels() * numberOfFrames );
+    for( unsigned int frame = 0; frame < numberOfFrames; frame++ )
+      {
+      this->ThreadedGenerateFrame( frame, outputRegionForThread, progress, scratch );
+      }
+    }
+
+  if( m_UseInstrumentation )
+    {
+    m_ThreadCounters[threadId] = scratch.Counters;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeLineSpan( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  unsigned long lineLength,
+  unsigned long& begin,
+  unsigned long& end ) const
+{
+  begin = 0;
+  end = lineLength;
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
+
+  // The bounds below assume axis aligned images.
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  if( inputPtr->GetDirection() != identity || outputPtr->GetDirection() != identity )
+    {
+    return;
+    }
+
+  if( m_Transform->GetParameters()[4] == 0.0 )
+    {
+    return;
+    }
+  const double Rmin = m_CartesianToRTheta.GetRmin();
+
+  // Radius and angle limits of the input buffer, widened by a margin so that
+  // the span is conservative; the pixels inside of the span are still tested
+  // individually.
+  const double margin = 2.0;
+  const typename InputImageType::RegionType & bufferedRegion = inputPtr->GetBufferedRegion();
+  const typename InputImageType::PointType & inputOrigin = inputPtr->GetOrigin();
+  const typename InputImageType::SpacingType & inputSpacing = inputPtr->GetSpacing();
+  const double rLow = Rmin + inputOrigin[rDirection] +
+    inputSpacing[rDirection] * ( bufferedRegion.GetIndex()[rDirection] - margin );
+  const double rHigh = Rmin + inputOrigin[rDirection] +
+    inputSpacing[rDirection] * ( bufferedRegion.GetIndex()[rDirection] +
+    static_cast< double >( bufferedRegion.GetSize()[rDirection] ) - 1.0 + margin );
+  double thetaA = m_CartesianToRTheta.ThetaCoordinateToTheta( inputOrigin[thetaDirection] +
+    inputSpacing[thetaDirection] * ( bufferedRegion.GetIndex()[thetaDirection] - margin ) );
+  double thetaB = m_CartesianToRTheta.ThetaCoordinateToTheta( inputOrigin[thetaDirection] +
+    inputSpacing[thetaDirection] * ( bufferedRegion.GetIndex()[thetaDirection] +
+    static_cast< double >( bufferedRegion.GetSize()[thetaDirection] ) - 1.0 + margin ) );
+  if( !m_Transform->GetThetaArrayIsUniform() )
+    {
+    // A non-uniform array is inverted line by line.  Also include the angles
+    // interpolated at the fractional line indices of the buffer's ends and
+    // the whole array widened by the margin times its widest step.
+    const Array< double > & thetaArray = m_Transform->GetThetaArray();
+    const long lastSegment = static_cast< long >( thetaArray.Size() ) - 2;
+    double widestStep = 0.0;
+    for( long i = 0; i <= lastSegment; i++ )
+      {
+      widestStep = vnl_math_max( widestStep, vnl_math_abs( thetaArray[i + 1] - thetaArray[i] ) );
+      }
+    double limits[4];
+    limits[0] = thetaArray.min_value() - margin * widestStep;
+    limits[1] = thetaArray.max_value() + margin * widestStep;
+    for( unsigned int end = 0; end < 2; end++ )
+      {
+      const double index = inputOrigin[thetaDirection] / inputSpacing[thetaDirection] +
+        bufferedRegion.GetIndex()[thetaDirection] +
+        ( end == 0 ? -margin : static_cast< double >( bufferedRegion.GetSize()[thetaDirection] ) - 1.0 + margin );
+      const long line = vnl_math_min( vnl_math_max( static_cast< long >( vcl_floor( index ) ), 0l ), lastSegment );
+      limits[2 + end] = thetaArray[line] + ( index - line ) * ( thetaArray[line + 1] - thetaArray[line] );
+      }
+    const double linearLow = vnl_math_min( thetaA, thetaB );
+    const double linearHigh = vnl_math_max( thetaA, thetaB );
+    thetaA = linearLow;
+    thetaB = linearHigh;
+    for( unsigned int i = 0; i < 4; i++ )
+      {
+      thetaA = vnl_math_min( thetaA, limits[i] );
+      thetaB = vnl_math_max( thetaB, limits[i] );
+      }
+    }
+  const double halfPi = vnl_math::pi_over_2;
+  const double tanThetaLow = vcl_tan( vnl_math_max( vnl_math_min( thetaA, thetaB ), -halfPi + 1.0e-6 ) );
+  const double tanThetaHigh = vcl_tan( vnl_math_min( vnl_math_max( thetaA, thetaB ), halfPi - 1.0e-6 ) );
+  const double rHighSquared = rHigh * rHigh;
+  const double rLowSquared = rLow > 0.0 ? rLow * rLow : 0.0;
+
+  typedef Point< double, ImageDimension > LinePointType;
+  LinePointType lineStart;
+  LinePointType lineEnd;
+  typename OutputImageType::IndexType index = lineIndex;
+  outputPtr->TransformIndexToPhysicalPoint( index, lineStart );
+  index[lineDirection] += lineLength - 1;
+  outputPtr->TransformIndexToPhysicalPoint( index, lineEnd );
+  const double x0 = lineStart[rDirection];
+  const double y0 = lineStart[thetaDirection];
+  // The transform takes the arc tangent of y / x, which folds the half plane
+  // x <= 0 onto the sector.  Those pixels are always kept in the span.
+  const double xMin = vnl_math_min( x0, lineEnd[rDirection] );
+  if( xMin <= 0.0 && lineDirection != rDirection )
+    {
+    return;
+    }
+
+  double low;
+  double high;
+  double start;
+  double step;
+  if( lineDirection == rDirection )
+    {
+    // x varies along the line and y is fixed.
+    const double y = y0;
+    if( y * y > rHighSquared )
+      {
+      begin = end = 0;
+      return;
+      }
+    low = vcl_sqrt( vnl_math_max( rLowSquared - y * y, 0.0 ) );
+    high = vcl_sqrt( rHighSquared - y * y );
+    // tan( ThetaLow ) x <= y <= tan( ThetaHigh ) x
+    if( tanThetaHigh > 0.0 )
+      {
+      low = vnl_math_max( low, y / tanThetaHigh );
+      }
+    else if( tanThetaHigh < 0.0 )
+      {
+      high = vnl_math_min( high, y / tanThetaHigh );
+      }
+    else if( y > 0.0 )
+      {
+      high = -1.0;
+      }
+    if( tanThetaLow < 0.0 )
+      {
+      low = vnl_math_max( low, y / tanThetaLow );
+      }
+    else if( tanThetaLow > 0.0 )
+      {
+      high = vnl_math_min( high, y / tanThetaLow );
+      }
+    else if( y < 0.0 )
+      {
+      high = -1.0;
+      }
+    if( xMin <= 0.0 )
+      {
+      low = xMin;
+      high = vnl_math_max( high, 0.0 );
+      }
+    start = x0;
+    step = lineLength > 1 ? ( lineEnd[rDirection] - x0 ) / ( lineLength - 1 ) : 1.0;
+    }
+  else
+    {
+    // y varies along the line and x is fixed.  The hole inside of Rmin is
+    // not excluded.
+    const double x = x0;
+    if( x * x > rHighSquared )
+      {
+      begin = end = 0;
+      return;
+      }
+    const double yMax = vcl_sqrt( rHighSquared - x * x );
+    low = vnl_math_max( tanThetaLow * x, -yMax );
+    high = vnl_math_min( tanThetaHigh * x, yMax );
+    start = y0;
+    step = lineLength > 1 ? ( lineEnd[thetaDirection] - y0 ) / ( lineLength - 1 ) : 1.0;
+    }
+
+  if( high < low || step == 0.0 )
+    {
+    begin = end = 0;
+    return;
+    }
+
+  double first = ( low - start ) / step;
+  double last = ( high - start ) / step;
+  if( step < 0.0 )
+    {
+    std::swap( first, last );
+    }
+  // One more pixel on both sides absorbs the rounding of the bounds.
+  first = vcl_floor( first ) - 1.0;
+  last = vcl_ceil( last ) + 2.0;
+  const double length = static_cast< double >( lineLength );
+  begin = static_cast< unsigned long >( vnl_math_min( vnl_math_max( first, 0.0 ), length ) );
+  end = static_cast< unsigned long >( vnl_math_min( vnl_math_max( last, 0.0 ), length ) );
+  if( end < begin )
+    {
+    end = begin;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeLineInterpolation( const InputImageType * inputPtr,
+  const OutputImageType * outputPtr,
+  const typename OutputImageType::IndexType& lineIndex,
+  unsigned long lineLength,
+  FrameScratchType& scratch,
+  unsigned long& spanBegin,
+  unsigned long& spanEnd,
+  const typename LookupTableType::EntryType *& entry,
+  const FixedPointEntryType *& fixedPointEntry,
+  const TInterpolatorPrecision *& footprints,
+  unsigned long& entryStep ) const
+{
+  const unsigned int lineDirection = vnl_math_min( m_RDirection, m_ThetaDirection );
+
+  // Only the span of the line that can fall inside of the imaging sector
+  // is interpolated.
+  if( m_UseLookupTable )
+    {
+    typedef typename LookupTableType::SpanType SpanType;
+    const long lineOffset = lineIndex[lineDirection] -
+      outputPtr->GetLargestPossibleRegion().GetIndex()[lineDirection];
+    const SpanType & span = m_LookupTable->GetSpan( lineIndex );
+    spanBegin = static_cast< unsigned long >( vnl_math_max( static_cast< long >( span.Begin ) - lineOffset, 0l ) );
+    spanEnd = static_cast< unsigned long >( vnl_math_max( static_cast< long >( span.End ) - lineOffset, 0l ) );
+    spanBegin = vnl_math_min( spanBegin, lineLength );
+    spanEnd = vnl_math_max( vnl_math_min( spanEnd, lineLength ), spanBegin );
+    }
+  else
+    {
+    this->ComputeLineSpan( inputPtr, outputPtr, lineIndex, lineLength, spanBegin, spanEnd );
+    }
+
+  entry = NULL;
+  fixedPointEntry = NULL;
+  footprints = NULL;
+  entryStep = 1;
+  if( spanEnd > spanBegin )
+    {
+    if( m_InterpolationMode == AntiAliasedInterpolation )
+      {
+      typename OutputImageType::IndexType spanIndex = lineIndex;
+      spanIndex[lineDirection] += spanBegin;
+      this->ComputeLineFootprints( outputPtr, spanIndex, spanEnd - spanBegin, scratch.LineFootprints );
+      footprints = &scratch.LineFootprints[0];
+      }
+
+    if( m_UseLookupTable )
+      {
+      entryStep = ( lineDirection == m_RDirection ) ?
+        m_LookupTable->GetRStride() : m_LookupTable->GetThetaStride();
+      entry = &( m_LookupTable->GetEntry( lineIndex ) ) + spanBegin * entryStep;
+      if( m_FixedPointInterpolation )
+        {
+        fixedPointEntry = &( m_LookupTable->GetFixedPointEntry( lineIndex ) ) + spanBegin * entryStep;
+        scratch.Counters.LookupTableBytesRead += ( spanEnd - spanBegin ) * sizeof( FixedPointEntryType );
+        }
+      else
+        {
+        scratch.Counters.LookupTableBytesRead +=
+          ( spanEnd - spanBegin ) * sizeof( typename LookupTableType::EntryType );
+        }
+      }
+    else
+      {
+      typename OutputImageType::IndexType spanIndex = lineIndex;
+      spanIndex[lineDirection] += spanBegin;
+      this->ComputeLineEntries( inputPtr, outputPtr, spanIndex, spanEnd - spanBegin,
+        scratch.LineCoordinates, scratch.LineEntries );
+      entry = &scratch.LineEntries[0];
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+template < unsigned int VNumberOfSlices, class TSampleReader >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpan( const InputLayoutType& input,
+  const TSampleReader& sample,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  const unsigned int slices = VNumberOfSlices > 0 ? VNumberOfSlices : numberOfSlices;
+  const long rOffset = input.ROffset;
+  const long thetaOffset = input.ThetaOffset;
+  const long rStep = input.RStep;
+  const long thetaStep = input.ThetaStep;
+
+  for( unsigned long i = 0; i < length; i++ )
+    {
+    if( entry->ThetaIndex < 0 )
+      {
+      *out = m_DefaultPixelValue;
+      }
+    else
+      {
+      const InputPixelType * plane = input.Buffer + entry->RIndex * rOffset + entry->ThetaIndex * thetaOffset;
+      const TInterpolatorPrecision rWeight = entry->RWeight;
+      const TInterpolatorPrecision thetaWeight = entry->ThetaWeight;
+      double value;
+      if( VNumberOfSlices == 1 )
+        {
+        const InputPixelType * p = plane + sliceOffsets[0];
+        const TInterpolatorPrecision lower = ( 1.0 - rWeight ) * sample( p[0] ) + rWeight * sample( p[rStep] );
+        const TInterpolatorPrecision upper = ( 1.0 - rWeight ) * sample( p[thetaStep] ) + rWeight * sample( p[thetaStep + rStep] );
+        value = ( 1.0 - thetaWeight ) * lower + thetaWeight * upper;
+        }
+      else
+        {
+        value = 0.0;
+        for( unsigned int slice = 0; slice < slices; slice++ )
+          {
+          const InputPixelType * p = plane + sliceOffsets[slice];
+          const TInterpolatorPrecision lower = ( 1.0 - rWeight ) * sample( p[0] ) + rWeight * sample( p[rStep] );
+          const TInterpolatorPrecision upper = ( 1.0 - rWeight ) * sample( p[thetaStep] ) + rWeight * sample( p[thetaStep + rStep] );
+          value += sliceWeights[slice] * ( ( 1.0 - thetaWeight ) * lower + thetaWeight * upper );
+          }
+        }
+      *out = SaturateOutputValue( value );
+      }
+    out += outputStep;
+    entry += entryStep;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+typename ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >::OutputPixelType
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::SaturateOutputValue( double value )
+{
+  if( value < static_cast< double >( NumericTraits< OutputPixelType >::NonpositiveMin() ) )
+    {
+    return NumericTraits< OutputPixelType >::NonpositiveMin();
+    }
+  if( value > static_cast< double >( NumericTraits< OutputPixelType >::max() ) )
+    {
+    return NumericTraits< OutputPixelType >::max();
+    }
+  return static_cast< OutputPixelType >( value );
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanFixedPoint( const InputLayoutType& input,
+  long sliceOffset,
+  const FixedPointEntryType * fixedPointEntry,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  const InputPixelType * buffer = input.Buffer + sliceOffset;
+  const long rStep = input.RStep;
+  const long thetaStep = input.ThetaStep;
+
+  // The weights are not negative, so the value is within the range of the
+  // input, and only an output type narrower than the input saturates.
+  const int shift = LookupTableType::FixedPointShift;
+  const int half = 1 << ( shift - 1 );
+  const int minOutputValue = static_cast< int >( vnl_math_max(
+    static_cast< double >( NumericTraits< OutputPixelType >::NonpositiveMin() ), -2147483648.0 ) );
+  const int maxOutputValue = static_cast< int >( vnl_math_min(
+    static_cast< double >( NumericTraits< OutputPixelType >::max() ), 2147483647.0 ) );
+
+  for( unsigned long i = 0; i < length; i++ )
+    {
+    if( fixedPointEntry->BufferOffset < 0 )
+      {
+      *out = m_DefaultPixelValue;
+      }
+    else
+      {
+      const InputPixelType * p = buffer + fixedPointEntry->BufferOffset;
+      const unsigned short * weights = fixedPointEntry->Weights;
+      int value = static_cast< int >( p[0] ) * weights[0] +
+        static_cast< int >( p[rStep] ) * weights[1] +
+        static_cast< int >( p[thetaStep] ) * weights[2] +
+        static_cast< int >( p[thetaStep + rStep] ) * weights[3];
+      value = ( value + half ) >> shift;
+      value = vnl_math_min( vnl_math_max( value, minOutputValue ), maxOutputValue );
+      *out = static_cast< OutputPixelType >( value );
+      }
+    out += outputStep;
+    fixedPointEntry += entryStep;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+template < class TSampleReader >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanNearestNeighbor( const InputLayoutType& input,
+  const TSampleReader& sample,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  // Halfway between two samples rounds up, as in
+  // NearestNeighborInterpolateImageFunction.
+  for( unsigned long i = 0; i < length; i++ )
+    {
+    if( entry->ThetaIndex < 0 )
+      {
+      *out = m_DefaultPixelValue;
+      }
+    else
+      {
+      const InputPixelType * nearest = input.Buffer +
+        entry->RIndex * input.ROffset + entry->ThetaIndex * input.ThetaOffset +
+        ( entry->RWeight >= 0.5 ? input.RStep : 0 ) +
+        ( entry->ThetaWeight >= 0.5 ? input.ThetaStep : 0 );
+      double value;
+      if( numberOfSlices == 1 )
+        {
+        value = sample( nearest[sliceOffsets[0]] );
+        }
+      else
+        {
+        value = 0.0;
+        for( unsigned int slice = 0; slice < numberOfSlices; slice++ )
+          {
+          value += sliceWeights[slice] * sample( nearest[sliceOffsets[slice]] );
+          }
+        }
+      *out = SaturateOutputValue( value );
+      }
+    out += outputStep;
+    entry += entryStep;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+template < unsigned int VNumberOfTaps, class TSampleReader >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanWithKernel( const InputLayoutType& input,
+  const TSampleReader& sample,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  const long firstTap = 1 - static_cast< long >( VNumberOfTaps / 2 );
+  const long lastR = input.RSize - 1;
+  const long lastTheta = input.ThetaSize - 1;
+  const TInterpolatorPrecision * kernel = &m_KernelWeights[0];
+  const TInterpolatorPrecision phases = static_cast< TInterpolatorPrecision >( NumberOfKernelPhases );
+
+  long rOffsets[VNumberOfTaps];
+  long thetaOffsets[VNumberOfTaps];
+  for( unsigned long i = 0; i < length; i++ )
+    {
+    if( entry->ThetaIndex < 0 )
+      {
+      *out = m_DefaultPixelValue;
+      }
+    else
+      {
+      const TInterpolatorPrecision * rKernel = kernel +
+        VNumberOfTaps * static_cast< long >( entry->RWeight * phases + 0.5 );
+      const TInterpolatorPrecision * thetaKernel = kernel +
+        VNumberOfTaps * static_cast< long >( entry->ThetaWeight * phases + 0.5 );
+      for( unsigned int k = 0; k < VNumberOfTaps; k++ )
+        {
+        const long r = entry->RIndex + firstTap + static_cast< long >( k );
+        const long theta = entry->ThetaIndex + firstTap + static_cast< long >( k );
+        rOffsets[k] = vnl_math_min( vnl_math_max( r, 0l ), lastR ) * input.ROffset;
+        thetaOffsets[k] = vnl_math_min( vnl_math_max( theta, 0l ), lastTheta ) * input.ThetaOffset;
+        }
+
+      double value = 0.0;
+      for( unsigned int slice = 0; slice < numberOfSlices; slice++ )
+        {
+        const InputPixelType * p = input.Buffer + sliceOffsets[slice];
+        TInterpolatorPrecision sliceValue = 0.0;
+        for( unsigned int j = 0; j < VNumberOfTaps; j++ )
+          {
+          const InputPixelType * row = p + thetaOffsets[j];
+          TInterpolatorPrecision rowValue = 0.0;
+          for( unsigned int k = 0; k < VNumberOfTaps; k++ )
+            {
+            rowValue += rKernel[k] * sample( row[rOffsets[k]] );
+            }
+          sliceValue += thetaKernel[j] * rowValue;
+          }
+        value += ( numberOfSlices == 1 ) ? sliceValue : sliceWeights[slice] * sliceValue;
+        }
+      *out = SaturateOutputValue( value );
+      }
+    out += outputStep;
+    entry += entryStep;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeBoxTaps( double center,
+  double footprint,
+  long size,
+  long indices[4],
+  double weights[4] )
+{
+  // center is within [0, size - 1] and footprint at least 1.
+  const double lower = vnl_math_max( center - 0.5 * footprint, -0.5 );
+  const double upper = vnl_math_min( center + 0.5 * footprint, size - 0.5 );
+  const double scale = 1.0 / ( upper - lower );
+
+  // The sum up to an edge at x interpolates the table linearly between
+  // entries floor( x - 0.5 ) and floor( x - 0.5 ) + 1.  x - 0.5 >= -1, so
+  // the floor is a truncation.
+  const double lowerEdge = lower - 0.5;
+  const long lowerIndex = static_cast< long >( lowerEdge + 1.0 ) - 1;
+  const double lowerFraction = lowerEdge - lowerIndex;
+  indices[0] = lowerIndex;
+  indices[1] = lowerIndex + 1;
+  weights[0] = scale * ( lowerFraction - 1.0 );
+  weights[1] = -scale * lowerFraction;
+
+  const double upperEdge = upper - 0.5;
+  const long upperIndex = vnl_math_min( static_cast< long >( upperEdge + 1.0 ) - 1, size - 1 );
+  const double upperFraction = upperEdge - upperIndex;
+  indices[2] = upperIndex;
+  indices[3] = vnl_math_min( upperIndex + 1, size - 1 );
+  weights[2] = scale * ( 1.0 - upperFraction );
+  weights[3] = scale * upperFraction;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeCompressionTable()
+{
+  if( !m_UseLogCompression ||
+      !NumericTraits< InputPixelType >::is_integer ||
+      sizeof( InputPixelType ) > 2 )
+    {
+    m_CompressionTable.clear();
+    return;
+    }
+  if( !m_CompressionTable.empty() && m_CompressionTableFunctor == m_LogCompressionFunctor )
+    {
+    return;
+    }
+
+  const long minimum = static_cast< long >( NumericTraits< InputPixelType >::NonpositiveMin() );
+  const long maximum = static_cast< long >( NumericTraits< InputPixelType >::max() );
+  m_CompressionTable.resize( maximum - minimum + 1 );
+  for( long value = minimum; value <= maximum; value++ )
+    {
+    m_CompressionTable[value - minimum] = m_LogCompressionFunctor( static_cast< InputPixelType >( value ) );
+    }
+  m_CompressionTableFunctor = m_LogCompressionFunctor;
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeSummedAreaTables()
+{
+  if( m_InterpolationMode != AntiAliasedInterpolation )
+    {
+    m_SummedAreaTables.clear();
+    m_SummedAreaBuffers.clear();
+    m_SummedAreaRegions.clear();
+    m_SummedAreaTimes.clear();
+    return;
+    }
+
+  // Changing the compression invalidates every table.
+  if( m_SummedAreaLogCompression != m_UseLogCompression ||
+      ( m_UseLogCompression && m_SummedAreaFunctor != m_LogCompressionFunctor ) )
+    {
+    m_SummedAreaBuffers.clear();
+    m_SummedAreaLogCompression = m_UseLogCompression;
+    m_SummedAreaFunctor = m_LogCompressionFunctor;
+    }
+
+  // A table is kept while its frame's buffer is unchanged, so that a new
+  // viewport of the same input only pays for its output pixels.
+  const unsigned int numberOfFrames = this->GetNumberOfFrames();
+  m_SummedAreaTables.resize( numberOfFrames );
+  m_SummedAreaBuffers.resize( numberOfFrames, NULL );
+  m_SummedAreaRegions.resize( numberOfFrames );
+  m_SummedAreaTimes.resize( numberOfFrames, 0 );
+  for( unsigned int frame = 0; frame < numberOfFrames; frame++ )
+    {
+    const InputImageType * inputPtr = this->GetInput( frame );
+    if( m_SummedAreaBuffers[frame] != inputPtr->GetBufferPointer() ||
+        m_SummedAreaRegions[frame] != inputPtr->GetBufferedRegion() ||
+        m_SummedAreaTimes[frame] != inputPtr->GetMTime() )
+      {
+      this->ComputeSummedAreaTable( frame );
+      if( m_UseInstrumentation )
+        {
+        m_Instrumentation.SummedAreaTableMisses++;
+        }
+      }
+    else if( m_UseInstrumentation )
+      {
+      m_Instrumentation.SummedAreaTableHits++;
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ComputeSummedAreaTable( unsigned int frame )
+{
+  const InputImageType * inputPtr = this->GetInput( frame );
+  const unsigned long numberOfPixels = inputPtr->GetBufferedRegion().GetNumberOfPixels();
+  std::vector< double > & table = m_SummedAreaTables[frame];
+  table.resize( numberOfPixels );
+  const InputPixelType * buffer = inputPtr->GetBufferPointer();
+  if( !m_UseLogCompression )
+    {
+    std::copy( buffer, buffer + numberOfPixels, table.begin() );
+    }
+  else if( !m_CompressionTable.empty() )
+    {
+    const TInterpolatorPrecision * compression = &m_CompressionTable[0] -
+      static_cast< long >( NumericTraits< InputPixelType >::NonpositiveMin() );
+    for( unsigned long k = 0; k < numberOfPixels; k++ )
+      {
+      table[k] = compression[static_cast< long >( buffer[k] )];
+      }
+    }
+  else
+    {
+    for( unsigned long k = 0; k < numberOfPixels; k++ )
+      {
+      table[k] = m_LogCompressionFunctor( buffer[k] );
+      }
+    }
+
+  // Running sums along each of the two directions.  A direction with
+  // offset o and n samples splits the buffer into blocks of o * n.
+  const unsigned int planeDirections[2] = { m_RDirection, m_ThetaDirection };
+  for( unsigned int i = 0; i < 2; i++ )
+    {
+    const unsigned long stride = inputPtr->GetOffsetTable()[planeDirections[i]];
+    const unsigned long size = inputPtr->GetBufferedRegion().GetSize()[planeDirections[i]];
+    for( unsigned long block = 0; block < numberOfPixels; block += stride * size )
+      {
+      for( unsigned long k = 1; k < size; k++ )
+        {
+        double * row = &table[block + k * stride];
+        const double * previous = row - stride;
+        for( unsigned long j = 0; j < stride; j++ )
+          {
+          row[j] += previous[j];
+          }
+        }
+      }
+    }
+
+  m_SummedAreaBuffers[frame] = buffer;
+  m_SummedAreaRegions[frame] = inputPtr->GetBufferedRegion();
+  m_SummedAreaTimes[frame] = inputPtr->GetMTime();
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanAntiAliased( const InputLayoutType& input,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  const TInterpolatorPrecision * footprints,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  long rIndices[4];
+  long thetaIndices[4];
+  double rWeights[4];
+  double thetaWeights[4];
+  long rOffsets[4];
+  long thetaOffsets[4];
+  for( unsigned long i = 0; i < length; i++ )
+    {
+    if( entry->ThetaIndex < 0 )
+      {
+      *out = m_DefaultPixelValue;
+      }
+    else
+      {
+      ComputeBoxTaps( entry->RIndex + entry->RWeight, footprints[0],
+        input.RSize, rIndices, rWeights );
+      ComputeBoxTaps( entry->ThetaIndex + entry->ThetaWeight, footprints[1],
+        input.ThetaSize, thetaIndices, thetaWeights );
+      for( unsigned int k = 0; k < 4; k++ )
+        {
+        rOffsets[k] = rIndices[k] * input.ROffset;
+        thetaOffsets[k] = thetaIndices[k] * input.ThetaOffset;
+        }
+
+      // Since both sets of weights sum to 0, every row of the table can be
+      // taken relative to its entry at the lowest R index, and the weighted
+      // rows relative to the lowest row.  The differences are exact for
+      // integer pixels and much smaller than the entries, which keeps the
+      // rounding error small.  Only the lowest indices can be -1, where the
+      // entries are 0.
+      double value = 0.0;
+      for( unsigned int slice = 0; slice < numberOfSlices; slice++ )
+        {
+        const double * table = input.SummedAreas + sliceOffsets[slice];
+        double rowSums[4];
+        for( unsigned int j = 0; j < 4; j++ )
+          {
+          rowSums[j] = 0.0;
+          if( thetaIndices[j] >= 0 )
+            {
+            const double * row = table + thetaOffsets[j];
+            const double first = ( rIndices[0] >= 0 ) ? row[rOffsets[0]] : 0.0;
+            for( unsigned int k = 1; k < 4; k++ )
+              {
+              rowSums[j] += rWeights[k] * ( row[rOffsets[k]] - first );
+              }
+            }
+          }
+        double sliceValue = 0.0;
+        for( unsigned int j = 1; j < 4; j++ )
+          {
+          sliceValue += thetaWeights[j] * ( rowSums[j] - rowSums[0] );
+          }
+        value += ( numberOfSlices == 1 ) ? sliceValue : sliceWeights[slice] * sliceValue;
+        }
+      *out = SaturateOutputValue( value );
+      }
+    out += outputStep;
+    entry += entryStep;
+    footprints += 2;
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanWithMode( const InputLayoutType& input,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  const FixedPointEntryType * fixedPointEntry,
+  const TInterpolatorPrecision * footprints,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  if( !m_UseLogCompression )
+    {
+    PixelSampleReader sample;
+    this->InterpolateSpanWithReader( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, fixedPointEntry, footprints, entryStep, out, outputStep, length );
+    }
+  else if( !m_CompressionTable.empty() )
+    {
+    TableSampleReader sample;
+    sample.Table = &m_CompressionTable[0] -
+      static_cast< long >( NumericTraits< InputPixelType >::NonpositiveMin() );
+    this->InterpolateSpanWithReader( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, fixedPointEntry, footprints, entryStep, out, outputStep, length );
+    }
+  else
+    {
+    FunctorSampleReader sample;
+    sample.Functor = &m_LogCompressionFunctor;
+    this->InterpolateSpanWithReader( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, fixedPointEntry, footprints, entryStep, out, outputStep, length );
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+template < class TSampleReader >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::InterpolateSpanWithReader( const InputLayoutType& input,
+  const TSampleReader& sample,
+  const long * sliceOffsets,
+  const TInterpolatorPrecision * sliceWeights,
+  unsigned int numberOfSlices,
+  const typename LookupTableType::EntryType * entry,
+  const FixedPointEntryType * fixedPointEntry,
+  const TInterpolatorPrecision * footprints,
+  unsigned long entryStep,
+  OutputPixelType * out,
+  long outputStep,
+  unsigned long length ) const
+{
+  switch( m_InterpolationMode )
+    {
+  case NearestNeighborInterpolation:
+    this->InterpolateSpanNearestNeighbor( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, entryStep, out, outputStep, length );
+    break;
+  case CubicInterpolation:
+    this->template InterpolateSpanWithKernel< 4 >( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, entryStep, out, outputStep, length );
+    break;
+  case WindowedSincInterpolation:
+    this->template InterpolateSpanWithKernel< 6 >( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, entryStep, out, outputStep, length );
+    break;
+  case AntiAliasedInterpolation:
+    this->InterpolateSpanAntiAliased( input, sliceOffsets, sliceWeights, numberOfSlices,
+      entry, footprints, entryStep, out, outputStep, length );
+    break;
+  default:
+    // Two dimensional images and slices that coincide with an input slice
+    // read a single slice.
+    if( numberOfSlices == 1 && fixedPointEntry != NULL )
+      {
+      this->InterpolateSpanFixedPoint( input, sliceOffsets[0], fixedPointEntry,
+        entryStep, out, outputStep, length );
+      }
+    else if( ImageDimension == 2 || numberOfSlices == 1 )
+      {
+      this->template InterpolateSpan< 1 >( input, sample, sliceOffsets, sliceWeights, 1,
+        entry, entryStep, out, outputStep, length );
+      }
+    else if( numberOfSlices == 2 )
+      {
+      this->template InterpolateSpan< 2 >( input, sample, sliceOffsets, sliceWeights, 2,
+        entry, entryStep, out, outputStep, length );
+      }
+    else
+      {
+      this->template InterpolateSpan< 0 >( input, sample, sliceOffsets, sliceWeights, numberOfSlices,
+        entry, entryStep, out, outputStep, length );
+      }
+    }
+}
+
+template < class TInputImage, class TOutputImage, class TInterpolatorPrecision >
+void
+ResampleRThetaToCartesianImageFilter< TInputImage, TOutputImage, TInterpolatorPrecision >
+::ThreadedGenerateFrame( unsigned int frame,
+  const OutputImageRegionType& outputRegionForThread,
+  ProgressReporter& progress,
+  FrameScratchType& scratch )
+{
+  const InputImageType * inputPtr = this->GetInput( frame );
+  OutputImageType * outputPtr = this->GetOutput( frame );
+
+  const unsigned int rDirection = m_RDirection;
+  const unsigned int thetaDirection = m_ThetaDirection;
+
+  InputLayoutType input;
+  input.Buffer = inputPtr->GetBufferPointer();
+  input.SummedAreas = m_SummedAreaTables.empty() ? NULL : &m_SummedAreaTables[frame][0];
+  const typename InputImageType::SizeType & inputSize = inputPtr->GetBufferedRegion().GetSize();
+  input.ROffset = inputPtr->GetOffsetTable()[rDirection];
+  input.ThetaOffset = inputPtr->GetOffsetTable()[thetaDirection];
+  // Neighbors in a direction with a single sample carry zero weight.
+  input.RStep = inputSize[rDirection] > 1 ? input.ROffset : 0;
+  input.ThetaStep = inputSize[thetaDirection] > 1 ? input.ThetaOffset : 0;
+  input.RSize = inputSize[rDirection];
+  input.ThetaSize = inputSize[thetaDirection];
+
+  // Walk the output along whichever of the two plane directions is stored
+  // first so that consecutive pixels read consecutive table entries.
+  const unsigned int lineDirection = vnl_math_min( rDirection, thetaDirection );
+  const unsigned int otherDirection = vnl_math_max( rDirection, thetaDirection );
+  const unsigned long lineLength = outputRegionForThread.GetSize()[lineDirection];
+  const typename OutputImageType::IndexType & largestIndex = outputPtr->GetLargestPossibleRegion().GetIndex();
+
+  OutputPixelType * outputBuffer = outputPtr->GetBufferPointer();
+  const long outputStep = outputPtr->GetOffsetTable()[lineDirection];
+
+  // When the input is axis aligned, the (R, Theta) plane maps to the input
+  // the same way in every slice of the pass through directions, and a
+  // slice's neighbors do not depend on the position in the plane.  The
+  // neighbors of every slice are then computed once here, and the span and
+  // interpolation neighborhoods of each line once for all the slices.
+  typename InputImageType::DirectionType identity;
+  identity.SetIdentity();
+  const bool sharePlane = ( inputPtr->GetDirection() == identity );
+
+  typedef typename OutputImageType::IndexType OutputIndexType;
+  OutputImageRegionType planeRegion = outputRegionForThread;
+  OutputImageRegionType sliceRegion = outputRegionForThread;
+  typename OutputImageRegionType::SizeType planeSize = planeRegion.GetSize();
+  typename OutputImageRegionType::SizeType sliceSize = sliceRegion.GetSize();
+  for( unsigned int d = 0; d < ImageDimension; d++ )
+    {
+    if( d == rDirection || d == thetaDirection )
+      {
+      sliceSize[d] = 1;
+      }
+    else
+      {
+      planeSize[d] = 1;
+      }
+    }
+  planeRegion.SetSize( planeSize );
+  sliceRegion.SetSize( sliceSize );
+
+  std::vector< OutputIndexType > & sliceIndices = scratch.SliceIndices;
+  std::vector< unsigned int > & sliceStarts = scratch.SliceStarts;
+  std::vector< long > & sliceOffsets = scratch.SliceOffsets;
+  std::vector< TInterpolatorPrecision > & sliceWeights = scratch.SliceWeights;
+  sliceIndices.clear();
+  sliceStarts.clear();
+  sliceOffsets.clear();
+  sliceWeights.clear();
+  bool anySliceInside = false;
+  typedef ImageRegionConstIteratorWithIndex< OutputImageType > SliceIteratorType;
+  for( SliceIteratorType sliceIt( outputPtr, sliceRegion ); !sliceIt.IsAtEnd(); ++sliceIt )
+    {
+    sliceIndices.push_back( sliceIt.GetIndex() );
+    sliceStarts.push_back( sliceOffsets.size() );
+    if( sharePlane )
+      {
+      this->ComputeSliceNeighbors( inputPtr, outputPtr, sliceIt.GetIndex(), sliceOffsets, sliceWeights );
+      anySliceInside = anySliceInside || sliceOffsets.size() > sliceStarts.back();
+      }
+    }
+  sliceStarts.push_back( sliceOffsets.size() );
+  const unsigned int numberOfSliceIndices = sliceIndices.size();
+
+  typedef typename LookupTableType::EntryType EntryType;
+  typedef ImageLinearConstIteratorWithIndex< OutputImageType > PlaneIteratorType;
+  PlaneIteratorType planeIt( outputPtr, planeRegion );
+  planeIt.SetDirection( lineDirection );
+  for( planeIt.GoToBegin(); !planeIt.IsAtEnd(); planeIt.NextLine() )
+    {
+    OutputIndexType lineIndex = planeIt.GetIndex();
+
+    // An incremental update only converts the pixels of the line that read
+    // a modified Theta line.
+    unsigned long length = lineLength;
+    if( m_IncrementalUpdate )
+      {
+      const unsigned long line = lineIndex[otherDirection] - largestIndex[otherDirection];
+      const long lineOffset = lineIndex[lineDirection] - largestIndex[lineDirection];
+      const long begin = vnl_math_max( static_cast< long >( m_ModifiedLineBegins[line] ) - lineOffset, 0l );
+      const long end = vnl_math_min( static_cast< long >( m_ModifiedLineEnds[line] ) - lineOffset,
+        static_cast< long >( lineLength ) );
+      if( end <= begin )
+        {
+        for( unsigned long i = 0; i < lineLength * numberOfSliceIndices; i++ )
+          {
+          progress.CompletedPixel();
+          }
+        continue;
+        }
+      lineIndex[lineDirection] += begin;
+      length = end - begin;
+      }
+
+    unsigned long spanBegin = 0;
+    unsigned long spanEnd = 0;
+    const EntryType * entry = NULL;
+    const FixedPointEntryType * fixedPointEntry = NULL;
+    const TInterpolatorPrecision * footprints = NULL;
+    unsigned long entryStep = 1;
+    if( sharePlane && anySliceInside )
+      {
+      this->ComputeLineInterpolation( inputPtr, outputPtr, lineIndex, length, scratch,
+        spanBegin, spanEnd, entry, fixedPointEntry, footprints, entryStep );
+      }
+
+    for( unsigned int slice = 0; slice < numberOfSliceIndices; slice++ )
+      {
+      for( unsigned int d = 0; d < ImageDimension; d++ )
+        {
+        if( d != rDirection && d != thetaDirection )
+          {
+          lineIndex[d] = sliceIndices[slice][d];
+          }
+        }
+      OutputPixelType * outputLine = outputBuffer + outputPtr->ComputeOffset( lineIndex );
+
+      const long * neighborOffsets;
+      const TInterpolatorPrecision * neighborWeights;
+      unsigned int numberOfNeighbors;
+      if( sharePlane )
+        {
+        numberOfNeighbors = sliceStarts[slice + 1] - sliceStarts[slice];
+        neighborOffsets = numberOfNeighbors > 0 ? &sliceOffsets[sliceStarts[slice]] : NULL;
+        neighborWeights = numberOfNeighbors > 0 ? &sliceWeights[sliceStarts[slice]] : NULL;
+        }
+      else
+        {
+        // The table is empty; it holds the neighbors of this line instead.
+        sliceOffsets.clear();
+        sliceWeights.clear();
+        this->ComputeSliceNeighbors( inputPtr, outputPtr, lineIndex, sliceOffsets, sliceWeights );
+        numberOfNeighbors = sliceOffsets.size();
+        neighborOffsets = numberOfNeighbors > 0 ? &sliceOffsets[0] : NULL;
+        neighborWeights = numberOfNeighbors > 0 ? &sliceWeights[0] : NULL;
+        spanBegin = 0;
+        spanEnd = 0;
+        if( numberOfNeighbors > 0 )
+          {
+          this->ComputeLineInterpolation( inputPtr, outputPtr, lineIndex, length, scratch,
+            spanBegin, spanEnd, entry, fixedPointEntry, footprints, entryStep );
+          }
+        }
+
+      unsigned long begin = spanBegin;
+      unsigned long end = spanEnd;
+      if( numberOfNeighbors == 0 )
+        {
+        begin = end = 0;
+        }
+      scratch.Counters.InSectorPixels += end - begin;
+      scratch.Counters.OutOfSectorPixels += length - ( end - begin );
+      scratch.Counters.InputBytesRead += ( end - begin ) * numberOfNeighbors * m_NeighborhoodBytes;
+      if( outputStep == 1 )
+        {
+        std::fill( outputLine, outputLine + begin, m_DefaultPixelValue );
+        std::fill( outputLine + end, outputLine + length, m_DefaultPixelValue );
+        }
+      else
+        {
+        for( unsigned long i = 0; i < begin; i++ )
+          {
+          outputLine[i * outputStep] = m_DefaultPixelValue;
+          }
+        for( unsigned long i = end; i < length; i++ )
+          {
+          outputLine[i * outputStep] = m_DefaultPixelValue;
+          }
+        }
+
+      if( end > begin )
+        {
+        this->InterpolateSpanWithMode( input, neighborOffsets, neighborWeights, numberOfNeighbors,
+          entry, fixedPointEntry, footprints, entryStep, outputLine + begin * outputStep, outputStep, end - begin );
+        }
+
+      for( unsigned long i = 0; i < lineLength; i++ )
+        {
+        progress.CompletedPixel();
+        }
+      }
+    }
 }
 
 } // namespace itk
@@ -12,7 +12,11 @@ void RegisterTests()
   REGISTER_TEST( itkCartesianToRThetaTransformTest );
 }
 
+#include <algorithm>
+#include <clocale>
+#include <cstring>
 #include <iostream>
+#include <locale>
 #include <sstream>
 using namespace std;
 
@@ -24,7 +28,28 @@ using namespace std;
 #include "itkMetaDataObject.h"
 #include "itkResampleImageFilter.h"
 
+#include "itkCartesianToRThetaFunctor.h"
+#include "itkCartesianToRThetaPhiTransform.h"
 #include "itkCartesianToRThetaTransform.h"
+#include "itkRThetaPhiToCartesianTransform.h"
+#include "itkRThetaScanGeometry.h"
+#include "itkRThetaToCartesianTransform.h"
+
+// Numbers with a decimal comma, as in many locales.
+class CommaNumpunct : public std::numpunct< char >
+{
+protected:
+  virtual char do_decimal_point() const
+    {
+    return ',';
+    }
+};
+
+// A packed array of doubles, as held by a "ThetaBinary" entry.
+static std::string PackReals( const double * values, unsigned int count )
+{
+  return std::string( reinterpret_cast< const char * >( values ), count * sizeof( double ) );
+}
 
 int itkCartesianToRThetaTransformTest( int argc, char* argv[] )
 {
@@ -102,6 +127,358 @@ int itkCartesianToRThetaTransformTest( int argc, char* argv[] )
       }
     scanConvert->SetThetaArray( thetaArray );
 
+    // The scan geometry reads the same values from the dictionary.
+    typedef itk::RThetaScanGeometry< double, Dimension > GeometryType;
+    double geometryRmin;
+    ArrayType geometryThetaArray;
+    if( !GeometryType::ReadReal( dict, "Radius", geometryRmin ) || geometryRmin != rMin ||
+        !GeometryType::ReadRealArray( dict, "Theta", geometryThetaArray ) ||
+        geometryThetaArray.Size() != alines )
+      {
+      cerr << "The scan geometry did not read the Radius or the Theta array." << std::endl;
+      return EXIT_FAILURE;
+      }
+    for( unsigned int i = 0; i < alines; i++ )
+      {
+      if( geometryThetaArray[i] != thetaArray[i] )
+        {
+        cerr << "The scan geometry read Theta " << i << " as " << geometryThetaArray[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // Strings are converted like a stream in the classic locale, whatever
+    // the global locales, including values with 16 or 17 significant
+    // digits, signs, exponents, and a leading decimal point.
+    const std::locale previousLocale = std::locale::global( std::locale( std::locale::classic(), new CommaNumpunct ) );
+    const std::string previousNumericLocale = setlocale( LC_NUMERIC, NULL );
+    if( setlocale( LC_NUMERIC, "de_DE.UTF-8" ) == NULL )
+      {
+      setlocale( LC_NUMERIC, "fr_FR.UTF-8" );
+      }
+    const char * reals[] = { "0.9007199254740993", "9007199254740993e-22", "0.12345678901234567",
+      "12345678901234567", "1.2345678901234567e-5", "+.5", ".0625", "-3.25E+2", "+7e22",
+      "0.1000000000000000055511151231257827", "  1e-300" };
+    const unsigned int numberOfReals = sizeof( reals ) / sizeof( reals[0] );
+    double expectedReals[numberOfReals];
+    std::string realsString;
+    for( unsigned int i = 0; i < numberOfReals; i++ )
+      {
+      istringstream expectedStream( reals[i] );
+      expectedStream.imbue( std::locale::classic() );
+      expectedStream >> expectedReals[i];
+      itk::MetaDataDictionary realDict;
+      itk::EncapsulateMetaData< std::string >( realDict, "RadiusString", std::string( reals[i] ) );
+      double value = 0.0;
+      if( !GeometryType::ReadReal( realDict, "Radius", value ) || value != expectedReals[i] )
+        {
+        cerr << "RadiusString '" << reals[i] << "' was read as " << value << std::endl;
+        return EXIT_FAILURE;
+        }
+      realsString += std::string( reals[i] ) + " ";
+      }
+    itk::MetaDataDictionary stringDict;
+    itk::EncapsulateMetaData< std::string >( stringDict, "ThetaString", realsString );
+    ArrayType stringValues;
+    GeometryType::ReadRealArray( stringDict, "Theta", stringValues );
+    std::locale::global( previousLocale );
+    setlocale( LC_NUMERIC, previousNumericLocale.c_str() );
+    if( stringValues.Size() != numberOfReals ||
+        std::memcmp( stringValues.data_block(), expectedReals, sizeof( expectedReals ) ) != 0 )
+      {
+      cerr << "The ThetaString values were not read exactly." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // "ThetaBinary" is copied as is, and must hold whole doubles.
+    itk::MetaDataDictionary binaryDict;
+    itk::EncapsulateMetaData< std::string >( binaryDict, "ThetaBinary",
+      PackReals( thetaArray.data_block(), alines ) );
+    ArrayType binaryValues;
+    if( !GeometryType::ReadRealArray( binaryDict, "Theta", binaryValues ) || binaryValues != thetaArray )
+      {
+      cerr << "The ThetaBinary values were not read exactly." << std::endl;
+      return EXIT_FAILURE;
+      }
+    itk::MetaDataDictionary truncatedDict;
+    itk::EncapsulateMetaData< std::string >( truncatedDict, "ThetaBinary",
+      PackReals( thetaArray.data_block(), alines ).substr( 3 ) );
+    bool truncatedThrew = false;
+    try
+      {
+      GeometryType::ReadRealArray( truncatedDict, "Theta", binaryValues );
+      }
+    catch( itk::ExceptionObject & )
+      {
+      truncatedThrew = true;
+      }
+    if( !truncatedThrew )
+      {
+      cerr << "A ThetaBinary entry of partial doubles was accepted." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // "Theta" takes precedence over "ThetaBinary", which takes precedence
+    // over "ThetaString".
+    const double arrayTheta[2] = { 0.1, 0.2 };
+    const double binaryTheta[3] = { 0.3, 0.4, 0.5 };
+    ArrayType precedenceArray( 2 );
+    precedenceArray[0] = arrayTheta[0];
+    precedenceArray[1] = arrayTheta[1];
+    itk::MetaDataDictionary precedenceDict;
+    itk::EncapsulateMetaData< std::string >( precedenceDict, "ThetaString", std::string( "0.6 0.7 0.8 0.9 " ) );
+    ArrayType precedenceValues;
+    GeometryType::ReadRealArray( precedenceDict, "Theta", precedenceValues );
+    if( precedenceValues.Size() != 4 || precedenceValues[0] != 0.6 )
+      {
+      cerr << "ThetaString was not read on its own." << std::endl;
+      return EXIT_FAILURE;
+      }
+    itk::EncapsulateMetaData< std::string >( precedenceDict, "ThetaBinary", PackReals( binaryTheta, 3 ) );
+    GeometryType::ReadRealArray( precedenceDict, "Theta", precedenceValues );
+    if( precedenceValues.Size() != 3 || precedenceValues[0] != binaryTheta[0] )
+      {
+      cerr << "ThetaBinary did not take precedence over ThetaString." << std::endl;
+      return EXIT_FAILURE;
+      }
+    itk::EncapsulateMetaData< ArrayType >( precedenceDict, "Theta", precedenceArray );
+    GeometryType::ReadRealArray( precedenceDict, "Theta", precedenceValues );
+    if( precedenceValues.Size() != 2 || precedenceValues[0] != arrayTheta[0] )
+      {
+      cerr << "Theta did not take precedence over ThetaBinary." << std::endl;
+      return EXIT_FAILURE;
+      }
+
+    // A full cache removes the geometry that was used least recently.
+    const unsigned long maximumCacheSize = GeometryType::GetMaximumCacheSize();
+    GeometryType::ClearCache();
+    GeometryType::SetMaximumCacheSize( 2 );
+    const GeometryType::SizeType inputSize = reader->GetOutput()->GetLargestPossibleRegion().GetSize();
+    GeometryType::SpacingType inputSpacings[3];
+    for( unsigned int i = 0; i < 3; i++ )
+      {
+      inputSpacings[i] = reader->GetOutput()->GetSpacing();
+      inputSpacings[i][0] *= i + 1;
+      }
+    // Geometries 0 and 1 are created, 0 is used again, and 2 evicts 1.
+    const unsigned int lookups[6] = { 0, 1, 0, 2, 0, 1 };
+    const bool expectedCreated[6] = { true, true, false, true, false, true };
+    for( unsigned int i = 0; i < 6; i++ )
+      {
+      bool created = false;
+      GeometryType::GetGeometry( dict, inputSpacings[lookups[i]], inputSize, 0, 1, 0.0, &created );
+      if( created != expectedCreated[i] )
+        {
+        cerr << "Lookup " << i << " of the geometry cache " << ( created ? "missed." : "hit." ) << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    GeometryType::SetMaximumCacheSize( maximumCacheSize );
+
+    // Moving one line by half a step breaks uniformity.
+    if( alines > 2 )
+      {
+      const bool isUniform = scanConvert->GetThetaArrayIsUniform();
+      ArrayType perturbedThetaArray( thetaArray );
+      perturbedThetaArray[alines / 2] += 0.5 * ( thetaArray[1] - thetaArray[0] );
+      scanConvert->SetThetaArray( perturbedThetaArray );
+      if( scanConvert->GetThetaArrayIsUniform() )
+        {
+        cerr << "A non-uniform Theta array was reported as uniform." << std::endl;
+        return EXIT_FAILURE;
+        }
+      // The moved line's angle must still map to its own line.
+      const double movedTheta = perturbedThetaArray[alines / 2];
+      ScanConvertType::InputPointType movedPoint;
+      movedPoint.Fill( 0.0 );
+      movedPoint[RDirection] = Rmax * vcl_cos( movedTheta );
+      movedPoint[ThetaDirection] = Rmax * vcl_sin( movedTheta );
+      const double movedIndex = scanConvert->TransformPoint( movedPoint )[ThetaDirection] / spacing[ThetaDirection];
+      if( vcl_abs( movedIndex - alines / 2 ) > 1.0e-3 )
+        {
+        cerr << "A non-uniform Theta array was not inverted: " << movedIndex << std::endl;
+        return EXIT_FAILURE;
+        }
+      // An array that is not monotonic is mapped linearly by both the
+      // transform and its inverse.
+      ArrayType swappedThetaArray( thetaArray );
+      std::swap( swappedThetaArray[alines / 2], swappedThetaArray[alines / 2 + 1] );
+      scanConvert->SetThetaArray( swappedThetaArray );
+      const double swappedTheta = thetaArray[alines / 2] + 0.25 * ( thetaArray[1] - thetaArray[0] );
+      ScanConvertType::InputPointType swappedPoint;
+      swappedPoint.Fill( 0.0 );
+      swappedPoint[RDirection] = Rmax * vcl_cos( swappedTheta );
+      swappedPoint[ThetaDirection] = Rmax * vcl_sin( swappedTheta );
+      const ScanConvertType::InputPointType swappedBack =
+        scanConvert->GetInverseTransform()->TransformPoint( scanConvert->TransformPoint( swappedPoint ) );
+      if( scanConvert->GetUseThetaIndexTable() || ( swappedBack - swappedPoint ).GetNorm() > 1.0e-3 * Rmax )
+        {
+        cerr << "The inverse of a non-monotonic Theta array's transform moved " << swappedPoint
+          << " to " << swappedBack << std::endl;
+        return EXIT_FAILURE;
+        }
+      scanConvert->SetThetaArray( thetaArray );
+      if( scanConvert->GetThetaArrayIsUniform() != isUniform )
+        {
+        cerr << "ThetaArrayIsUniform was not updated." << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // The vectorized batch transform must agree with TransformPoint() to
+    // within the requested fraction of a line.
+    const double thetaTolerance = 0.01;
+    scanConvert->SetThetaTolerance( thetaTolerance );
+    const unsigned int scanlineLength = 101;
+    ScanConvertType::InputPointType scanline[scanlineLength];
+    ScanConvertType::OutputPointType transformedScanline[scanlineLength];
+    for( unsigned int i = 0; i < scanlineLength; i++ )
+      {
+      scanline[i][RDirection] = Rmax * i / ( scanlineLength - 1 );
+      scanline[i][ThetaDirection] = scanConvert->GetRmaxsinThetamin() * ( 1.0 - 2.0 * i / ( scanlineLength - 1 ) );
+      scanline[i][2] = 0.0;
+      }
+    scanConvert->TransformPoints( scanline, transformedScanline, scanlineLength );
+    for( unsigned int i = 1; i < scanlineLength; i++ )
+      {
+      const ScanConvertType::OutputPointType exact = scanConvert->TransformPoint( scanline[i] );
+      if( vcl_abs( exact[ThetaDirection] - transformedScanline[i][ThetaDirection] ) >
+          thetaTolerance * spacing[ThetaDirection] )
+        {
+        cerr << "TransformPoints() differs from TransformPoint() at " << scanline[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+    scanConvert->SetThetaTolerance( 0.0 );
+
+    // The inlined functor must reproduce TransformPoint().
+    itk::Functor::CartesianToRTheta< float, Dimension, RDirection, ThetaDirection > cartesianToRTheta;
+    cartesianToRTheta.SetTransform( scanConvert );
+    for( unsigned int i = 1; i < scanlineLength; i++ )
+      {
+      const ScanConvertType::OutputPointType exact = scanConvert->TransformPoint( scanline[i] );
+      const ScanConvertType::OutputPointType inlined = cartesianToRTheta( scanline[i] );
+      if( exact != inlined )
+        {
+        cerr << "The CartesianToRTheta functor differs from TransformPoint() at " << scanline[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // The analytic Jacobian must match central differences, and a vector
+    // transformed to (R, Theta) and back must be unchanged.
+    typedef itk::RThetaToCartesianTransform< float, Dimension > InverseScanConvertType;
+    InverseScanConvertType::Pointer inverseScanConvert =
+      dynamic_cast< InverseScanConvertType * >( scanConvert->GetInverseTransform().GetPointer() );
+    for( unsigned int i = 1; i < scanlineLength; i += 10 )
+      {
+      ScanConvertType::SpatialJacobianType jacobian;
+      scanConvert->ComputeJacobianWithRespectToPosition( scanline[i], jacobian );
+      const double step = spacing[RDirection];
+      for( unsigned int j = 0; j < 2; j++ )
+        {
+        ScanConvertType::InputPointType forward = scanline[i];
+        ScanConvertType::InputPointType backward = scanline[i];
+        forward[j] += step;
+        backward[j] -= step;
+        const ScanConvertType::OutputPointType a = scanConvert->TransformPoint( forward );
+        const ScanConvertType::OutputPointType b = scanConvert->TransformPoint( backward );
+        for( unsigned int k = 0; k < 2; k++ )
+          {
+          const double difference = ( a[k] - b[k] ) / ( 2.0 * step );
+          if( vcl_abs( difference - jacobian[k][j] ) > 1.0e-2 * vcl_abs( difference ) + 1.0e-3 )
+            {
+            cerr << "The Jacobian differs from finite differences at " << scanline[i] << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        }
+
+      ScanConvertType::InputVectorType displacement;
+      displacement[RDirection] = 0.5 * spacing[RDirection];
+      displacement[ThetaDirection] = -0.25 * spacing[RDirection];
+      displacement[2] = 0.0;
+      const ScanConvertType::OutputVectorType rThetaDisplacement =
+        scanConvert->TransformVector( displacement, scanline[i] );
+      const InverseScanConvertType::OutputVectorType cartesianDisplacement =
+        inverseScanConvert->TransformVector( rThetaDisplacement, scanConvert->TransformPoint( scanline[i] ) );
+      if( ( cartesianDisplacement - displacement ).GetNorm() > 1.0e-3 * displacement.GetNorm() )
+        {
+        cerr << "A vector did not survive the transform and its inverse at " << scanline[i] << std::endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    // Sweep the frames in phi about an axis behind the array.  The frame
+    // at phi = 0 is the (R, Theta) transform, and every point must survive
+    // the transform and its inverse.
+    typedef itk::CartesianToRThetaPhiTransform< double, Dimension > PhiScanConvertType;
+    typedef itk::RThetaPhiToCartesianTransform< double, Dimension > InversePhiScanConvertType;
+    PhiScanConvertType::Pointer phiScanConvert = PhiScanConvertType::New();
+    const double phiRadius = 0.5 * Rmax;
+    const unsigned int frames = 9;
+    ArrayType phiArray( frames );
+    for( unsigned int i = 0; i < frames; i++ )
+      {
+      phiArray[i] = 0.05 * ( static_cast< double >( i ) - 4.0 );
+      }
+    phiScanConvert->SetRmin( rMin );
+    phiScanConvert->SetRmax( Rmax );
+    phiScanConvert->SetPhiRadius( phiRadius );
+    phiScanConvert->SetSpacingTheta( spacing[ThetaDirection] );
+    phiScanConvert->SetThetaArray( thetaArray );
+    phiScanConvert->SetSpacingPhi( spacing[2] );
+    phiScanConvert->SetPhiArray( phiArray );
+    InversePhiScanConvertType::Pointer inversePhiScanConvert =
+      dynamic_cast< InversePhiScanConvertType * >( phiScanConvert->GetInverseTransform().GetPointer() );
+    for( unsigned int i = 1; i < scanlineLength; i += 10 )
+      {
+      PhiScanConvertType::InputPointType point;
+      point[RDirection] = scanline[i][RDirection];
+      point[ThetaDirection] = scanline[i][ThetaDirection];
+      point[2] = 0.0;
+      const PhiScanConvertType::OutputPointType inFrame = phiScanConvert->TransformPoint( point );
+      const ScanConvertType::OutputPointType expected = scanConvert->TransformPoint( scanline[i] );
+      if( vcl_abs( inFrame[RDirection] - expected[RDirection] ) > 1.0e-3 * spacing[RDirection] ||
+          vcl_abs( inFrame[ThetaDirection] - expected[ThetaDirection] ) > 1.0e-3 * spacing[ThetaDirection] ||
+          vcl_abs( inFrame[2] - 4.0 * spacing[2] ) > 1.0e-6 * spacing[2] )
+        {
+        cerr << "The phi = 0 frame differs from the (R, Theta) transform at " << point << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      point[2] = 0.3 * phiRadius * ( static_cast< double >( i ) / scanlineLength - 0.5 );
+      const PhiScanConvertType::OutputPointType rThetaPhi = phiScanConvert->TransformPoint( point );
+      const InversePhiScanConvertType::OutputPointType back = inversePhiScanConvert->TransformPoint( rThetaPhi );
+      if( ( back - point ).GetNorm() > 1.0e-9 * Rmax )
+        {
+        cerr << "A point did not survive the phi transform and its inverse at " << point << std::endl;
+        return EXIT_FAILURE;
+        }
+
+      PhiScanConvertType::SpatialJacobianType jacobian;
+      phiScanConvert->ComputeJacobianWithRespectToPosition( point, jacobian );
+      const double step = 1.0e-3 * spacing[RDirection];
+      for( unsigned int j = 0; j < Dimension; j++ )
+        {
+        PhiScanConvertType::InputPointType forward = point;
+        PhiScanConvertType::InputPointType backward = point;
+        forward[j] += step;
+        backward[j] -= step;
+        const PhiScanConvertType::OutputPointType a = phiScanConvert->TransformPoint( forward );
+        const PhiScanConvertType::OutputPointType b = phiScanConvert->TransformPoint( backward );
+        for( unsigned int k = 0; k < Dimension; k++ )
+          {
+          const double difference = ( a[k] - b[k] ) / ( 2.0 * step );
+          if( vcl_abs( difference - jacobian[k][j] ) > 1.0e-4 * vcl_abs( difference ) + 1.0e-6 )
+            {
+            cerr << "The phi Jacobian differs from finite differences at " << point << std::endl;
+            return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+
     resample->SetTransform( scanConvert );
     resample->SetDefaultPixelValue( 0 );
 
@@ -12,15 +12,187 @@ void RegisterTests()
   REGISTER_TEST( itkResampleRThetaToCartesianImageFilterTest );
 }
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <sstream>
 using namespace std;
 
+#include "itkCommand.h"
 #include "itkImage.h"
 #include "itkImageFileReader.h"
 #include "itkImageFileWriter.h"
+#include "itkLinearInterpolateImageFunction.h"
+#include "itkMetaDataObject.h"
+#include "itkSimpleFastMutexLock.h"
+#include <itksys/SystemTools.hxx>
 
+#include "itkResampleCartesianToRThetaImageFilter.h"
+#include "itkResampleRThetaPhiToCartesianImageFilter.h"
 #include "itkResampleRThetaToCartesianImageFilter.h"
+#include "itkRThetaImportImageFilter.h"
+#include "itkRThetaToCartesianLiveConverter.h"
+
+// Evaluate the Catmull-Rom (cubic) or the normalized Lanczos-3 kernel of
+// ResampleRThetaToCartesianImageFilter directly at a continuous (R, Theta)
+// index of the given slice, clamped to the buffer like the filter's, and
+// replicating the border samples.  range is set to
+// the spread of the samples under the kernel.
+template< class TImage >
+static double EvaluateKernelAtIndex( const TImage * image, bool cubic,
+  double r, double theta, long slice, double & range )
+{
+  const int taps = cubic ? 4 : 6;
+  const typename TImage::RegionType & region = image->GetBufferedRegion();
+  const long sizes[2] = { region.GetSize()[0], region.GetSize()[1] };
+  const double coordinates[2] = {
+    vnl_math_max( 0.0, vnl_math_min( r, sizes[0] - 1.0 ) ),
+    vnl_math_max( 0.0, vnl_math_min( theta, sizes[1] - 1.0 ) ) };
+  long bases[2];
+  double weights[2][6];
+  for( unsigned int d = 0; d < 2; d++ )
+    {
+    bases[d] = vnl_math_min( static_cast< long >( vcl_floor( coordinates[d] ) ), sizes[d] - 2 );
+    double sum = 0.0;
+    for( int k = 0; k < taps; k++ )
+      {
+      const double x = vcl_abs( 1 - taps / 2 + k - ( coordinates[d] - bases[d] ) );
+      double w = 0.0;
+      if( cubic )
+        {
+        w = x < 1.0 ? ( 1.5 * x - 2.5 ) * x * x + 1.0 :
+          ( x < 2.0 ? ( ( -0.5 * x + 2.5 ) * x - 4.0 ) * x + 2.0 : 0.0 );
+        }
+      else
+        {
+        w = x < 1e-12 ? 1.0 : ( x < 3.0 ? 3.0 * vcl_sin( vnl_math::pi * x ) *
+          vcl_sin( vnl_math::pi * x / 3.0 ) / ( vnl_math::pi * vnl_math::pi * x * x ) : 0.0 );
+        }
+      weights[d][k] = w;
+      sum += w;
+      }
+    for( int k = 0; k < taps; k++ )
+      {
+      weights[d][k] /= sum;
+      }
+    }
+  typename TImage::IndexType index = region.GetIndex();
+  index[2] += slice;
+  double value = 0.0;
+  double minimum = image->GetPixel( index );
+  double maximum = minimum;
+  for( int j = 0; j < taps; j++ )
+    {
+    for( int k = 0; k < taps; k++ )
+      {
+      index[0] = region.GetIndex()[0] + vnl_math_max( 0L, vnl_math_min( bases[0] + 1 - taps / 2 + k, sizes[0] - 1 ) );
+      index[1] = region.GetIndex()[1] + vnl_math_max( 0L, vnl_math_min( bases[1] + 1 - taps / 2 + j, sizes[1] - 1 ) );
+      const double sample = image->GetPixel( index );
+      value += weights[0][k] * weights[1][j] * sample;
+      minimum = vnl_math_min( minimum, sample );
+      maximum = vnl_math_max( maximum, sample );
+      }
+    }
+  range = maximum - minimum;
+  return value;
+}
+
+/** The average of an (R, Theta) slice of image over a box of footprints[0] by
+ * footprints[1] samples centered at (r, theta), with every sample constant
+ * over its cell and the box cropped to the buffer, as
+ * ResampleRThetaToCartesianImageFilter::AntiAliasedInterpolation computes
+ * it. */
+template< class TImage >
+static double EvaluateBoxAtIndex( const TImage * image, const double footprints[2],
+  double r, double theta, long slice )
+{
+  const typename TImage::RegionType & region = image->GetBufferedRegion();
+  const long sizes[2] = { region.GetSize()[0], region.GetSize()[1] };
+  const double coordinates[2] = {
+    vnl_math_max( 0.0, vnl_math_min( r, sizes[0] - 1.0 ) ),
+    vnl_math_max( 0.0, vnl_math_min( theta, sizes[1] - 1.0 ) ) };
+  double lower[2];
+  double upper[2];
+  for( unsigned int d = 0; d < 2; d++ )
+    {
+    lower[d] = vnl_math_max( coordinates[d] - 0.5 * footprints[d], -0.5 );
+    upper[d] = vnl_math_min( coordinates[d] + 0.5 * footprints[d], sizes[d] - 0.5 );
+    }
+  typename TImage::IndexType index = region.GetIndex();
+  index[2] += slice;
+  double value = 0.0;
+  for( long j = static_cast< long >( lower[1] + 0.5 ); j <= static_cast< long >( upper[1] + 0.5 ) && j < sizes[1]; j++ )
+    {
+    const double thetaOverlap = vnl_math_min( upper[1], j + 0.5 ) - vnl_math_max( lower[1], j - 0.5 );
+    if( thetaOverlap <= 0.0 )
+      {
+      continue;
+      }
+    for( long k = static_cast< long >( lower[0] + 0.5 ); k <= static_cast< long >( upper[0] + 0.5 ) && k < sizes[0]; k++ )
+      {
+      const double rOverlap = vnl_math_min( upper[0], k + 0.5 ) - vnl_math_max( lower[0], k - 0.5 );
+      if( rOverlap <= 0.0 )
+        {
+        continue;
+        }
+      index[0] = region.GetIndex()[0] + k;
+      index[1] = region.GetIndex()[1] + j;
+      value += rOverlap * thetaOverlap * image->GetPixel( index );
+      }
+    }
+  return value / ( ( upper[0] - lower[0] ) * ( upper[1] - lower[1] ) );
+}
+
+// Exposes the header of the files of RThetaToCartesianLookupTable::WriteFile().
+template< class TLookupTable >
+class LookupTableFileAccess: public TLookupTable
+{
+public:
+  typedef typename TLookupTable::FileHeaderType FileHeaderType;
+};
+
+// Records the frames that a live converter hands to its FrameCallback.  The
+// first call sleeps for FirstDelay milliseconds, so that the frames pushed
+// meanwhile wait.
+template< class TPixel >
+struct LiveFrameRecord
+{
+  itk::SimpleFastMutexLock Lock;
+  unsigned long            NumberOfFrames;
+  unsigned long            LastFrameNumber;
+  bool                     Mismatch;
+  const TPixel *           Expected;
+  unsigned long            NumberOfPixels;
+  unsigned int             FirstDelay;
+};
+
+template< class TFrame, class TPixel >
+static void RecordLiveFrame( const TFrame & frame, void * clientData )
+{
+  LiveFrameRecord< TPixel > * record = static_cast< LiveFrameRecord< TPixel > * >( clientData );
+  record->Lock.Lock();
+  const bool first = ( record->NumberOfFrames++ == 0 );
+  record->LastFrameNumber = frame.FrameNumber;
+  record->Mismatch = record->Mismatch || !std::equal( frame.Image->GetBufferPointer(),
+    frame.Image->GetBufferPointer() + record->NumberOfPixels, record->Expected );
+  record->Lock.Unlock();
+  if( first )
+    {
+    itksys::SystemTools::Delay( record->FirstDelay );
+    }
+}
+
+// Counts the events that it observes.
+class EventCounter
+{
+public:
+  EventCounter(): m_NumberOfEvents( 0 ) {}
+  void Count()
+    {
+    m_NumberOfEvents++;
+    }
+  unsigned long m_NumberOfEvents;
+};
 
 int itkResampleRThetaToCartesianImageFilterTest( int argc, char* argv[] )
 {
@@ -33,6 +205,17 @@ int itkResampleRThetaToCartesianImageFilterTest( int argc, char* argv[] )
   typedef itk::ImageFileReader< InputImageType > ReaderType;
   typedef itk::ResampleRThetaToCartesianImageFilter< InputImageType, OutputImageType, float > ResampleType;
   typedef itk::ImageFileWriter< OutputImageType > WriterType;
+  typedef LookupTableFileAccess< ResampleType::LookupTableType >::FileHeaderType LookupTableFileHeaderType;
+
+  // The arguments are the input, the output, the mode, and the mode's
+  // argument, after the test driver's --compare and its two images when
+  // the output is compared with the baseline.
+  const int first = ( argc > 1 && std::string( argv[1] ) == "--compare" ) ? 4 : 1;
+  const std::string mode = argc > first + 2 ? argv[first + 2] : "";
+
+  // Directory of the lookup tables saved by the PersistentLookupTable test,
+  // emptied before and after it.
+  std::string lookupTableDirectory;
 
   try
     {
@@ -42,16 +225,1179 @@ int itkResampleRThetaToCartesianImageFilterTest( int argc, char* argv[] )
 
     resample->SetInput( reader->GetOutput() );
 
-    reader->SetFileName( argv[4] );
-    writer->SetFileName( argv[5] );
+    reader->SetFileName( argv[first] );
+    writer->SetFileName( argv[first + 1] );
 
     reader->UpdateOutputInformation();
 
     resample->SetDefaultPixelValue( 0 );
 
+    if( mode == "UseLookupTable" )
+      {
+      resample->UseLookupTableOn();
+      }
+
+    if( mode == "LiveConverter" )
+      {
+      typedef itk::RThetaToCartesianLiveConverter< InputImageType, OutputImageType, float > LiveConverterType;
+      LiveConverterType::Pointer live = LiveConverterType::New();
+      live->SetDefaultPixelValue( 0 );
+
+      reader->Update();
+      live->Start( reader->GetOutput() );
+      const unsigned int numberOfFrames = 3;
+      for( unsigned int i = 0; i < numberOfFrames; i++ )
+        {
+        if( !live->PushFrame( reader->GetOutput()->GetBufferPointer() ) )
+          {
+          cerr << "The live converter rejected frame " << i << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      LiveConverterType::FrameType frame;
+      for( unsigned int i = 0; i < numberOfFrames; i++ )
+        {
+        if( !live->WaitFrame( frame ) || frame.FrameNumber != i )
+          {
+          cerr << "The live converter did not deliver frame " << i << endl;
+          return EXIT_FAILURE;
+          }
+        if( i + 1 < numberOfFrames )
+          {
+          live->ReleaseFrame( frame );
+          }
+        }
+      cout << "Mean live latency: " << live->GetMeanLatency() << " s" << endl;
+
+      // The frame's image belongs to the converter, so the last frame is
+      // copied out before it is released and written.
+      const unsigned long numberOfPixels = frame.Image->GetBufferedRegion().GetNumberOfPixels();
+      OutputImageType::Pointer lastFrame = OutputImageType::New();
+      lastFrame->CopyInformation( frame.Image );
+      lastFrame->SetRegions( frame.Image->GetBufferedRegion() );
+      lastFrame->Allocate();
+      std::copy( frame.Image->GetBufferPointer(), frame.Image->GetBufferPointer() + numberOfPixels,
+        lastFrame->GetBufferPointer() );
+      live->ReleaseFrame( frame );
+      live->Stop();
+
+      const InputImageType * volume = reader->GetOutput();
+      ResampleType::Pointer converted = ResampleType::New();
+      converted->SetInput( volume );
+      converted->SetDefaultPixelValue( 0 );
+      converted->UseLookupTableOn();
+      converted->Update();
+      const OutputPixelType * expected = converted->GetOutput()->GetBufferPointer();
+      if( !std::equal( lastFrame->GetBufferPointer(), lastFrame->GetBufferPointer() + numberOfPixels, expected ) )
+        {
+        cerr << "The live frame differs from the filter's output." << endl;
+        return EXIT_FAILURE;
+        }
+
+      // With two slots and no frame popped, pushing drops the stalest
+      // frames, but never the newest one.
+      LiveConverterType::Pointer ring = LiveConverterType::New();
+      ring->SetDefaultPixelValue( 0 );
+      ring->SetNumberOfWorkers( 1 );
+      ring->SetNumberOfSlots( 2 );
+      ring->Start( volume );
+      const unsigned int numberOfRingFrames = 6;
+      for( unsigned int i = 0; i < numberOfRingFrames; i++ )
+        {
+        if( !ring->PushFrame( volume->GetBufferPointer() ) )
+          {
+          cerr << "The full ring rejected frame " << i << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      unsigned long delivered = 0;
+      unsigned long lastFrameNumber = 0;
+      do
+        {
+        if( !ring->WaitFrame( frame ) ||
+            ( delivered > 0 && frame.FrameNumber <= lastFrameNumber ) ||
+            !std::equal( frame.Image->GetBufferPointer(), frame.Image->GetBufferPointer() + numberOfPixels, expected ) )
+          {
+          cerr << "The full ring delivered a wrong frame after " << delivered << " frames." << endl;
+          return EXIT_FAILURE;
+          }
+        lastFrameNumber = frame.FrameNumber;
+        delivered++;
+        ring->ReleaseFrame( frame );
+        }
+      while( frame.FrameNumber + 1 < numberOfRingFrames );
+      if( delivered > 2 || delivered + ring->GetNumberOfDroppedFrames() != numberOfRingFrames )
+        {
+        cerr << "The full ring delivered " << delivered << " and dropped "
+             << ring->GetNumberOfDroppedFrames() << " of " << numberOfRingFrames << " frames." << endl;
+        return EXIT_FAILURE;
+        }
+      ring->Stop();
+
+      // Frames are handed to the FrameCallback.  The frames pushed while the
+      // first callback sleeps wait longer than MaximumLatency, and are
+      // dropped instead of converted.
+      LiveFrameRecord< OutputPixelType > record;
+      record.NumberOfFrames = 0;
+      record.LastFrameNumber = 0;
+      record.Mismatch = false;
+      record.Expected = expected;
+      record.NumberOfPixels = numberOfPixels;
+      record.FirstDelay = 500;
+      LiveConverterType::Pointer callbackLive = LiveConverterType::New();
+      callbackLive->SetDefaultPixelValue( 0 );
+      callbackLive->SetNumberOfWorkers( 1 );
+      callbackLive->SetMaximumLatency( 0.1 );
+      callbackLive->SetFrameCallback( &RecordLiveFrame< LiveConverterType::FrameType, OutputPixelType >, &record );
+      callbackLive->Start( volume );
+      callbackLive->PushFrame( volume->GetBufferPointer() );
+      bool called = false;
+      for( unsigned int waited = 0; !called && waited < 10000; waited++ )
+        {
+        itksys::SystemTools::Delay( 1 );
+        record.Lock.Lock();
+        called = record.NumberOfFrames > 0;
+        record.Lock.Unlock();
+        }
+      const unsigned int numberOfLateFrames = 3;
+      for( unsigned int i = 0; i < numberOfLateFrames; i++ )
+        {
+        if( !callbackLive->PushFrame( volume->GetBufferPointer() ) )
+          {
+          cerr << "The live converter rejected late frame " << i << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      for( unsigned int waited = 0; waited < 10000 &&
+           callbackLive->GetNumberOfConvertedFrames() + callbackLive->GetNumberOfDroppedFrames() < 1 + numberOfLateFrames;
+           waited++ )
+        {
+        itksys::SystemTools::Delay( 1 );
+        }
+      callbackLive->Stop();
+      if( !called || record.NumberOfFrames != 1 || record.LastFrameNumber != 0 || record.Mismatch ||
+          callbackLive->GetNumberOfConvertedFrames() != 1 ||
+          callbackLive->GetNumberOfDroppedFrames() != numberOfLateFrames )
+        {
+        cerr << "The callback received " << record.NumberOfFrames << " frames, and "
+             << callbackLive->GetNumberOfDroppedFrames() << " late frames were dropped." << endl;
+        return EXIT_FAILURE;
+        }
+
+      // Stop() discards the frames that were not converted, while the
+      // converted ones can still be popped, and Start() starts over.
+      LiveConverterType::Pointer stopped = LiveConverterType::New();
+      stopped->SetDefaultPixelValue( 0 );
+      stopped->SetNumberOfWorkers( 1 );
+      stopped->SetNumberOfSlots( 8 );
+      stopped->Start( volume );
+      for( unsigned int i = 0; i < stopped->GetNumberOfSlots(); i++ )
+        {
+        stopped->PushFrame( volume->GetBufferPointer() );
+        }
+      stopped->Stop();
+      if( stopped->GetRunning() || stopped->PushFrame( volume->GetBufferPointer() ) )
+        {
+        cerr << "The stopped live converter accepted a frame." << endl;
+        return EXIT_FAILURE;
+        }
+      unsigned long popped = 0;
+      while( stopped->PopFrame( frame ) )
+        {
+        if( !std::equal( frame.Image->GetBufferPointer(), frame.Image->GetBufferPointer() + numberOfPixels, expected ) )
+          {
+          cerr << "Frame " << frame.FrameNumber << " popped after Stop() is wrong." << endl;
+          return EXIT_FAILURE;
+          }
+        popped++;
+        stopped->ReleaseFrame( frame );
+        }
+      if( popped != stopped->GetNumberOfConvertedFrames() || stopped->GetNumberOfDroppedFrames() != 0 )
+        {
+        cerr << popped << " frames were popped after Stop(), "
+             << stopped->GetNumberOfConvertedFrames() << " were converted." << endl;
+        return EXIT_FAILURE;
+        }
+      stopped->Start( volume );
+      if( !stopped->PushFrame( volume->GetBufferPointer() ) || !stopped->WaitFrame( frame ) ||
+          frame.FrameNumber != 0 ||
+          !std::equal( frame.Image->GetBufferPointer(), frame.Image->GetBufferPointer() + numberOfPixels, expected ) )
+        {
+        cerr << "The restarted live converter did not convert its first frame." << endl;
+        return EXIT_FAILURE;
+        }
+      stopped->ReleaseFrame( frame );
+      stopped->Stop();
+
+      // Every pushed frame gets its own summed area table, so the
+      // anti-aliased frames match the filter's.
+      LiveConverterType::Pointer antiAliasedLive = LiveConverterType::New();
+      antiAliasedLive->SetDefaultPixelValue( 0 );
+      antiAliasedLive->SetInterpolationMode( ResampleType::AntiAliasedInterpolation );
+      antiAliasedLive->Start( volume );
+      ResampleType::Pointer antiAliased = ResampleType::New();
+      antiAliased->SetInput( volume );
+      antiAliased->SetDefaultPixelValue( 0 );
+      antiAliased->SetInterpolationMode( ResampleType::AntiAliasedInterpolation );
+      antiAliased->UseLookupTableOn();
+      antiAliased->Update();
+      for( unsigned int i = 0; i < numberOfFrames; i++ )
+        {
+        LiveConverterType::FrameType antiAliasedFrame;
+        if( !antiAliasedLive->PushFrame( volume->GetBufferPointer() ) ||
+            !antiAliasedLive->WaitFrame( antiAliasedFrame ) )
+          {
+          cerr << "The anti-aliased live converter did not deliver frame " << i << endl;
+          return EXIT_FAILURE;
+          }
+        const bool matches = std::equal( antiAliasedFrame.Image->GetBufferPointer(),
+          antiAliasedFrame.Image->GetBufferPointer() + numberOfPixels,
+          antiAliased->GetOutput()->GetBufferPointer() );
+        antiAliasedLive->ReleaseFrame( antiAliasedFrame );
+        if( !matches )
+          {
+          cerr << "Anti-aliased live frame " << i << " differs from the filter's output." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      antiAliasedLive->Stop();
+
+      writer->SetInput( lastFrame );
+      writer->Update();
+      return EXIT_SUCCESS;
+      }
+
+    if( mode == "MultipleFrames" )
+      {
+      // The frames of a sequence converted in one update give the pixels of
+      // converting each frame alone, whether the threads divide the frames
+      // between them or split every frame.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+      const unsigned int numberOfFrames = 4;
+      std::vector< InputImageType::Pointer > frames( numberOfFrames );
+      const unsigned long numberOfInputPixels = volume->GetBufferedRegion().GetNumberOfPixels();
+      for( unsigned int frame = 0; frame < numberOfFrames; frame++ )
+        {
+        frames[frame] = InputImageType::New();
+        frames[frame]->CopyInformation( volume );
+        frames[frame]->SetMetaDataDictionary( volume->GetMetaDataDictionary() );
+        frames[frame]->SetRegions( volume->GetBufferedRegion() );
+        frames[frame]->Allocate();
+        for( unsigned long offset = 0; offset < numberOfInputPixels; offset++ )
+          {
+          frames[frame]->GetBufferPointer()[offset] = volume->GetBufferPointer()[offset] / static_cast< InputPixelType >( frame + 1 );
+          }
+        }
+
+      const int threads[2] = { 2, numberOfFrames + 1 };
+      for( unsigned int t = 0; t < 2; t++ )
+        {
+        for( int useLookupTable = 0; useLookupTable < 2; useLookupTable++ )
+          {
+          ResampleType::Pointer sequence = ResampleType::New();
+          sequence->SetNumberOfThreads( threads[t] );
+          sequence->SetUseLookupTable( useLookupTable != 0 );
+          for( unsigned int frame = 0; frame < numberOfFrames; frame++ )
+            {
+            sequence->SetInput( frame, frames[frame] );
+            }
+          sequence->Update();
+          for( unsigned int frame = 0; frame < numberOfFrames; frame++ )
+            {
+            ResampleType::Pointer single = ResampleType::New();
+            single->SetUseLookupTable( useLookupTable != 0 );
+            single->SetInput( frames[frame] );
+            single->Update();
+            const OutputImageType * converted = sequence->GetOutput( frame );
+            const unsigned long numberOfPixels = single->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+            if( converted->GetBufferedRegion() != single->GetOutput()->GetBufferedRegion() ||
+                !std::equal( converted->GetBufferPointer(), converted->GetBufferPointer() + numberOfPixels,
+                  single->GetOutput()->GetBufferPointer() ) )
+              {
+              cerr << "Frame " << frame << " of the sequence converted with " << threads[t]
+                   << " threads and UseLookupTable " << useLookupTable
+                   << " differs from the frame converted alone." << endl;
+              return EXIT_FAILURE;
+              }
+            }
+          }
+        }
+
+      // A frame that buffers other pixels than frame 0 is rejected.
+      InputImageType::RegionType croppedRegion = volume->GetBufferedRegion();
+      InputImageType::SizeType croppedSize = croppedRegion.GetSize();
+      croppedSize[0]--;
+      croppedRegion.SetSize( croppedSize );
+      InputImageType::Pointer cropped = InputImageType::New();
+      cropped->CopyInformation( volume );
+      cropped->SetBufferedRegion( croppedRegion );
+      cropped->Allocate();
+      ResampleType::Pointer mismatched = ResampleType::New();
+      mismatched->SetInput( 0, frames[0] );
+      mismatched->SetInput( 1, cropped );
+      bool caught = false;
+      try
+        {
+        mismatched->Update();
+        }
+      catch( itk::ExceptionObject & error )
+        {
+        caught = std::string( error.GetDescription() ).find( "buffered region" ) != std::string::npos;
+        }
+      if( !caught )
+        {
+        cerr << "A frame with another buffered region was converted." << endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( mode == "TwoDimensional" )
+      {
+      // A single 2D frame is converted to the same pixels as the
+      // corresponding slice of the volume.
+      typedef itk::Image< InputPixelType, 2 >  FrameType;
+      typedef itk::Image< OutputPixelType, 2 > ConvertedFrameType;
+      typedef itk::ResampleRThetaToCartesianImageFilter< FrameType, ConvertedFrameType, float > FrameResampleType;
+
+      reader->Update();
+      resample->Update();
+      const InputImageType * volume = reader->GetOutput();
+      const OutputImageType * convertedVolume = resample->GetOutput();
+
+      const InputImageType::RegionType & volumeRegion = volume->GetBufferedRegion();
+      FrameType::Pointer frame = FrameType::New();
+      FrameType::SizeType frameSize;
+      FrameType::SpacingType frameSpacing;
+      FrameType::PointType frameOrigin;
+      for( unsigned int d = 0; d < 2; d++ )
+        {
+        frameSize[d] = volumeRegion.GetSize()[d];
+        frameSpacing[d] = volume->GetSpacing()[d];
+        frameOrigin[d] = volume->GetOrigin()[d];
+        }
+      frame->SetRegions( frameSize );
+      frame->SetSpacing( frameSpacing );
+      frame->SetOrigin( frameOrigin );
+      frame->SetMetaDataDictionary( volume->GetMetaDataDictionary() );
+      frame->Allocate();
+      const unsigned long slice = volumeRegion.GetSize()[2] / 2;
+      const unsigned long framePixels = frameSize[0] * frameSize[1];
+      std::copy( volume->GetBufferPointer() + slice * framePixels,
+        volume->GetBufferPointer() + ( slice + 1 ) * framePixels,
+        frame->GetBufferPointer() );
+
+      FrameResampleType::Pointer frameResample = FrameResampleType::New();
+      frameResample->SetInput( frame );
+      frameResample->SetDefaultPixelValue( 0 );
+      frameResample->Update();
+      const ConvertedFrameType * convertedFrame = frameResample->GetOutput();
+
+      const ConvertedFrameType::RegionType & frameRegion = convertedFrame->GetBufferedRegion();
+      const OutputImageType::RegionType & volumeOutputRegion = convertedVolume->GetBufferedRegion();
+      OutputImageType::IndexType volumeIndex = volumeOutputRegion.GetIndex();
+      volumeIndex[2] += slice;
+      ConvertedFrameType::IndexType frameIndex;
+      for( unsigned int d = 0; d < 2; d++ )
+        {
+        if( frameRegion.GetSize()[d] != volumeOutputRegion.GetSize()[d] )
+          {
+          cerr << "The converted frame does not have the size of a converted slice." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      unsigned long mismatches = 0;
+      for( unsigned long j = 0; j < frameRegion.GetSize()[1]; j++ )
+        {
+        for( unsigned long i = 0; i < frameRegion.GetSize()[0]; i++ )
+          {
+          frameIndex[0] = frameRegion.GetIndex()[0] + i;
+          frameIndex[1] = frameRegion.GetIndex()[1] + j;
+          volumeIndex[0] = volumeOutputRegion.GetIndex()[0] + i;
+          volumeIndex[1] = volumeOutputRegion.GetIndex()[1] + j;
+          if( convertedFrame->GetPixel( frameIndex ) != convertedVolume->GetPixel( volumeIndex ) )
+            {
+            mismatches++;
+            }
+          }
+        }
+      if( mismatches > 0 )
+        {
+        cerr << mismatches << " pixels of the converted frame differ from the converted slice." << endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( mode == "Phi" )
+      {
+      // Treat the elevation direction as a sweep in phi about an axis behind
+      // the array, and check the single pass conversion against the
+      // transform and a linear interpolator.
+      typedef itk::ResampleRThetaPhiToCartesianImageFilter< InputImageType, OutputImageType, double > PhiResampleType;
+      typedef itk::LinearInterpolateImageFunction< InputImageType, double > InterpolatorType;
+
+      reader->Update();
+      resample->Update();
+      const InputImageType * volume = reader->GetOutput();
+      InputImageType::Pointer sweep = InputImageType::New();
+      sweep->SetRegions( volume->GetBufferedRegion() );
+      sweep->SetSpacing( volume->GetSpacing() );
+      sweep->SetOrigin( volume->GetOrigin() );
+      sweep->SetMetaDataDictionary( volume->GetMetaDataDictionary() );
+      sweep->Allocate();
+      std::copy( volume->GetBufferPointer(),
+        volume->GetBufferPointer() + volume->GetBufferedRegion().GetNumberOfPixels(),
+        sweep->GetBufferPointer() );
+      const unsigned long frames = volume->GetBufferedRegion().GetSize()[2];
+      ostringstream phiString;
+      for( unsigned long i = 0; i < frames; i++ )
+        {
+        phiString << 0.05 * ( i - 0.5 * ( frames - 1.0 ) ) << " ";
+        }
+      itk::EncapsulateMetaData< std::string >( sweep->GetMetaDataDictionary(), "PhiString", phiString.str() );
+      itk::EncapsulateMetaData< double >( sweep->GetMetaDataDictionary(), "PhiRadius",
+        0.25 * volume->GetSpacing()[0] * volume->GetBufferedRegion().GetSize()[0] );
+
+      PhiResampleType::Pointer phiResample = PhiResampleType::New();
+      phiResample->SetInput( sweep );
+      phiResample->SetDefaultPixelValue( -1 );
+      phiResample->SetOutputSpacingPhi( resample->GetOutput()->GetSpacing()[1] );
+      phiResample->Update();
+      const OutputImageType * converted = phiResample->GetOutput();
+
+      InterpolatorType::Pointer interpolator = InterpolatorType::New();
+      interpolator->SetInputImage( sweep );
+      const PhiResampleType::TransformType * transform = phiResample->GetTransform();
+      const double phiRadius = transform->GetPhiRadius();
+      const unsigned long numberOfPixels = converted->GetBufferedRegion().GetNumberOfPixels();
+      unsigned long inside = 0;
+      unsigned long mismatches = 0;
+      for( unsigned long offset = 0; offset < numberOfPixels; offset += 7 )
+        {
+        const OutputImageType::IndexType index = converted->ComputeIndex( offset );
+        PhiResampleType::TransformType::InputPointType point;
+        converted->TransformIndexToPhysicalPoint( index, point );
+        const double distance = vcl_sqrt( ( point[0] + phiRadius ) * ( point[0] + phiRadius ) +
+          point[2] * point[2] ) - phiRadius;
+        InterpolatorType::ContinuousIndexType inputIndex;
+        sweep->TransformPhysicalPointToContinuousIndex( transform->TransformPoint( point ), inputIndex );
+        double expected = -1.0;
+        if( point[0] + phiRadius > 0.0 && distance > 0.0 && interpolator->IsInsideBuffer( inputIndex ) )
+          {
+          expected = interpolator->EvaluateAtContinuousIndex( inputIndex );
+          inside++;
+          }
+        if( vcl_abs( converted->GetBufferPointer()[offset] - expected ) > 1.0 )
+          {
+          mismatches++;
+          }
+        }
+      if( inside == 0 || mismatches > 0 )
+        {
+        cerr << mismatches << " of the phi converted pixels differ from the transform, "
+             << inside << " are inside the volume." << endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( mode == "InterpolationModes" )
+      {
+      // The fixed point bilinear interpolation of the lookup table follows
+      // the floating point one, and the other kernels follow a direct
+      // evaluation at the transformed points.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+
+      ResampleType::Pointer fixedPoint = ResampleType::New();
+      fixedPoint->SetInput( volume );
+      fixedPoint->UseLookupTableOn();
+      fixedPoint->Update();
+      ResampleType::Pointer floatingPoint = ResampleType::New();
+      floatingPoint->SetInput( volume );
+      floatingPoint->UseLookupTableOn();
+      floatingPoint->UseFixedPointInterpolationOff();
+      floatingPoint->Update();
+      const unsigned long numberOfPixels = fixedPoint->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+      unsigned long mismatches = 0;
+      for( unsigned long offset = 0; offset < numberOfPixels; offset++ )
+        {
+        if( vcl_abs( fixedPoint->GetOutput()->GetBufferPointer()[offset] -
+            floatingPoint->GetOutput()->GetBufferPointer()[offset] ) > 2 )
+          {
+          mismatches++;
+          }
+        }
+      if( mismatches > 0 )
+        {
+        cerr << mismatches << " pixels of the fixed point interpolation differ from the floating point one." << endl;
+        return EXIT_FAILURE;
+        }
+
+      typedef itk::LinearInterpolateImageFunction< InputImageType, double > InterpolatorType;
+      InterpolatorType::Pointer interpolator = InterpolatorType::New();
+      interpolator->SetInputImage( volume );
+      const ResampleType::InterpolationModeType modes[3] = {
+        ResampleType::NearestNeighborInterpolation,
+        ResampleType::CubicInterpolation,
+        ResampleType::WindowedSincInterpolation };
+      for( unsigned int m = 0; m < 3; m++ )
+        {
+        ResampleType::Pointer modeResample = ResampleType::New();
+        modeResample->SetInput( volume );
+        modeResample->SetDefaultPixelValue( 0 );
+        modeResample->SetInterpolationMode( modes[m] );
+        modeResample->Update();
+        const OutputImageType * converted = modeResample->GetOutput();
+        const ResampleType::GeometryType::TransformType * transform = modeResample->GetGeometry()->GetTransform();
+        unsigned long inside = 0;
+        mismatches = 0;
+        for( unsigned long offset = 0; offset < numberOfPixels; offset += 7 )
+          {
+          const OutputImageType::IndexType index = converted->ComputeIndex( offset );
+          ResampleType::GeometryType::TransformType::InputPointType point;
+          converted->TransformIndexToPhysicalPoint( index, point );
+          itk::ContinuousIndex< float, Dimension > transformedIndex;
+          volume->TransformPhysicalPointToContinuousIndex( transform->TransformPoint( point ), transformedIndex );
+          InterpolatorType::ContinuousIndexType inputIndex;
+          inputIndex.CastFrom( transformedIndex );
+          if( !interpolator->IsInsideBuffer( inputIndex ) )
+            {
+            continue;
+            }
+          const InputImageType::IndexType & start = volume->GetBufferedRegion().GetIndex();
+          const double r = inputIndex[0] - start[0];
+          const double theta = inputIndex[1] - start[1];
+          const long slice = vnl_math_rnd( inputIndex[2] ) - start[2];
+          double expected;
+          double range = 0.0;
+          if( modes[m] == ResampleType::NearestNeighborInterpolation )
+            {
+            // Skip the ties, where the rounding of the transform decides.
+            if( vcl_abs( r - vcl_floor( r ) - 0.5 ) < 1e-3 || vcl_abs( theta - vcl_floor( theta ) - 0.5 ) < 1e-3 )
+              {
+              continue;
+              }
+            InputImageType::IndexType nearest;
+            nearest[0] = vnl_math_rnd( inputIndex[0] );
+            nearest[1] = vnl_math_rnd( inputIndex[1] );
+            nearest[2] = start[2] + slice;
+            expected = volume->GetPixel( nearest );
+            }
+          else
+            {
+            expected = EvaluateKernelAtIndex( volume, modes[m] == ResampleType::CubicInterpolation, r, theta, slice, range );
+            expected = vnl_math_max( -32768.0, vnl_math_min( 32767.0, expected ) );
+            }
+          inside++;
+          // The kernel phase is quantized to 1 / NumberOfKernelPhases.
+          if( vcl_abs( converted->GetBufferPointer()[offset] - expected ) > 1.5 + 5e-3 * range )
+            {
+            mismatches++;
+            }
+          }
+        if( inside == 0 || mismatches > 0 )
+          {
+          cerr << mismatches << " pixels of interpolation mode " << modes[m]
+               << " differ from the kernel, " << inside << " were checked." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      // Decimated four times in Theta, every output pixel averages the input
+      // over its footprint.
+      ResampleType::Pointer boxResample = ResampleType::New();
+      boxResample->SetInput( volume );
+      boxResample->SetDefaultPixelValue( 0 );
+      boxResample->SetOutputSpacingTheta( 4 * volume->GetSpacing()[0] );
+      boxResample->SetInterpolationMode( ResampleType::AntiAliasedInterpolation );
+      boxResample->Update();
+      const OutputImageType * averaged = boxResample->GetOutput();
+      const ResampleType::GeometryType::TransformType * boxTransform = boxResample->GetGeometry()->GetTransform();
+      const itk::Array< double > & thetas = boxTransform->GetThetaArray();
+      const double thetaStep = ( thetas.max_value() - thetas.min_value() ) / ( thetas.size() - 1 );
+      const OutputImageType::SpacingType & boxSpacing = averaged->GetSpacing();
+      const unsigned long numberOfAveragedPixels = averaged->GetBufferedRegion().GetNumberOfPixels();
+      unsigned long inside = 0;
+      mismatches = 0;
+      for( unsigned long offset = 0; offset < numberOfAveragedPixels; offset += 7 )
+        {
+        const OutputImageType::IndexType index = averaged->ComputeIndex( offset );
+        ResampleType::GeometryType::TransformType::InputPointType point;
+        averaged->TransformIndexToPhysicalPoint( index, point );
+        itk::ContinuousIndex< float, Dimension > transformedIndex;
+        volume->TransformPhysicalPointToContinuousIndex( boxTransform->TransformPoint( point ), transformedIndex );
+        InterpolatorType::ContinuousIndexType inputIndex;
+        inputIndex.CastFrom( transformedIndex );
+        if( !interpolator->IsInsideBuffer( inputIndex ) )
+          {
+          continue;
+          }
+        const double x = vcl_abs( point[0] );
+        const double y = vcl_abs( point[1] );
+        const double radius = vcl_sqrt( x * x + y * y );
+        if( radius <= 0.0 )
+          {
+          continue;
+          }
+        const double footprints[2] = {
+          vnl_math_max( ( x * boxSpacing[0] + y * boxSpacing[1] ) / radius / volume->GetSpacing()[0], 1.0 ),
+          vnl_math_max( ( y * boxSpacing[0] + x * boxSpacing[1] ) / ( radius * radius ) / thetaStep, 1.0 ) };
+        const InputImageType::IndexType & start = volume->GetBufferedRegion().GetIndex();
+        const double expected = EvaluateBoxAtIndex( volume, footprints,
+          inputIndex[0] - start[0], inputIndex[1] - start[1], vnl_math_rnd( inputIndex[2] ) - start[2] );
+        inside++;
+        if( vcl_abs( averaged->GetBufferPointer()[offset] - expected ) > 1.5 )
+          {
+          mismatches++;
+          }
+        }
+      if( inside == 0 || mismatches > 0 )
+        {
+        cerr << mismatches << " anti-aliased pixels differ from the box average, "
+             << inside << " were checked." << endl;
+        return EXIT_FAILURE;
+        }
+      }
+
+    if( mode == "LogCompression" )
+      {
+      // The log compression fused into the conversion gives the pixels of
+      // compressing the input first and converting the compressed image.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+      ResampleType::LogCompressionFunctorType compression;
+      compression.SetDynamicRange( 50.0 );
+      compression.SetReferenceLevel( 2000.0 );
+
+      typedef itk::Image< float, Dimension > CompressedImageType;
+      CompressedImageType::Pointer compressed = CompressedImageType::New();
+      compressed->CopyInformation( volume );
+      compressed->SetRegions( volume->GetBufferedRegion() );
+      compressed->Allocate();
+      compressed->SetMetaDataDictionary( volume->GetMetaDataDictionary() );
+      const unsigned long numberOfInputPixels = volume->GetBufferedRegion().GetNumberOfPixels();
+      for( unsigned long offset = 0; offset < numberOfInputPixels; offset++ )
+        {
+        compressed->GetBufferPointer()[offset] = compression( volume->GetBufferPointer()[offset] );
+        }
+
+      typedef itk::ResampleRThetaToCartesianImageFilter< CompressedImageType, OutputImageType, float > CompressedResampleType;
+      const ResampleType::InterpolationModeType modes[2] = {
+        ResampleType::LinearInterpolation,
+        ResampleType::AntiAliasedInterpolation };
+      for( unsigned int m = 0; m < 2; m++ )
+        {
+        ResampleType::Pointer fused = ResampleType::New();
+        fused->SetInput( volume );
+        fused->UseLookupTableOn();
+        fused->UseLogCompressionOn();
+        fused->SetLogCompressionFunctor( compression );
+        fused->SetInterpolationMode( modes[m] );
+        fused->Update();
+        CompressedResampleType::Pointer separate = CompressedResampleType::New();
+        separate->SetInput( compressed );
+        separate->UseLookupTableOn();
+        separate->SetInterpolationMode( static_cast< CompressedResampleType::InterpolationModeType >( modes[m] ) );
+        separate->Update();
+        const unsigned long numberOfPixels = fused->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+        unsigned long mismatches = 0;
+        for( unsigned long offset = 0; offset < numberOfPixels; offset++ )
+          {
+          if( vcl_abs( fused->GetOutput()->GetBufferPointer()[offset] -
+                       separate->GetOutput()->GetBufferPointer()[offset] ) > 1 )
+            {
+            mismatches++;
+            }
+          }
+        if( mismatches > 0 )
+          {
+          cerr << mismatches << " pixels of the fused log compression differ in interpolation mode "
+               << modes[m] << "." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+
+    if( mode == "Viewport" )
+      {
+      // A viewport on the grid of the whole sector gives the same pixels as
+      // the sector, and panning it reuses the anti-aliasing tables.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+      ResampleType::Pointer sector = ResampleType::New();
+      sector->SetInput( volume );
+      sector->UseLookupTableOn();
+      sector->SetInterpolationMode( ResampleType::AntiAliasedInterpolation );
+      sector->Update();
+      const OutputImageType * sectorImage = sector->GetOutput();
+
+      ResampleType::Pointer viewport = ResampleType::New();
+      viewport->SetInput( volume );
+      viewport->UseLookupTableOn();
+      viewport->SetInterpolationMode( ResampleType::AntiAliasedInterpolation );
+      OutputImageType::SizeType size = sectorImage->GetLargestPossibleRegion().GetSize();
+      size[0] /= 2;
+      size[1] /= 3;
+      viewport->SetViewportSize( size );
+      viewport->SetViewportSpacing( sectorImage->GetSpacing() );
+      for( unsigned int pan = 0; pan < 3; pan++ )
+        {
+        OutputImageType::IndexType start;
+        start.Fill( 0 );
+        start[0] = size[0] / 2;
+        start[1] = pan * size[1];
+        OutputImageType::PointType origin;
+        sectorImage->TransformIndexToPhysicalPoint( start, origin );
+        viewport->SetViewportOrigin( origin );
+        viewport->Update();
+        const OutputImageType * viewportImage = viewport->GetOutput();
+        if( viewportImage->GetLargestPossibleRegion().GetSize() != size )
+          {
+          cerr << "The viewport output has the size " << viewportImage->GetLargestPossibleRegion().GetSize()
+               << " instead of " << size << "." << endl;
+          return EXIT_FAILURE;
+          }
+        const unsigned long numberOfPixels = viewportImage->GetBufferedRegion().GetNumberOfPixels();
+        unsigned long mismatches = 0;
+        for( unsigned long offset = 0; offset < numberOfPixels; offset++ )
+          {
+          OutputImageType::IndexType index = viewportImage->ComputeIndex( offset );
+          index[0] += start[0];
+          index[1] += start[1];
+          if( viewportImage->GetBufferPointer()[offset] != sectorImage->GetPixel( index ) )
+            {
+            mismatches++;
+            }
+          }
+        if( mismatches > 0 )
+          {
+          cerr << mismatches << " pixels of viewport " << pan << " differ from the sector." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+
+    if( mode == "ZeroCopy" )
+      {
+      // A frame in the caller's memory, stored with Theta varying fastest,
+      // is converted into the caller's output buffer without copies.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+      const InputImageType::SizeType & size = volume->GetLargestPossibleRegion().GetSize();
+      std::vector< InputPixelType > frame( volume->GetBufferedRegion().GetNumberOfPixels() );
+      InputImageType::IndexType index;
+      for( index[2] = 0; index[2] < static_cast< long >( size[2] ); index[2]++ )
+        {
+        for( index[1] = 0; index[1] < static_cast< long >( size[1] ); index[1]++ )
+          {
+          for( index[0] = 0; index[0] < static_cast< long >( size[0] ); index[0]++ )
+            {
+            frame[ ( index[2] * size[0] + index[0] ) * size[1] + index[1] ] = volume->GetPixel( index );
+            }
+          }
+        }
+
+      typedef itk::RThetaImportImageFilter< InputImageType > ImportType;
+      ImportType::Pointer import = ImportType::New();
+      import->SetImportPointer( &frame[0] );
+      import->SetSize( size );
+      ImportType::StridesType strides;
+      strides[0] = size[1];
+      strides[1] = 1;
+      strides[2] = size[0] * size[1];
+      import->SetStrides( strides );
+      import->SetSpacing( volume->GetSpacing() );
+      import->SetOrigin( volume->GetOrigin() );
+      ResampleType::Pointer sector = ResampleType::New();
+      sector->SetInput( volume );
+      sector->UpdateOutputInformation();
+      import->SetRadius( sector->GetGeometry()->GetRmin() );
+      import->SetTheta( sector->GetGeometry()->GetTransform()->GetThetaArray() );
+
+      ResampleType::Pointer imported = ResampleType::New();
+      imported->SetInput( import->GetOutput() );
+      imported->SetRDirection( import->GetRDirection() );
+      imported->SetThetaDirection( import->GetThetaDirection() );
+      imported->UpdateOutputInformation();
+      std::vector< OutputPixelType > output( imported->GetOutput()->GetLargestPossibleRegion().GetNumberOfPixels() );
+      imported->SetOutputBuffer( 0, &output[0], output.size() );
+      imported->Update();
+      sector->Update();
+      if( import->GetOutput()->GetBufferPointer() != &frame[0] ||
+          imported->GetOutput()->GetBufferPointer() != &output[0] )
+        {
+        cerr << "The imported frame or its output was copied." << endl;
+        return EXIT_FAILURE;
+        }
+      const OutputImageType * sectorImage = sector->GetOutput();
+      const OutputImageType::SizeType & outputSize = sectorImage->GetLargestPossibleRegion().GetSize();
+      OutputImageType::IndexType outputIndex;
+      OutputImageType::IndexType transposedIndex;
+      outputIndex.Fill( 0 );
+      for( outputIndex[2] = 0; outputIndex[2] < static_cast< long >( outputSize[2] ); outputIndex[2]++ )
+        {
+        for( outputIndex[1] = 0; outputIndex[1] < static_cast< long >( outputSize[1] ); outputIndex[1]++ )
+          {
+          for( outputIndex[0] = 0; outputIndex[0] < static_cast< long >( outputSize[0] ); outputIndex[0]++ )
+            {
+            transposedIndex = outputIndex;
+            transposedIndex[0] = outputIndex[1];
+            transposedIndex[1] = outputIndex[0];
+            if( vcl_abs( sectorImage->GetPixel( outputIndex ) -
+                         imported->GetOutput()->GetPixel( transposedIndex ) ) > 1 )
+              {
+              cerr << "The imported frame converts to different pixels at " << outputIndex << "." << endl;
+              return EXIT_FAILURE;
+              }
+            }
+          }
+        }
+      }
+
+    if( mode == "PersistentLookupTable" )
+      {
+      // The first filter saves its lookup table in the directory given
+      // after the mode, and a later filter maps the saved table and gives the
+      // same pixels.
+      if( argc < first + 4 )
+        {
+        cerr << "Missing the lookup table directory." << endl;
+        return EXIT_FAILURE;
+        }
+      lookupTableDirectory = argv[first + 3];
+      itksys::SystemTools::RemoveADirectory( lookupTableDirectory.c_str() );
+      if( !itksys::SystemTools::MakeDirectory( lookupTableDirectory.c_str() ) )
+        {
+        cerr << "Could not create " << lookupTableDirectory << endl;
+        return EXIT_FAILURE;
+        }
+      reader->Update();
+      ResampleType::Pointer computing = ResampleType::New();
+      computing->SetInput( reader->GetOutput() );
+      computing->UseLookupTableOn();
+      computing->SetLookupTableDirectory( lookupTableDirectory );
+      computing->Update();
+      ResampleType::Pointer mapping = ResampleType::New();
+      mapping->SetInput( reader->GetOutput() );
+      mapping->UseLookupTableOn();
+      mapping->SetLookupTableDirectory( lookupTableDirectory );
+      mapping->Update();
+      if( !mapping->GetLookupTable()->GetMemoryMapped() )
+        {
+        cerr << "The saved lookup table was not mapped." << endl;
+        return EXIT_FAILURE;
+        }
+      const unsigned long numberOfPixels = mapping->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+      for( unsigned long offset = 0; offset < numberOfPixels; offset++ )
+        {
+        if( mapping->GetOutput()->GetBufferPointer()[offset] !=
+            computing->GetOutput()->GetBufferPointer()[offset] )
+          {
+          cerr << "The mapped lookup table gives different pixels." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      // A file whose header claims fewer spans than the grid has is
+      // computed again instead of mapped.
+      const std::string fileName = lookupTableDirectory + "/" +
+        ResampleType::LookupTableType::ComputeFileName( mapping->GetLookupTable()->GetGeometryKey() );
+      LookupTableFileHeaderType header;
+      std::fstream file( fileName.c_str(), std::ios::in | std::ios::out | std::ios::binary );
+      file.read( reinterpret_cast< char * >( &header ), sizeof( header ) );
+      header.NumberOfSpans--;
+      file.seekp( 0 );
+      file.write( reinterpret_cast< const char * >( &header ), sizeof( header ) );
+      file.close();
+      if( !file )
+        {
+        cerr << "Could not modify " << fileName << endl;
+        return EXIT_FAILURE;
+        }
+      ResampleType::Pointer damaged = ResampleType::New();
+      damaged->SetInput( reader->GetOutput() );
+      damaged->UseLookupTableOn();
+      damaged->SetLookupTableDirectory( lookupTableDirectory );
+      damaged->Update();
+      if( damaged->GetLookupTable()->GetMemoryMapped() ||
+          !std::equal( damaged->GetOutput()->GetBufferPointer(),
+            damaged->GetOutput()->GetBufferPointer() + numberOfPixels,
+            computing->GetOutput()->GetBufferPointer() ) )
+        {
+        cerr << "The lookup table with missing spans was mapped." << endl;
+        return EXIT_FAILURE;
+        }
+
+      // The tables of a viewport are not saved.
+      OutputImageType::SizeType viewportSize = computing->GetOutput()->GetLargestPossibleRegion().GetSize();
+      viewportSize[0] /= 2;
+      viewportSize[1] /= 2;
+      ResampleType::Pointer viewport = ResampleType::New();
+      viewport->SetInput( reader->GetOutput() );
+      viewport->UseLookupTableOn();
+      viewport->SetLookupTableDirectory( lookupTableDirectory );
+      viewport->SetViewportOrigin( computing->GetOutput()->GetOrigin() );
+      viewport->SetViewportSpacing( computing->GetOutput()->GetSpacing() );
+      viewport->SetViewportSize( viewportSize );
+      viewport->Update();
+      if( itksys::SystemTools::FileExists( ( lookupTableDirectory + "/" +
+            ResampleType::LookupTableType::ComputeFileName( viewport->GetLookupTable()->GetGeometryKey() ) ).c_str() ) )
+        {
+        cerr << "The lookup table of a viewport was saved." << endl;
+        return EXIT_FAILURE;
+        }
+      resample->UseLookupTableOn();
+      resample->SetLookupTableDirectory( lookupTableDirectory );
+      }
+
+    if( mode == "IncrementalUpdate" )
+      {
+      // A frame whose A-lines arrive in blocks is redrawn after every block,
+      // and only the pixels of the new lines are converted.
+      reader->Update();
+      const InputImageType * volume = reader->GetOutput();
+      const InputImageType::SizeType & size = volume->GetLargestPossibleRegion().GetSize();
+      InputImageType::Pointer partial = InputImageType::New();
+      partial->CopyInformation( volume );
+      partial->SetRegions( volume->GetLargestPossibleRegion() );
+      partial->SetMetaDataDictionary( volume->GetMetaDataDictionary() );
+      partial->Allocate();
+      partial->FillBuffer( 0 );
+
+      ResampleType::Pointer incremental = ResampleType::New();
+      incremental->SetInput( partial );
+      incremental->UseIncrementalUpdateOn();
+      incremental->UseInstrumentationOn();
+      incremental->Update();
+      const unsigned long numberOfPixels = incremental->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+
+      const long blockSize = 32;
+      InputImageType::IndexType index;
+      for( long begin = 0; begin < static_cast< long >( size[1] ); begin += blockSize )
+        {
+        const long end = vnl_math_min( begin + blockSize, static_cast< long >( size[1] ) );
+        for( index[2] = 0; index[2] < static_cast< long >( size[2] ); index[2]++ )
+          {
+          for( index[1] = begin; index[1] < end; index[1]++ )
+            {
+            for( index[0] = 0; index[0] < static_cast< long >( size[0] ); index[0]++ )
+              {
+              partial->SetPixel( index, volume->GetPixel( index ) );
+              }
+            }
+          }
+        partial->Modified();
+        incremental->MarkThetaLinesModified( begin, end );
+        incremental->ResetInstrumentation();
+        incremental->Update();
+        const ResampleType::InstrumentationType & instrumentation = incremental->GetInstrumentation();
+        if( instrumentation.InSectorPixels + instrumentation.OutOfSectorPixels >= numberOfPixels )
+          {
+          cerr << "Theta lines " << begin << " to " << end << " converted the whole output." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+
+      ResampleType::Pointer whole = ResampleType::New();
+      whole->SetInput( volume );
+      whole->Update();
+      for( unsigned long offset = 0; offset < numberOfPixels; offset++ )
+        {
+        if( incremental->GetOutput()->GetBufferPointer()[offset] != whole->GetOutput()->GetBufferPointer()[offset] )
+          {
+          cerr << "The incremental updates give different pixels than a whole update." << endl;
+          return EXIT_FAILURE;
+          }
+        }
+      }
+
+    if( mode == "Instrumentation" )
+      {
+      // Two updates of a filter with a lookup table: the first computes the
+      // table and the geometry, and the second reuses them.
+      reader->Update();
+      ResampleType::GeometryType::ClearCache();
+      ResampleType::Pointer instrumented = ResampleType::New();
+      instrumented->SetInput( reader->GetOutput() );
+      instrumented->UseLookupTableOn();
+      instrumented->UseInstrumentationOn();
+      EventCounter counter;
+      typedef itk::SimpleMemberCommand< EventCounter > CommandType;
+      CommandType::Pointer command = CommandType::New();
+      command->SetCallbackFunction( &counter, &EventCounter::Count );
+      instrumented->AddObserver( itk::RThetaToCartesianInstrumentationEvent(), command );
+      instrumented->Update();
+      instrumented->Modified();
+      instrumented->Update();
+
+      const ResampleType::InstrumentationType & instrumentation = instrumented->GetInstrumentation();
+      const unsigned long numberOfPixels = instrumented->GetOutput()->GetBufferedRegion().GetNumberOfPixels();
+      unsigned long threadPixels = 0;
+      for( unsigned int thread = 0; thread < instrumentation.ThreadPixels.size(); thread++ )
+        {
+        threadPixels += instrumentation.ThreadPixels[thread];
+        }
+      if( counter.m_NumberOfEvents != 2 || instrumentation.NumberOfUpdates != 2 )
+        {
+        cerr << "Expected 2 instrumented updates, got " << instrumentation.NumberOfUpdates
+          << " and " << counter.m_NumberOfEvents << " events." << endl;
+        return EXIT_FAILURE;
+        }
+      if( instrumentation.InSectorPixels + instrumentation.OutOfSectorPixels != 2 * numberOfPixels ||
+          threadPixels != 2 * numberOfPixels ||
+          instrumentation.InSectorPixels == 0 ||
+          instrumentation.OutOfSectorPixels == 0 )
+        {
+        cerr << "The pixel counts do not add up to the output: " << instrumentation.InSectorPixels
+          << " in and " << instrumentation.OutOfSectorPixels << " out of the sector, "
+          << threadPixels << " by the threads, for " << numberOfPixels << " pixels per update." << endl;
+        return EXIT_FAILURE;
+        }
+      if( instrumentation.GeometryMisses != 1 || instrumentation.GeometryHits == 0 ||
+          instrumentation.LookupTableMisses != 1 || instrumentation.LookupTableHits != 1 ||
+          instrumentation.LookupTableFileReads != 0 )
+        {
+        cerr << "Unexpected cache counts: geometry " << instrumentation.GeometryHits << " hits, "
+          << instrumentation.GeometryMisses << " misses; lookup table " << instrumentation.LookupTableHits
+          << " hits, " << instrumentation.LookupTableMisses << " misses." << endl;
+        return EXIT_FAILURE;
+        }
+      if( instrumentation.InputBytesRead == 0 || instrumentation.LookupTableBytesRead == 0 ||
+          instrumentation.OutputInformationTime < 0.0 || instrumentation.SetupTime < 0.0 ||
+          instrumentation.ConversionTime < 0.0 )
+        {
+        cerr << "Missing byte counts or stage times." << endl;
+        return EXIT_FAILURE;
+        }
+      instrumented->ResetInstrumentation();
+      if( instrumented->GetInstrumentation().NumberOfUpdates != 0 ||
+          instrumented->GetInstrumentation().InSectorPixels != 0 )
+        {
+        cerr << "ResetInstrumentation() did not clear the measurements." << endl;
+        return EXIT_FAILURE;
+        }
+
+      // Another filter finds the geometry in the cache without parsing it.
+      ResampleType::Pointer cached = ResampleType::New();
+      cached->SetInput( reader->GetOutput() );
+      cached->UseInstrumentationOn();
+      cached->UpdateOutputInformation();
+      if( cached->GetInstrumentation().GeometryHits != 1 || cached->GetInstrumentation().GeometryMisses != 0 )
+        {
+        cerr << "The geometry cache was not hit: " << cached->GetInstrumentation().GeometryHits << " hits, "
+          << cached->GetInstrumentation().GeometryMisses << " misses." << endl;
+        return EXIT_FAILURE;
+        }
+      resample->UseInstrumentationOn();
+      }
+
     writer->SetInput( resample->GetOutput() );
     writer->SetNumberOfStreamDivisions( 20 );
     writer->Update();
+
+    // A second filter on the same input shares the scan geometry.
+    ResampleType::Pointer sharedResample = ResampleType::New();
+    sharedResample->SetInput( reader->GetOutput() );
+    sharedResample->UpdateOutputInformation();
+    if( sharedResample->GetGeometry() != resample->GetGeometry() )
+      {
+      cerr << "Filters with the same input did not share the scan geometry." << endl;
+      return EXIT_FAILURE;
+      }
+
+    // Resampling the scan converted image back onto the acquisition's grid
+    // uses the same geometry.
+    typedef itk::ResampleCartesianToRThetaImageFilter< OutputImageType, InputImageType, float > InverseResampleType;
+    InverseResampleType::Pointer inverseResample = InverseResampleType::New();
+    inverseResample->SetInput( resample->GetOutput() );
+    inverseResample->SetReferenceImage( reader->GetOutput() );
+    inverseResample->Update();
+    if( inverseResample->GetGeometry() != resample->GetGeometry() ||
+        inverseResample->GetOutput()->GetLargestPossibleRegion() != reader->GetOutput()->GetLargestPossibleRegion() )
+      {
+      cerr << "The inverse resampling does not have the acquisition's geometry." << endl;
+      return EXIT_FAILURE;
+      }
+
+    // Every (R, Theta) sample is the scan converted image interpolated
+    // linearly at the sample's Cartesian position.
+    const InputImageType * resampledBack = inverseResample->GetOutput();
+    const OutputImageType * scanConverted = resample->GetOutput();
+    typedef itk::LinearInterpolateImageFunction< OutputImageType, double > CartesianInterpolatorType;
+    CartesianInterpolatorType::Pointer cartesianInterpolator = CartesianInterpolatorType::New();
+    cartesianInterpolator->SetInputImage( scanConverted );
+    const InverseResampleType::GeometryType::InverseTransformType * inverseTransform =
+      inverseResample->GetGeometry()->GetInverseTransform();
+    const unsigned long numberOfSamples = resampledBack->GetBufferedRegion().GetNumberOfPixels();
+    unsigned long inside = 0;
+    unsigned long mismatches = 0;
+    for( unsigned long offset = 0; offset < numberOfSamples; offset += 13 )
+      {
+      const InputImageType::IndexType index = resampledBack->ComputeIndex( offset );
+      InverseResampleType::GeometryType::InverseTransformType::InputPointType point;
+      resampledBack->TransformIndexToPhysicalPoint( index, point );
+      itk::ContinuousIndex< float, Dimension > transformedIndex;
+      scanConverted->TransformPhysicalPointToContinuousIndex( inverseTransform->TransformPoint( point ), transformedIndex );
+      CartesianInterpolatorType::ContinuousIndexType cartesianIndex;
+      cartesianIndex.CastFrom( transformedIndex );
+      // Skip the samples where the single precision transform could fall on
+      // the other side of the buffer's edge.
+      bool interior = true;
+      for( unsigned int d = 0; d < Dimension; d++ )
+        {
+        const double start = scanConverted->GetBufferedRegion().GetIndex()[d];
+        const double last = start + scanConverted->GetBufferedRegion().GetSize()[d] - 1.0;
+        if( scanConverted->GetBufferedRegion().GetSize()[d] > 1 &&
+            ( cartesianIndex[d] < start + 1e-2 || cartesianIndex[d] > last - 1e-2 ) )
+          {
+          interior = false;
+          }
+        }
+      if( !interior || !cartesianInterpolator->IsInsideBuffer( cartesianIndex ) )
+        {
+        continue;
+        }
+      inside++;
+      const double expected = cartesianInterpolator->EvaluateAtContinuousIndex( cartesianIndex );
+      // The filter truncates to the pixel type and interpolates in single
+      // precision.
+      if( vcl_abs( resampledBack->GetBufferPointer()[offset] - expected ) > 1.5 )
+        {
+        mismatches++;
+        }
+      }
+    if( inside == 0 || mismatches > 0 )
+      {
+      cerr << mismatches << " of " << inside
+           << " samples of the inverse resampling differ from the interpolated scan converted image." << endl;
+      return EXIT_FAILURE;
+      }
+
+    // Moving the start of the reference's region keeps its geometry, but
+    // moves every sample.
+    InputImageType::RegionType shiftedRegion = reader->GetOutput()->GetLargestPossibleRegion();
+    InputImageType::IndexType shiftedIndex = shiftedRegion.GetIndex();
+    shiftedIndex[0] += 10;
+    shiftedIndex[1] += 2;
+    shiftedRegion.SetIndex( shiftedIndex );
+    InputImageType::Pointer shiftedReference = InputImageType::New();
+    shiftedReference->CopyInformation( reader->GetOutput() );
+    shiftedReference->SetMetaDataDictionary( reader->GetOutput()->GetMetaDataDictionary() );
+    shiftedReference->SetLargestPossibleRegion( shiftedRegion );
+    inverseResample->SetReferenceImage( shiftedReference );
+    inverseResample->Update();
+    InverseResampleType::Pointer shiftedResample = InverseResampleType::New();
+    shiftedResample->SetInput( resample->GetOutput() );
+    shiftedResample->SetReferenceImage( shiftedReference );
+    shiftedResample->Update();
+    if( inverseResample->GetOutput()->GetBufferedRegion() != shiftedResample->GetOutput()->GetBufferedRegion() ||
+        !std::equal( inverseResample->GetOutput()->GetBufferPointer(),
+          inverseResample->GetOutput()->GetBufferPointer() + numberOfSamples,
+          shiftedResample->GetOutput()->GetBufferPointer() ) )
+      {
+      cerr << "The inverse resampling did not follow the start of the reference's region." << endl;
+      return EXIT_FAILURE;
+      }
     }
   catch ( itk::ExceptionObject& e )
     {
@@ -63,5 +1409,11 @@ int itkResampleRThetaToCartesianImageFilterTest( int argc, char* argv[] )
     std::cerr << "Error: " << e.what() << std::endl;
     return EXIT_FAILURE;
     }
+
+  // The filters, which map the saved tables, have been destroyed.
+  if( !lookupTableDirectory.empty() )
+    {
+    itksys::SystemTools::RemoveADirectory( lookupTableDirectory.c_str() );
+    }
   return EXIT_SUCCESS;
 }